@@ -0,0 +1,61 @@
+/*
+ * alloc_stats.cpp - 堆分配计数实现
+ *
+ * 计数器为原子变量：WiFi/lwIP 任务在另一个核上也会 new
+ */
+
+#include "alloc_stats.h"
+#include <esp_heap_caps.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint32_t> allocs(0);
+
+uint32_t allocCount() {
+  return allocs.load(std::memory_order_relaxed);
+}
+
+HeapStats heapStats() {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  return HeapStats{ (uint32_t)info.total_free_bytes, (uint32_t)info.minimum_free_bytes,
+                    (uint32_t)info.largest_free_block, (uint32_t)info.allocated_blocks };
+}
+
+static void* countedAlloc(size_t size) {
+  allocs.fetch_add(1, std::memory_order_relaxed);
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+#if __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    abort();
+#endif
+  }
+  return p;
+}
+
+void* operator new(size_t size) {
+  return countedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+  return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  free(p);
+}
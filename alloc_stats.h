@@ -0,0 +1,27 @@
+/*
+ * alloc_stats.h - 堆分配计数
+ *
+ * 替换全局 operator new/delete，统计 C++ 对象的堆分配次数 (SNMP::Message、BER 等)；
+ * 用于确认稳态轮询路径不再分配。String 与 lwIP 直接调用 malloc/pbuf，不在统计范围内；
+ * 堆整体状况 (含 malloc) 由 heapStats() 读取，用于观察长时间运行后的碎片化
+ */
+
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <Arduino.h>
+
+// 启动以来 operator new 的调用次数
+uint32_t allocCount();
+
+// --- 堆状况 (8 位可访问内存) ---
+struct HeapStats {
+  uint32_t freeBytes;     // 当前空闲字节
+  uint32_t minFreeBytes;  // 启动以来的最低空闲字节
+  uint32_t largestBlock;  // 最大连续空闲块，远小于 freeBytes 说明已碎片化
+  uint32_t blocks;        // 当前已分配的块数 (含 malloc)，稳态下应不再增长
+};
+
+HeapStats heapStats();
+
+#endif  // ALLOC_STATS_H
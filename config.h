@@ -22,6 +22,46 @@
 #define MQTT_USER "admin"             // MQTT 用户名
 #define MQTT_PASS "admin123"          // MQTT 密码
 #define MQTT_TOPIC_OID "server/oid"   // 接收 OID 请求（广播）
+#define MQTT_BUFFER_SIZE 512          // PubSubClient 收发缓冲 (默认 256 不足，OID 请求 payload 约 280+ 字节)
+#define MQTT_CONNECT_TIMEOUT 5000     // 连接各阶段 (DNS / TCP / CONNACK) 的超时 (毫秒)
+#define MQTT_RETRY_MIN 1000           // 连接失败后的首次重试间隔 (毫秒)，之后每次失败翻倍
+#define MQTT_RETRY_MAX 60000          // 重试间隔上限 (毫秒)
+#define MQTT_DATA_CBOR 0              // 1 = 同时在 printer/{MAC}/cdata 发布紧凑 CBOR 数据 (见 README)
+#define TELEMETRY_BENCHMARK 0         // 1 = 启动时对比 JSON/CBOR 编码的字节数与耗时
+#define NTP_SERVER "pool.ntp.org"     // 采样时间戳的校时服务器
+#define METRICS_DIAG_INTERVAL 60000   // printer/{MAC}/diag 运行指标摘要的发送间隔 (毫秒)，0 = 不发送
+#define METRICS_TEXT_MAX 12288        // Web /metrics 输出缓冲 (字节，当前输出约 10.5 KB)
+
+// --- Web 页面资源 (web/ 下的文件由 tools/gen_html.py 压缩生成 html_content.h) ---
+#define WEB_ASSET_MAX_AGE "86400"     // 浏览器缓存页面的时间 (秒，字符串)，到期后以 ETag 验证，未变化时返回 304
+
+// --- Web 服务器 (非阻塞，见 http_server.h) ---
+#define HTTP_CLIENTS_MAX 2            // 同时服务的连接数 (不含 /events 推送流)，另有一个监听套接字
+#define HTTP_REQUEST_MAX 2048         // 单个请求 (请求头 + 表单) 最大字节，超过返回 413/431
+#define HTTP_BODY_MAX 1280            // 动态响应体缓冲 (字节，需不小于 STATUS_JSON_MAX)
+#define HTTP_REQUEST_TIMEOUT 5000     // 连接建立后收齐请求的时间 (毫秒)，超时关闭
+#define HTTP_SEND_TIMEOUT 10000       // 写完响应的时间 (毫秒)，超时关闭 (对端停止读取)
+#define WEB_RESTART_DELAY 500         // /save 之后延迟重启 (毫秒)，先让响应写出
+
+// --- Web 状态推送 (/events，见 web_events.h) ---
+#define STATUS_JSON_MAX 1280          // /status 与 /events 的状态 JSON 缓冲 (字节)
+#define WEB_EVENTS_MAX 2              // 同时订阅的页面数上限 (每个占一个 lwIP 套接字，预算见文件末尾 LWIP_SOCKETS_MAX)
+#define WEB_EVENTS_CHECK_MS 250       // 有订阅者时检查变化的间隔 (毫秒)
+#define WEB_EVENTS_KEEPALIVE 15000    // 无变化时发送 SSE 注释行保活的间隔 (毫秒)
+
+// --- data 合并发送 (时间窗批次) ---
+#define DATA_BATCH_WINDOW 0           // 合并窗口 (毫秒)，0 = 每次变化单独发到 .../data；建议 60000
+#define DATA_BATCH_MAX 24             // 每批最多采样数，满了立即发出
+
+// --- MQTT 断线暂存 (LittleFS 环形文件) ---
+#define OUTBOX_CAPACITY 512           // 环形文件记录数 (每条 56 字节)
+#define OUTBOX_STAGE 8                // RAM 暂存条数，满了立即写 flash
+#define OUTBOX_SAMPLE_INTERVAL 30000  // 同一打印机两次采样的最小间隔 (毫秒)
+#define OUTBOX_FLUSH_INTERVAL 60000   // RAM 暂存写入 flash 的间隔 (毫秒)
+#define OUTBOX_BATCH 4                // 回放时每条消息最多的采样数
+#define OUTBOX_PAYLOAD_MAX 448        // 回放消息最大字节 (需小于 MQTT 缓冲 512 减去主题长度)
+#define OUTBOX_ACK_TIMEOUT 5000       // 回放批次等待确认的时间，超时重发 (毫秒)
+#define OUTBOX_ACK_PERSIST 8          // 每多少次确认写一次文件头
 
 // --- NodeMCU-32S + W5500 (SPI) 以太网引脚配置 ---
 #define ETH_PHY_TYPE ETH_PHY_W5500  // 以太网 PHY 芯片类型 (W5500)
@@ -40,9 +80,73 @@
 #define NET_DEFAULT_NONE 2  // 当前无网
 
 // --- 系统参数配置 ---
-#define SNMP_INTERVAL 5000       // SNMP 查询间隔 (毫秒)
+#define SNMP_INTERVAL 5000       // SNMP 初始查询间隔 (毫秒)，多台打印机在此间隔内错开首次轮询
+#define SNMP_INTERVAL_MIN 1000   // 计数器变化 (正在打印) 时的查询间隔 (毫秒)
+#define SNMP_INTERVAL_MAX 60000  // 空闲时指数退避的上限 (毫秒)，不超过 PRINTER_WATCHDOG_TIMEOUT
+#define SNMP_IDLE_POLLS 3        // 计数器连续多少次轮询未变化后才开始退避 (之前保持当前间隔)
+#define MAX_PRINTERS 4           // 单节点监控的打印机数上限 (槽位 0 为扫描锁定的主打印机)
+#define PRINTER_WATCHDOG_TIMEOUT 60000  // 轮询无响应且距上次响应超过多久后检查 9100 端口 (毫秒)
+#if SNMP_INTERVAL_MAX > PRINTER_WATCHDOG_TIMEOUT
+#error "SNMP_INTERVAL_MAX 不能超过 PRINTER_WATCHDOG_TIMEOUT，否则空闲时失联的打印机要到下一次轮询才被发现"
+#endif
+#define SNMP_REQUEST_TIMEOUT 3000  // 单个 SNMP 请求的超时时间 (毫秒)
+#define SNMP_INFLIGHT_MAX 8      // 同时在途的 SNMP 请求数上限 (轮询 + OID 查询)
+#define OID_RESULT_QUEUE 16      // 待发送的 OID 查询结果队列长度 (2 的幂，需容纳一批遍历的 SNMP_WALK_BULK 块 + 结束块)
+#define OID_REQUEST_MAX 384      // 转交 SNMP 任务的 OID 请求 payload 最大字节
+#define OID_REQUEST_OIDS 32      // 单个 OID 查询最多的 OID 数
+#define OID_RESULT_MAX 480       // 单条 OID 查询结果最大字节 (需小于 MQTT 缓冲 512 减去主题长度)
+#define SNMP_VALUE_MAX 256       // 单个 varbind 值格式化后的最大字节 (更长的 OctetString 截断)
+#define SNMP_TRAP_DEBOUNCE 500   // 同一打印机的 trap 触发轮询的最小间隔 (毫秒)，窗口内的 trap 合并为一次补充轮询
+#define SNMP_PDU_MAX 256         // 自行编码的请求 PDU 缓冲大小
+#define SNMP_POLL_ARENA 640      // 每台打印机缓存轮询 PDU 的字节数 (按 agent 拆分成多个请求时共用)
+#define SNMP_POLL_PDU_MAX 10     // 每次轮询最多拆成的请求数
+#define SNMP_POLL_REPROBE 60     // 被排除的 OID 每隔多少个轮询周期单独复查一次
+#define SNMP_POLL_EXCLUDE_CONFIRM 3  // 同一 OID 连续出错多少次 (首次出错 + 复查) 后才写入 Preferences
+#define SNMP_WALK_MAX 2          // 同时进行的子树遍历数
+#define SNMP_WALK_BULK 10        // GetBulk 每次返回的最大行数 (max-repetitions)
+#define SNMP_WALK_RETRIES 1      // 遍历请求超时后的重试次数
+#define SNMP_WALK_MAX_VARBINDS 1000  // 单次遍历最多返回的 varbind 数，超过后截断
 #define SCAN_CONNECT_TIMEOUT 50  // 扫描连接超时时间 (毫秒)
-#define SCAN_BATCH_SIZE 10       // 每次扫描的 IP 数量批次大小
+#define SCAN_WINDOW 6            // 同时在途的非阻塞连接数 (lwIP 套接字总数 16，需给 Web/MQTT/UDP/9100 检测/OTA 留余量)
+#define SCAN_REPLY_GRACE 1000    // 全部地址探测完后等待 SNMP 响应的时间 (毫秒)
+#define SCAN_MAX_HOSTS 1022      // 单次扫描最多覆盖的主机数 (/22)，更大的网段只扫描本机所在的 /22
+#define SCAN_NEARBY_RADIUS 16    // 优先扫描上次打印机 IP 前后各多少个地址
+#define SCAN_BURST_SIZE 16       // SNMP 突发模式：每批发送的查询数
+#define SCAN_BURST_INTERVAL 10   // SNMP 突发模式：批间隔 (毫秒)
+
+// --- FreeRTOS 任务 (SNMP/扫描/轮询/看门狗独立运行，Web 与 MQTT 留在 Arduino loop 任务) ---
+#define SNMP_TASK_CORE 0         // SNMP 任务所在核心 (loop 任务在核心 1)
+#define SNMP_TASK_PRIORITY 2     // 高于 loop 任务 (1)，每次循环后让出 1 个 tick
+#define SNMP_TASK_STACK 8192     // SNMP 任务栈 (字节)，串口每分钟输出剩余量
+#define SNMP_COMMAND_QUEUE 4     // loop -> SNMP 任务的命令队列长度 (2 的幂)
+
+// --- 分阶段耗时剖析 (见 profiler.h) ---
+#define PROFILE_ENABLED 1               // 0 = 关闭，各计时点编译为空
+#define PROFILE_LOOP_BUDGET_US 20000    // loop 任务单次循环预算 (微秒)，超过时串口输出各阶段耗时
+#define PROFILE_SNMP_BUDGET_US 100000   // SNMP 任务单次循环预算 (微秒)，扫描连接与 9100 检测本身较慢
+
+// --- 模拟网段与端到端基准 (见 sim.h；只在设备上运行，需要一台能连上 MQTT broker 的开发板，不需要打印机) ---
+#define SIM_ENABLED 0              // 1 = 扫描/9100 检测/SNMP 改走模拟网段，串口每分钟输出 Sim 基准行
+#define SIM_NET "10.77.0.0"        // 模拟网段，本机为网段内最后一个可用地址
+#define SIM_PREFIX_LEN 24          // 模拟网段前缀长度 (22 即扫描上限 SCAN_MAX_HOSTS)
+#define SIM_HOST_PERCENT 30        // 存在主机的地址比例 (%)，其余地址连接超时
+#define SIM_OPEN_9100_PERCENT 10   // 主机中 9100 开放的比例 (%)，其余立即拒绝连接
+#define SIM_AGENT_PERCENT 50       // 9100 开放的主机中应答 SNMP 的 Ricoh agent 比例 (%)
+#define SIM_CONNECT_LATENCY_MS 2   // 模拟 TCP 握手/拒绝的耗时 (毫秒)
+#define SIM_AGENT_LATENCY_MS 8     // 模拟 agent 的应答延迟 (毫秒)
+#define SIM_PAGES_PER_MIN 6        // 每台模拟打印机每分钟增加的页数
+#define SIM_QUEUE 16               // 待投递的模拟响应数，满了丢弃 (等同丢包)
+
+// --- SNMP 响应语料基准 (见 snmp_bench.h) ---
+#ifndef SNMP_BENCHMARK             // 主机构建 (host/) 以 -DSNMP_BENCHMARK=1 编译语料与模糊测试
+#define SNMP_BENCHMARK 0           // 1 = 启动时回放内置语料：分发正确性、ns/varbind、每条消息的分配次数与差分模糊测试
+#endif
+#define SNMP_FUZZ_ROUNDS 5000      // 模糊测试轮数
+#define SNMP_FUZZ_SEED 1           // 模糊测试种子 (0 = 每次随机)，失败时串口输出种子与轮次以便复现
+
+// --- 扫描策略 (Web 配置，保存在 Preferences "scan_mode") ---
+#define SCAN_MODE_TCP9100 0  // 先 TCP 9100 预过滤，再 SNMP 查询序列号
+#define SCAN_MODE_SNMP 1     // 直接向网段内每个地址突发 SNMP 查询 (无 TCP 握手)
 
 // --- Ricoh 打印机 SNMP OID (对象标识符) ---
 // 这些 OID 用于从 Ricoh 打印机获取不同的数据
@@ -65,4 +169,12 @@
 // --- LED 测试 ---
 #define LED_TEST_PIN 2  // LED 测试引脚
 
+// --- lwIP 套接字预算 ---
+// 扫描窗口 6 + MQTT 1 + SNMP/trap UDP 2 + HTTP 监听 1 与连接 2 + 推送 2 + 预留 2 = 16
+#define LWIP_SOCKETS_MAX 16  // ESP32 Arduino 核心的 CONFIG_LWIP_MAX_SOCKETS
+#define SOCKETS_RESERVED 2   // 扫描期间也可能同时打开：看门狗的 9100 检测 (WiFiClient) 与 OTA 下载 (HTTPClient)
+#if SCAN_WINDOW + 1 + 2 + 1 + HTTP_CLIENTS_MAX + WEB_EVENTS_MAX + SOCKETS_RESERVED > LWIP_SOCKETS_MAX
+#error "lwIP 套接字超出预算：减小 SCAN_WINDOW / HTTP_CLIENTS_MAX / WEB_EVENTS_MAX"
+#endif
+
 #endif  // CONFIG_H
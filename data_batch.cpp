@@ -0,0 +1,148 @@
+/*
+ * data_batch.cpp - 时间窗合并发送实现
+ *
+ * payload：第一条采样完整给出，其余每条一行差分
+ *   {"serial","ts","st","cc","bc","cp","bp","tn":[...],"d":[[dt,dst,dcc,dbc,dcp,dbp,dtb,dtc,dtr,dty],...]}
+ * dt 为相对第一条采样的毫秒数，其余为相对第一条的差值；每行末尾为 0 的字段省略
+ */
+
+#include "data_batch.h"
+#include <ArduinoJson.h>
+#include "config.h"
+#include "globals.h"
+#include "mqtt.h"
+#include "snmp_trap.h"
+
+#if DATA_BATCH_WINDOW > 0  // 未启用合并时不编译 (调用处同样以此为条件)
+
+struct DataBatch {
+  uint8_t count;
+  char serial[32];  // 批次第一条采样时的序列号 (决定主题)
+  int baselineSt;  // 批次开始前已发出的 SysTotal，断线丢弃批次时退回到此值
+  unsigned long trapAt;  // 批次中最早一条由 trap 触发的采样对应的 trap 时间，0 表示无
+  TelemetrySample samples[DATA_BATCH_MAX];
+  unsigned long at[DATA_BATCH_MAX];  // 采样时间 (millis)
+};
+
+static DataBatch batches[MAX_PRINTERS];
+
+// PubSubClient 发布时缓冲要容纳：固定头 1 + 剩余长度最多 4 + 主题长度 2 + 主题 + payload
+#define MQTT_PUBLISH_OVERHEAD 7
+
+// 批次主题 (.../data/batch，由批次的序列号决定)
+static bool batchTopic(int slot, char* topic, size_t size) {
+  return mqttDataTopic(slot, batches[slot].serial, "data/batch", topic, size);
+}
+
+// 编码批次，payload 连同主题放不进 MQTT 缓冲时返回 0
+static size_t encodeBatch(int slot, const char* topic, char* buf, size_t cap) {
+  const DataBatch& b = batches[slot];
+  const TelemetrySample& base = b.samples[0];
+
+  StaticJsonDocument<1536> doc;
+  doc["serial"] = b.serial;
+  if (base.ts) doc["ts"] = base.ts;
+  doc["st"] = base.st;
+  doc["cc"] = base.colCopies;
+  doc["bc"] = base.bwCopies;
+  doc["cp"] = base.colPrints;
+  doc["bp"] = base.bwPrints;
+  JsonArray toner = doc.createNestedArray("tn");
+  for (int8_t t : base.toner) toner.add(t);
+
+  JsonArray rows = doc.createNestedArray("d");
+  for (uint8_t i = 1; i < b.count; i++) {
+    const TelemetrySample& s = b.samples[i];
+    int32_t row[10] = {
+      (int32_t)(b.at[i] - b.at[0]),
+      s.st - base.st, s.colCopies - base.colCopies, s.bwCopies - base.bwCopies,
+      s.colPrints - base.colPrints, s.bwPrints - base.bwPrints,
+      s.toner[0] - base.toner[0], s.toner[1] - base.toner[1], s.toner[2] - base.toner[2], s.toner[3] - base.toner[3],
+    };
+    int n = 10;
+    while (n > 1 && row[n - 1] == 0) n--;
+    JsonArray r = rows.createNestedArray();
+    for (int k = 0; k < n; k++) r.add(row[k]);
+  }
+
+  size_t limit = MQTT_BUFFER_SIZE - MQTT_PUBLISH_OVERHEAD - strlen(topic);
+  if (doc.overflowed() || measureJson(doc) > limit || measureJson(doc) >= cap) return 0;
+  return serializeJson(doc, buf, cap);
+}
+
+// 丢弃批次：last_sent_SysTotal 退回到批次开始前，之后的 data (或断线暂存) 重新从该值记录，计数不丢
+static void dropBatch(int slot) {
+  DataBatch& b = batches[slot];
+  if (b.count == 0) return;
+  printerPublish[slot].last_sent_SysTotal = b.baselineSt;
+  b.count = 0;
+  b.trapAt = 0;
+}
+
+// 发出批次；发送失败时保留批次，由下一次 dataBatchLoop 重试 (断线时由 dataBatchAbort 交给断线暂存)
+static bool flushBatch(int slot) {
+  DataBatch& b = batches[slot];
+  if (b.count == 0) return true;
+
+  char topic[96];
+  char payload[MQTT_BUFFER_SIZE];
+  size_t len = batchTopic(slot, topic, sizeof(topic)) ? encodeBatch(slot, topic, payload, sizeof(payload)) : 0;
+  if (len == 0) {
+    dropBatch(slot);  // 没有主题或无法编码，重试也不会成功
+    return true;
+  }
+  if (!mqttClient.publish(topic, payload)) {
+    Serial.printf("⚠️ MQTT batch [%s] not sent, keeping %u samples\n", topic, b.count);
+    return false;
+  }
+  Serial.printf("📤 MQTT Sent [%s]: %u samples, %u bytes\n", topic, b.count, (unsigned)len);
+  snmpTrapPublished(slot, b.trapAt, b.serial);
+  b.count = 0;
+  b.trapAt = 0;
+  return true;
+}
+
+void dataBatchAdd(int slot, const char* serial, const TelemetrySample& s, unsigned long trapAt) {
+  DataBatch& b = batches[slot];
+  // 序列号变化 (主打印机重新锁定了另一台)：之前的采样先发出；
+  // 批次已满且上次没发出去时也先重试。仍发不出去时丢弃旧批次，计数由退回的 last_sent_SysTotal 补上
+  if (b.count && (strcmp(b.serial, serial) != 0 || b.count == DATA_BATCH_MAX) && !flushBatch(slot)) dropBatch(slot);
+  if (b.count == 0) {
+    b.baselineSt = printerPublish[slot].last_sent_SysTotal;
+    b.trapAt = 0;
+    strlcpy(b.serial, serial, sizeof(b.serial));
+  }
+  if (b.trapAt == 0) b.trapAt = trapAt;
+  b.samples[b.count] = s;
+  b.at[b.count] = millis();
+  b.count++;
+
+  // 加入后超出消息大小：先发出之前的采样，本条作为新批次的第一条
+  char topic[96];
+  if (b.count > 1 && batchTopic(slot, topic, sizeof(topic))) {
+    char probe[MQTT_BUFFER_SIZE];
+    if (encodeBatch(slot, topic, probe, sizeof(probe)) == 0) {
+      b.count--;
+      if (!flushBatch(slot)) dropBatch(slot);
+      b.baselineSt = printerPublish[slot].last_sent_SysTotal;
+      b.samples[0] = s;
+      b.at[0] = millis();
+      b.count = 1;
+    }
+  }
+  if (b.count == DATA_BATCH_MAX) flushBatch(slot);
+}
+
+void dataBatchLoop(bool flushAll) {
+  unsigned long now = millis();
+  for (int slot = 0; slot < printerCount; slot++) {
+    DataBatch& b = batches[slot];
+    if (b.count && (flushAll || now - b.at[0] >= DATA_BATCH_WINDOW)) flushBatch(slot);
+  }
+}
+
+void dataBatchAbort() {
+  for (int slot = 0; slot < MAX_PRINTERS; slot++) dropBatch(slot);
+}
+
+#endif  // DATA_BATCH_WINDOW > 0
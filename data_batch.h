@@ -0,0 +1,24 @@
+/*
+ * data_batch.h - 计数数据的时间窗合并发送
+ *
+ * DATA_BATCH_WINDOW > 0 时，每台打印机的 data 采样先收集到批次中，
+ * 窗口到期、批次满或锁定状态变化时合并为一条消息发到 .../data/batch (相对第一条采样的差分数组)
+ */
+
+#ifndef DATA_BATCH_H
+#define DATA_BATCH_H
+
+#include <Arduino.h>
+#include "telemetry_codec.h"
+
+// 采样加入该打印机的批次（必要时先发出已满的批次），serial 与 trapAt 取自快照
+void dataBatchAdd(int slot, const char* serial, const TelemetrySample& s, unsigned long trapAt);
+
+// 发出窗口已到期的批次；flushAll 为 true 时发出全部批次（锁定状态变化时）
+void dataBatchLoop(bool flushAll);
+
+// MQTT 断线：丢弃未发出的批次，并把 last_sent_SysTotal 退回到最后一次成功发出的值，
+// 让断线暂存 (outbox) 从该值开始记录
+void dataBatchAbort();
+
+#endif  // DATA_BATCH_H
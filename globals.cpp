@@ -4,80 +4,83 @@
  * 实际定义全局变量和对象实例
  */
 
+#include <stdarg.h>
 #include "globals.h"
 #include "config.h"
 
 // --- 全局对象实例 ---
-WebServer server(80);                // Web 服务器，端口 80
-Preferences preferences;             // 非易失性存储，用于保存配置
-WiFiUDP udp;                         // UDP 套接字，用于 SNMP 通信
-SNMP::Manager snmp;                  // SNMP 管理器
-WiFiClient espClient;                // WiFi 客户端，用于 MQTT 连接
-PubSubClient mqttClient(espClient);  // MQTT 客户端
+Preferences preferences;                 // 非易失性存储，用于保存配置
+WiFiUDP udp;                             // UDP 套接字，用于 SNMP 通信
+SNMP::Manager snmp;                      // SNMP 管理器
+MqttTransport mqttTransport;             // MQTT 传输层 (由 mqtt_conn 非阻塞建立连接)
+PubSubClient mqttClient(mqttTransport);  // MQTT 客户端
 
 // --- 配置参数 (从 Preferences 读取) ---
 String cfg_ssid = "";           // WiFi SSID
 String cfg_pass = "";           // WiFi 密码
-String cfg_printer_ip = "";     // 打印机 IP 地址
 String cfg_target_serial = "";  // 目标打印机序列号 (用于精确搜索)
+int cfg_scan_mode = SCAN_MODE_TCP9100;  // 扫描策略
 
 // --- 系统状态变量 ---
-String statusMessage = "System Booting...";  // 当前状态消息
-String deviceMAC = "";                       // 设备 MAC 地址
-String deviceIP = "";                        // 本机 IP
-unsigned long lastRequestTime = 0;           // 上次 SNMP 请求时间
+char deviceMAC[18] = "";                     // 设备 MAC 地址
+char deviceIP[16] = "";                      // 本机 IP
 bool isScanning = false;                     // 是否正在扫描模式
-int scanCurrentIP = 1;                       // 当前扫描的 IP 地址 (最后一位)
 
-// --- SNMP 读取的原始数值 ---
-int val_SysTotal = 0;       // 系统总打印数 (黑白 + 彩色)
-int val_ColCopies = 0;      // 彩色复印数
-int val_BWCopies = 0;       // 黑白复印数
-int val_ColPrints = 0;      // 彩色打印数
-int val_BWPrints = 0;       // 黑白打印数
-String val_PrtSerial = "";  // 打印机序列号
+// --- 当前状态消息 ---
+static char statusMessage[64] = "System Booting...";
+static portMUX_TYPE statusLock = portMUX_INITIALIZER_UNLOCKED;
 
-int val_TonerBlack = -1;   // 黑
-int val_TonerCyan = -1;    // 青
-int val_TonerRed = -1;     // 红
-int val_TonerYellow = -1;  // 黄
+// 先在锁外格式化，临界区内只做拷贝
+void setStatusMessage(const char* fmt, ...) {
+  char buf[sizeof(statusMessage)];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  portENTER_CRITICAL(&statusLock);
+  memcpy(statusMessage, buf, sizeof(buf));
+  portEXIT_CRITICAL(&statusLock);
+}
+
+void getStatusMessage(char* out, size_t size) {
+  portENTER_CRITICAL(&statusLock);
+  strlcpy(out, statusMessage, size);
+  portEXIT_CRITICAL(&statusLock);
+}
 
-// --- 计算得出的数值 ---
-int calc_ColTotal = 0;   // 彩色总打印数 = 彩色打印 + 彩色复印
-int calc_BWTotal = 0;    // 黑白总打印数 = 黑白打印 + 黑白复印
-int calc_TotCopies = 0;  // 总复印数 = 彩色复印 + 黑白复印
-int calc_BWCopies = 0;   // 黑白复印数 (从SNMP直接读取)
-int calc_BWPrints = 0;   // 黑白打印数 (从SNMP直接读取)
+// --- 打印机槽位 ---
+PrinterState printers[MAX_PRINTERS];
+int printerCount = 1;
+PrinterPublishState printerPublish[MAX_PRINTERS];
 
 // --- MQTT 发送控制（去重，避免重复上报）---
-int last_sent_SysTotal = -1;             // 上次 data 主题发送时的 SysTotal
-bool last_sent_had_valid_toner = false;  // 上次发送时是否含有效碳粉数据
-String last_sent_lock = "";              // 上次 lock 主题发送的状态
-String pendingOidResult = "";            // SNMP 查询结果，待发往 printer/oid/{MAC}
+const char* last_sent_lock = "";         // 上次 lock 主题发送的状态
 
-// --- MQTT 主题字符串（运行时不变，连接时构建） ---
-String mqtt_topic_status = "";           // printer/{MAC}/status
-String mqtt_topic_data = "";             // printer/{MAC}/data
-String mqtt_topic_ota = "";              // server/{MAC}/ota/update
-String mqtt_topic_lock = "";             // server/{MAC}/lock
-String mqtt_topic_lock_state = "";       // printer/{MAC}/lock
-String mqtt_topic_oid_mac = "";          // server/oid/{MAC}
-String mqtt_topic_server_oid_mac = "";   // printer/oid/{MAC}
-String mqtt_topic_register = "";         // printer/{MAC}/register，设备 IP
-String mqtt_topic_register_status = "";  // server/{MAC}/register/status
+// --- MQTT 主题字符串（运行时不变，initMQTTTopics 构建） ---
+char mqtt_topic_status[MQTT_TOPIC_LEN];           // printer/{MAC}/status
+char mqtt_topic_ota[MQTT_TOPIC_LEN];              // server/{MAC}/ota/update
+char mqtt_topic_lock[MQTT_TOPIC_LEN];             // server/{MAC}/lock
+char mqtt_topic_lock_state[MQTT_TOPIC_LEN];       // printer/{MAC}/lock
+char mqtt_topic_oid_mac[MQTT_TOPIC_LEN];          // server/oid/{MAC}
+char mqtt_topic_server_oid_mac[MQTT_TOPIC_LEN];   // printer/oid/{MAC}
+char mqtt_topic_register[MQTT_TOPIC_LEN];         // printer/{MAC}/register，设备 IP
+char mqtt_topic_register_status[MQTT_TOPIC_LEN];  // server/{MAC}/register/status
+char mqtt_topic_outbox[MQTT_TOPIC_LEN];           // printer/{MAC}/outbox
+char mqtt_topic_outbox_ack[MQTT_TOPIC_LEN];       // server/{MAC}/outbox/ack
+char mqtt_topic_diag[MQTT_TOPIC_LEN];             // printer/{MAC}/diag
 
 bool isRegistered = false;  // 由 server/{MAC}/register/status 更新
 
-// --- OID 按需查询（SNMP 响应与 MQTT 请求匹配）---
-bool pendingOidRequest = false;
-String pendingOidTarget = "";
-String pendingOidRequestId = "";
-String pendingOidJson = "";
-
 // --- 打印机锁定状态 ---
-String printerLockPinState = "lock";
+const char* printerLockPinState = "lock";
 
 void setPrinterLockPin(int level) {
   digitalWrite(PRINTER_LOCK_PIN, level);
   printerLockPinState = level ? "unlock" : "lock";
 }
+
+// --- IP 格式化 (代替 IPAddress::toString，不分配堆内存) ---
+char* ipToStr(IPAddress ip, char* buf) {
+  snprintf(buf, 16, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  return buf;
+}
@@ -9,83 +9,115 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
 #include <Preferences.h>
 #include <WiFiUdp.h>
 #include <SNMP.h>
 #include <PubSubClient.h>
+#include "config.h"
+#include "mqtt_conn.h"
 
 // --- 全局对象实例 ---
-extern WebServer server;         // Web 服务器，端口 80
-extern Preferences preferences;  // 非易失性存储，用于保存配置
-extern WiFiUDP udp;              // UDP 套接字，用于 SNMP 通信
-extern SNMP::Manager snmp;       // SNMP 管理器
-extern WiFiClient espClient;     // WiFi 客户端，用于 MQTT 连接
-extern PubSubClient mqttClient;  // MQTT 客户端
+extern Preferences preferences;      // 非易失性存储，用于保存配置
+extern WiFiUDP udp;                  // UDP 套接字，用于 SNMP 通信
+extern SNMP::Manager snmp;           // SNMP 管理器
+extern MqttTransport mqttTransport;  // MQTT 传输层 (由 mqtt_conn 非阻塞建立连接)
+extern PubSubClient mqttClient;      // MQTT 客户端
 
 // --- 配置参数 (从 Preferences 读取) ---
 extern String cfg_ssid;           // WiFi SSID
 extern String cfg_pass;           // WiFi 密码
-extern String cfg_printer_ip;     // 打印机 IP 地址
 extern String cfg_target_serial;  // 目标打印机序列号 (用于精确搜索)
+extern int cfg_scan_mode;         // 扫描策略 SCAN_MODE_TCP9100 / SCAN_MODE_SNMP
 
 // --- 系统状态变量 ---
-extern String statusMessage;           // 当前状态消息
-extern String deviceMAC;               // 设备 MAC 地址
-extern String deviceIP;                // 本机 IP（网络事件中更新，以太网优先）
-extern unsigned long lastRequestTime;  // 上次 SNMP 请求时间
-extern bool isScanning;                // 是否正在扫描模式
-extern int scanCurrentIP;              // 当前扫描的 IP 地址 (最后一位)
-
-// --- SNMP 读取的原始数值 ---
-extern int val_SysTotal;      // 系统总打印数 (黑白 + 彩色)
-extern int val_ColCopies;     // 彩色复印数
-extern int val_BWCopies;      // 黑白复印数
-extern int val_ColPrints;     // 彩色打印数
-extern int val_BWPrints;      // 黑白打印数
-extern String val_PrtSerial;  // 打印机序列号
-
-// --- 碳粉余量 (%) ---
-extern int val_TonerBlack;   // 黑
-extern int val_TonerCyan;    // 青
-extern int val_TonerRed;     // 红
-extern int val_TonerYellow;  // 黄
-
-// --- 计算得出的数值 ---
-extern int calc_ColTotal;   // 彩色总打印数 = 彩色打印 + 彩色复印
-extern int calc_BWTotal;    // 黑白总打印数 = 黑白打印 + 黑白复印
-extern int calc_TotCopies;  // 总复印数 = 彩色复印 + 黑白复印
-extern int calc_BWCopies;   // 黑白复印数 (从SNMP直接读取)
-extern int calc_BWPrints;   // 黑白打印数 (从SNMP直接读取)
+extern char deviceMAC[18];             // 设备 MAC 地址
+extern char deviceIP[16];              // 本机 IP（网络事件中更新，以太网优先）
+extern bool isScanning;                // 是否正在扫描模式 (只由 SNMP 任务读写；setup 中的 startScan 早于任务启动)
+
+// --- 当前状态消息 (Web 页面显示) ---
+// SNMP 任务、网络事件与 Web 处理都会访问，只通过以下函数读写 (内部加锁)
+void setStatusMessage(const char* fmt, ...);
+void getStatusMessage(char* out, size_t size);
+
+// --- 单台打印机的状态 ---
+// 槽位 0 为扫描/序列号锁定的主打印机 (兼容原有 printer/{MAC}/data 主题)，
+// 其余槽位为 Web 页面配置的固定 IP 打印机，数据发到 printer/{MAC}/{serial}/data
+// 只由 SNMP 任务读写 (setup 中的 initPrinters 早于任务启动)；loop 任务读取 printer_snapshot.h 的
+// 数据快照与轮询状态，发布侧的去重与计时在 PrinterPublishState 中
+struct PrinterState {
+  IPAddress ip;          // 打印机 IP，0.0.0.0 表示未配置/未锁定
+  char serial[32] = "";  // 打印机序列号
+
+  // SNMP 读取的原始数值：SNMP 任务私有的工作副本，响应到一个写一个；
+  // 其他任务读取 printer_snapshot.h 中按完整轮询周期发布的快照
+  int val_SysTotal = 0;   // 系统总打印数 (黑白 + 彩色)
+  int val_ColCopies = 0;  // 彩色复印数
+  int val_BWCopies = 0;   // 黑白复印数
+  int val_ColPrints = 0;  // 彩色打印数
+  int val_BWPrints = 0;   // 黑白打印数
+
+  // 碳粉余量 (%)，-1 表示未读取
+  int val_TonerBlack = -1;   // 黑
+  int val_TonerCyan = -1;    // 青
+  int val_TonerRed = -1;     // 红
+  int val_TonerYellow = -1;  // 黄
+
+  // 轮询调度
+  unsigned long nextPollAt = 0;        // 下次轮询时间 (millis)
+  unsigned long lastRequestTime = 0;   // 上次发出轮询请求的时间
+  unsigned long lastResponseTime = 0;  // 上次收到轮询响应的时间 (看门狗使用)
+  unsigned long pollInterval = SNMP_INTERVAL;  // 当前轮询间隔，随计数器活跃度调整
+  uint32_t pollCount = 0;                      // 累计轮询次数
+  int pollSeenSysTotal = -1;                   // 上次排程时的 SysTotal，用于判断是否在打印
+  uint8_t pollIdle = 0;                        // SysTotal 连续未变化的轮询次数 (到 SNMP_IDLE_POLLS 为止)
+  uint8_t pollPending = 0;                     // 本轮询周期尚未收到响应的请求数，为 0 前不开始下一周期
+  bool pollIncomplete = false;                 // 本周期有请求未发出或超时，结束时不发布快照
+  uint32_t pollDropped = 0;                    // 因不完整而未发布的周期数
+
+  // SNMP trap/inform
+  uint32_t trapCount = 0;          // 收到的 trap/inform 数
+  unsigned long trapAt = 0;        // 最近一个尚未随快照交出的 trap 到达时间，0 表示无 (只由 SNMP 任务读写)
+  unsigned long trapPollAt = 0;    // 上次由 trap 触发轮询的时间 (去抖)
+};
+
+extern PrinterState printers[MAX_PRINTERS];  // 打印机槽位
+extern int printerCount;                     // 已使用的槽位数 (至少为 1，槽位 0 可能正在扫描)；setup 后不再改变
+
+// --- 单台打印机的发布侧状态 (只由 loop 任务读写) ---
+struct PrinterPublishState {
+  // MQTT 发送控制（仅 mqtt 在连接时更新）
+  int last_sent_SysTotal = -1;
+  bool last_sent_had_valid_toner = false;
+  unsigned long trapLatency = 0;  // 最近一次 trap 到数据发布的耗时 (毫秒)
+};
+
+extern PrinterPublishState printerPublish[MAX_PRINTERS];
 
 // --- MQTT 发送控制（仅 mqtt 在连接时更新）---
-extern int last_sent_SysTotal;
-extern bool last_sent_had_valid_toner;
-extern String last_sent_lock;
-extern String pendingOidResult;  // OID 查询结果待发送
-
-// --- MQTT 主题字符串（运行时不变，连接时构建） ---
-extern String mqtt_topic_status;           // printer/{MAC}/status
-extern String mqtt_topic_data;             // printer/{MAC}/data
-extern String mqtt_topic_ota;              // server/{MAC}/ota/update
-extern String mqtt_topic_lock;             // server/{MAC}/lock，接收 lock/unlock
-extern String mqtt_topic_lock_state;       // printer/{MAC}/lock，发送 lock/unlock
-extern String mqtt_topic_oid_mac;          // server/oid/{MAC}，接收 OID 请求
-extern String mqtt_topic_server_oid_mac;   // printer/oid/{MAC}，发送 OID 查询结果
-extern String mqtt_topic_register;         // printer/{MAC}/register，设备 IP
-extern String mqtt_topic_register_status;  // server/{MAC}/register/status，注册状态
+extern const char* last_sent_lock;
+
+// --- MQTT 主题字符串（运行时不变，initMQTTTopics 构建） ---
+#define MQTT_TOPIC_LEN 48  // 最长的 server/{MAC}/register/status 为 40 字节
+extern char mqtt_topic_status[MQTT_TOPIC_LEN];           // printer/{MAC}/status
+extern char mqtt_topic_ota[MQTT_TOPIC_LEN];              // server/{MAC}/ota/update
+extern char mqtt_topic_lock[MQTT_TOPIC_LEN];             // server/{MAC}/lock，接收 lock/unlock
+extern char mqtt_topic_lock_state[MQTT_TOPIC_LEN];       // printer/{MAC}/lock，发送 lock/unlock
+extern char mqtt_topic_oid_mac[MQTT_TOPIC_LEN];          // server/oid/{MAC}，接收 OID 请求
+extern char mqtt_topic_server_oid_mac[MQTT_TOPIC_LEN];   // printer/oid/{MAC}，发送 OID 查询结果
+extern char mqtt_topic_register[MQTT_TOPIC_LEN];         // printer/{MAC}/register，设备 IP
+extern char mqtt_topic_register_status[MQTT_TOPIC_LEN];  // server/{MAC}/register/status，注册状态
+extern char mqtt_topic_outbox[MQTT_TOPIC_LEN];           // printer/{MAC}/outbox，回放断线期间的采样
+extern char mqtt_topic_outbox_ack[MQTT_TOPIC_LEN];       // server/{MAC}/outbox/ack，服务端确认
+extern char mqtt_topic_diag[MQTT_TOPIC_LEN];             // printer/{MAC}/diag，运行指标摘要
 
 // --- 注册状态（由 register/status 消息更新）---
 extern bool isRegistered;
 
-// --- OID 按需查询状态（SNMP 响应与 MQTT 请求匹配）---
-extern bool pendingOidRequest;
-extern String pendingOidTarget;
-extern String pendingOidRequestId;
-extern String pendingOidJson;
-
 // --- 打印机锁定状态 (与引脚同步，值为 "lock"/"unlock") ---
-extern String printerLockPinState;  // 当前输出电平 HIGH/LOW，只读；修改请用 setPrinterLockPin()
-void setPrinterLockPin(int level);  // 写引脚并更新 printerLockPinState
+extern const char* printerLockPinState;  // 当前输出电平 HIGH/LOW，只读；修改请用 setPrinterLockPin()
+void setPrinterLockPin(int level);       // 写引脚并更新 printerLockPinState
+
+// 把 IP 格式化为点分十进制，buf 至少 16 字节，返回 buf
+char* ipToStr(IPAddress ip, char* buf);
 
 #endif  // GLOBALS_H
@@ -0,0 +1,110 @@
+/*
+ * host_main.cpp - 主机构建的检查入口
+ *
+ * 在 PC 上运行与硬件无关的模块：请求 PDU 的 BER 编码 (snmp_pdu)、遥测的 JSON/CBOR 编码 (telemetry_codec)，
+ * 以及 SNMP 响应语料基准 (snmp_bench：OID 表分发、值格式化与差分模糊测试)。
+ * 任一检查失败时退出码非 0；基准耗时仅供参考，实际数值以设备上的串口输出为准
+ */
+
+#include <Arduino.h>
+#include "config.h"
+#include "snmp_bench.h"
+#include "snmp_pdu.h"
+#include "telemetry_codec.h"
+
+static int failures = 0;
+
+static void expectBytes(const char* name, const uint8_t* got, size_t gotLen, const uint8_t* want, size_t wantLen) {
+  if (gotLen == wantLen && memcmp(got, want, wantLen) == 0) return;
+  Serial.printf("❌ %s: %u bytes, want %u\n   got ", name, (unsigned)gotLen, (unsigned)wantLen);
+  for (size_t i = 0; i < gotLen; i++) Serial.printf("%02x ", got[i]);
+  Serial.printf("\n   want ");
+  for (size_t i = 0; i < wantLen; i++) Serial.printf("%02x ", want[i]);
+  Serial.println();
+  failures++;
+}
+
+static void expectTrue(const char* name, bool ok) {
+  if (ok) return;
+  Serial.printf("❌ %s\n", name);
+  failures++;
+}
+
+// --- 请求 PDU 的 BER 编码 ---
+static void checkPdu() {
+  uint8_t buf[SNMP_PDU_MAX];
+  size_t idOffset = 0;
+  const char* sysDescr = "1.3.6.1.2.1.1.1.0";
+  size_t len = snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_1, "public", SNMP_PDU_GET, 0x01020304, 0, 0,
+                                 &sysDescr, 1, &idOffset);
+  static const uint8_t get[] = {
+    0x30, 0x29, 0x02, 0x01, 0x00, 0x04, 0x06, 'p', 'u', 'b', 'l', 'i', 'c',
+    0xa0, 0x1c, 0x02, 0x04, 0x01, 0x02, 0x03, 0x04, 0x02, 0x01, 0x00, 0x02, 0x01, 0x00,
+    0x30, 0x0e, 0x30, 0x0c, 0x06, 0x08, 0x2b, 0x06, 0x01, 0x02, 0x01, 0x01, 0x01, 0x00, 0x05, 0x00,
+  };
+  expectBytes("pdu get", buf, len, get, sizeof(get));
+
+  // request-id 原地改写 (轮询缓存的 PDU 每次只改这 4 字节)
+  snmpPatchRequestId(buf, idOffset, 0x7f00aa55);
+  static const uint8_t id[] = { 0x7f, 0x00, 0xaa, 0x55 };
+  expectBytes("pdu patched request-id", buf + idOffset, 4, id, sizeof(id));
+
+  // GetBulk：多字节的弧 (367 = 0x82 0x6f) 与 max-repetitions
+  const char* ricoh = "1.3.6.1.4.1.367";
+  len = snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_2C, "public", SNMP_PDU_GETBULK, 1, 0, 10, &ricoh, 1);
+  static const uint8_t bulk[] = {
+    0x30, 0x28, 0x02, 0x01, 0x01, 0x04, 0x06, 'p', 'u', 'b', 'l', 'i', 'c',
+    0xa5, 0x1b, 0x02, 0x04, 0x00, 0x00, 0x00, 0x01, 0x02, 0x01, 0x00, 0x02, 0x01, 0x0a,
+    0x30, 0x0d, 0x30, 0x0b, 0x06, 0x07, 0x2b, 0x06, 0x01, 0x04, 0x01, 0x82, 0x6f, 0x05, 0x00,
+  };
+  expectBytes("pdu getbulk", buf, len, bulk, sizeof(bulk));
+
+  const char* bad[] = { "1.3.6.x", "", "3.1", "1..2" };
+  for (const char* oid : bad) {
+    expectTrue("pdu rejects malformed oid", snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_1, "public",
+                                                              SNMP_PDU_GET, 1, 0, 0, &oid, 1) == 0);
+  }
+  expectTrue("pdu rejects short buffer", snmpEncodeRequest(buf, 16, SNMP_VERSION_1, "public", SNMP_PDU_GET, 1, 0,
+                                                           0, &sysDescr, 1) == 0);
+}
+
+// --- 遥测编码 ---
+static void checkTelemetry() {
+  TelemetrySample s = { 0, 1, 0, 0, 0, 0, { 85, -1, 0, 100 } };
+  uint8_t cbor[64];
+  size_t len = telemetryEncodeCbor(s, cbor, sizeof(cbor));
+  static const uint8_t noTs[] = {
+    0xa7, 0x00, 0x01, 0x01, 0x01, 0x02, 0x00, 0x03, 0x00, 0x04, 0x00, 0x05, 0x00,
+    0x06, 0x84, 0x18, 0x55, 0x20, 0x00, 0x18, 0x64,
+  };
+  expectBytes("cbor without ts", cbor, len, noTs, sizeof(noTs));
+
+  // 2038 年之后的时间戳仍为无符号整数
+  s.ts = 0x80000000u;
+  len = telemetryEncodeCbor(s, cbor, sizeof(cbor));
+  expectTrue("cbor ts map size", len > 0 && cbor[0] == 0xa8);
+  static const uint8_t ts[] = { 0x07, 0x1a, 0x80, 0x00, 0x00, 0x00 };
+  expectBytes("cbor ts after 2038", cbor + len - sizeof(ts), sizeof(ts), ts, sizeof(ts));
+  expectTrue("cbor short buffer", telemetryEncodeCbor(s, cbor, 8) == 0);
+
+  char json[256];
+  len = telemetryEncodeJson(s, "AA:BB:CC:DD:EE:FF", "E123", json, sizeof(json));
+  const char* want =
+    "{\"mac\":\"AA:BB:CC:DD:EE:FF\",\"st\":1,\"serial\":\"E123\",\"col_copies\":0,\"bw_copies\":0,\"col_prints\":0,"
+    "\"bw_prints\":0,\"toner_black\":85,\"toner_cyan\":-1,\"toner_red\":0,\"toner_yellow\":100}";
+  if (len != strlen(want) || strcmp(json, want) != 0) {
+    Serial.printf("❌ telemetry json: %s\n   want %s\n", json, want);
+    failures++;
+  }
+  expectTrue("telemetry json short buffer", telemetryEncodeJson(s, "AA", "E", json, 16) == 0);
+}
+
+int main() {
+  checkPdu();
+  checkTelemetry();
+  Serial.printf("Host checks: %d failures\n", failures);
+  telemetryBenchmark();
+  failures += snmpBenchmark();
+  Serial.printf("%s\n", failures ? "FAILED" : "OK");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * host_platform.cpp - 主机构建的平台函数与全局对象
+ *
+ * 时间取自 steady_clock，串口输出到 stdout；只定义被主机构建的模块引用的全局对象 (globals.cpp 不参与主机构建)
+ */
+
+#include <Arduino.h>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "globals.h"
+
+HostSerial Serial;
+WiFiUDP udp;
+
+static const auto startTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+uint32_t esp_random() {
+  static std::random_device rd;
+  return rd();
+}
+
+int HostSerial::printf(const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n;
+}
+
+char* ipToStr(IPAddress ip, char* buf) {
+  snprintf(buf, 16, "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+  return buf;
+}
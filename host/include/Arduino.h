@@ -0,0 +1,67 @@
+/*
+ * Arduino.h - 主机构建用的 Arduino 核心替身
+ *
+ * 只提供被主机构建的模块 (BER 编码、OID 表、varbind 分发、遥测编码与语料基准) 及其头文件用到的部分：
+ * 时间、串口输出、IPAddress、String 与 ESP32 的几个辅助函数
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+#if !defined(__APPLE__) && !(defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38)))
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+uint32_t esp_random();
+
+// 串口输出到 stdout
+class HostSerial {
+ public:
+  int printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  void print(const char* s) { fputs(s, stdout); }
+  void println(const char* s = "") { puts(s); }
+};
+
+extern HostSerial Serial;
+
+class IPAddress {
+ public:
+  IPAddress() : addr(0) {}
+  IPAddress(uint32_t a) : addr(a) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : addr(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+  operator uint32_t() const { return addr; }
+  uint8_t operator[](int i) const { return (addr >> (i * 8)) & 0xFF; }
+  bool operator==(const IPAddress& other) const { return addr == other.addr; }
+  bool operator!=(const IPAddress& other) const { return addr != other.addr; }
+
+ private:
+  uint32_t addr;  // 与 ESP32 核心相同：第一段在最低字节
+};
+
+class String : public std::string {
+ public:
+  using std::string::string;
+  String() = default;
+  String(const std::string& s) : std::string(s) {}
+};
+
+#endif  // HOST_ARDUINO_H
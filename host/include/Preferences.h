@@ -0,0 +1,12 @@
+/*
+ * Preferences.h - 主机构建用的 NVS 替身 (只为 globals.h 的声明能编译，没有存储)
+ */
+
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {};
+
+#endif  // HOST_PREFERENCES_H
@@ -0,0 +1,12 @@
+/*
+ * PubSubClient.h - 主机构建用的 MQTT 客户端替身 (只为 globals.h 的声明能编译)
+ */
+
+#ifndef HOST_PUBSUBCLIENT_H
+#define HOST_PUBSUBCLIENT_H
+
+#include <WiFi.h>
+
+class PubSubClient {};
+
+#endif  // HOST_PUBSUBCLIENT_H
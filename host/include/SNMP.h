@@ -0,0 +1,139 @@
+/*
+ * SNMP.h - 主机构建用的 SNMP 库替身
+ *
+ * 只实现语料基准与 varbind 分发用到的部分：各值类型的 BER 对象、VarBind/VarBindList 与
+ * 可逐项添加 varbind 的 Message (不做 BER 编解码)。与库一样，每个值与 varbind 各分配一次
+ */
+
+#ifndef HOST_SNMP_H
+#define HOST_SNMP_H
+
+#include <Arduino.h>
+#include <vector>
+
+namespace SNMP {
+
+enum class Version : uint8_t { V1 = 0, V2C = 1 };
+
+enum class Type : uint8_t {
+  Integer = 0x02,
+  OctetString = 0x04,
+  Null = 0x05,
+  ObjectIdentifier = 0x06,
+  IPAddress = 0x40,
+  Counter32 = 0x41,
+  Gauge32 = 0x42,
+  TimeTicks = 0x43,
+  Counter64 = 0x46,
+  NoSuchObject = 0x80,
+  NoSuchInstance = 0x81,
+  EndOfMIBView = 0x82,
+  GetRequest = 0xA0,
+  GetNextRequest = 0xA1,
+  GetResponse = 0xA2,
+  SetRequest = 0xA3,
+  GetBulkRequest = 0xA5,
+};
+
+class BER {
+ public:
+  explicit BER(Type type) : type(type) {}
+  virtual ~BER() = default;
+  Type getType() const { return type; }
+
+ private:
+  Type type;
+};
+
+template <Type T, typename V>
+class ValueBER : public BER {
+ public:
+  explicit ValueBER(V value) : BER(T), value(value) {}
+  V getValue() const { return value; }
+
+ private:
+  V value;
+};
+
+using IntegerBER = ValueBER<Type::Integer, int32_t>;
+using Counter32BER = ValueBER<Type::Counter32, uint32_t>;
+using Gauge32BER = ValueBER<Type::Gauge32, uint32_t>;
+using TimeTicksBER = ValueBER<Type::TimeTicks, uint32_t>;
+using Counter64BER = ValueBER<Type::Counter64, uint64_t>;
+using IPAddressBER = ValueBER<Type::IPAddress, ::IPAddress>;
+
+template <Type T>
+class StringBER : public BER {
+ public:
+  explicit StringBER(const char* value) : BER(T), value(value ? value : "") {}
+  const char* getValue() const { return value.c_str(); }
+
+ private:
+  std::string value;
+};
+
+using OctetStringBER = StringBER<Type::OctetString>;
+using ObjectIdentifierBER = StringBER<Type::ObjectIdentifier>;
+
+class NullBER : public BER {
+ public:
+  NullBER() : BER(Type::Null) {}
+};
+
+class VarBind {
+ public:
+  VarBind(const char* name, BER* value) : name(name), value(value) {}
+  ~VarBind() { delete value; }
+  VarBind(const VarBind&) = delete;
+  VarBind& operator=(const VarBind&) = delete;
+  const char* getName() const { return name.c_str(); }
+  BER* getValue() const { return value; }
+
+ private:
+  std::string name;
+  BER* value;
+};
+
+class VarBindList {
+ public:
+  ~VarBindList() {
+    for (VarBind* vb : items) delete vb;
+  }
+  unsigned int count() const { return items.size(); }
+  VarBind* operator[](unsigned int index) const { return items[index]; }
+  void add(VarBind* vb) { items.push_back(vb); }
+
+ private:
+  std::vector<VarBind*> items;
+};
+
+class Message {
+ public:
+  Message(Version version, const char* community, Type type) : version(version), type(type) {}
+  void add(const char* oid, BER* value) { list.add(new VarBind(oid, value)); }
+  VarBindList* getVarBindList() const { return const_cast<VarBindList*>(&list); }
+  Version getVersion() const { return version; }
+  Type getType() const { return type; }
+  int32_t getRequestID() const { return requestId; }
+  uint8_t getErrorStatus() const { return errorStatus; }
+  uint8_t getErrorIndex() const { return errorIndex; }
+  void setRequestID(int32_t id) { requestId = id; }
+  void setError(uint8_t status, uint8_t index) {
+    errorStatus = status;
+    errorIndex = index;
+  }
+
+ private:
+  Version version;
+  Type type;
+  int32_t requestId = 0;
+  uint8_t errorStatus = 0;
+  uint8_t errorIndex = 0;
+  VarBindList list;
+};
+
+class Manager {};
+
+}  // namespace SNMP
+
+#endif  // HOST_SNMP_H
@@ -0,0 +1,44 @@
+/*
+ * WiFi.h - 主机构建用的 WiFi/Client 替身 (只为 mqtt_conn.h 中 MqttTransport 的声明能编译)
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+
+class Client {
+ public:
+  virtual ~Client() = default;
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int connect(const char* host, uint16_t port) = 0;
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buf, size_t size) = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int read(uint8_t* buf, size_t size) = 0;
+  virtual int peek() = 0;
+  virtual void flush() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+};
+
+// 没有网络：始终未连接
+class WiFiClient : public Client {
+ public:
+  int connect(IPAddress, uint16_t) override { return 0; }
+  int connect(const char*, uint16_t) override { return 0; }
+  size_t write(uint8_t) override { return 0; }
+  size_t write(const uint8_t*, size_t) override { return 0; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int read(uint8_t*, size_t) override { return -1; }
+  int peek() override { return -1; }
+  void flush() override {}
+  void stop() override {}
+  uint8_t connected() override { return 0; }
+  operator bool() override { return false; }
+};
+
+#endif  // HOST_WIFI_H
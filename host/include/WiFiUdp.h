@@ -0,0 +1,22 @@
+/*
+ * WiFiUdp.h - 主机构建用的 UDP 替身：不发出任何数据包，只统计写入的字节
+ */
+
+#ifndef HOST_WIFIUDP_H
+#define HOST_WIFIUDP_H
+
+#include <Arduino.h>
+
+class WiFiUDP {
+ public:
+  int beginPacket(IPAddress, uint16_t) { return 1; }
+  size_t write(const uint8_t*, size_t len) {
+    written += len;
+    return len;
+  }
+  int endPacket() { return 1; }
+
+  size_t written = 0;
+};
+
+#endif  // HOST_WIFIUDP_H
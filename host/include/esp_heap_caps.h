@@ -0,0 +1,27 @@
+/*
+ * esp_heap_caps.h - 主机构建用的 ESP-IDF 堆统计替身 (alloc_stats.cpp 的 heapStats 返回全 0)
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+
+struct multi_heap_info_t {
+  size_t total_free_bytes;
+  size_t total_allocated_bytes;
+  size_t largest_free_block;
+  size_t minimum_free_bytes;
+  size_t allocated_blocks;
+  size_t free_blocks;
+  size_t total_blocks;
+};
+
+inline void heap_caps_get_info(multi_heap_info_t* info, uint32_t) {
+  *info = {};
+}
+
+#endif  // HOST_ESP_HEAP_CAPS_H
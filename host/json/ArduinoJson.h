@@ -0,0 +1,99 @@
+/*
+ * ArduinoJson.h - 主机构建在找不到 ArduinoJson 时使用的最小替身
+ *
+ * 只支持 telemetry_codec 用到的写法：平铺对象的 doc["key"] = 整数/字符串、measureJson、serializeJson，
+ * 输出与 ArduinoJson 6 的紧凑格式一致。找到真正的 ArduinoJson (见 host/CMakeLists.txt) 时不使用
+ */
+
+#ifndef HOST_ARDUINOJSON_H
+#define HOST_ARDUINOJSON_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JsonDocument {
+ public:
+  class Member {
+   public:
+    Member(JsonDocument& doc, const char* key) : doc(doc), key(key) {}
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    Member& operator=(T value) {
+      doc.set(key, std::to_string(value));
+      return *this;
+    }
+    Member& operator=(const char* value) {
+      doc.set(key, quote(value ? value : ""));
+      return *this;
+    }
+
+   private:
+    JsonDocument& doc;
+    const char* key;
+  };
+
+  Member operator[](const char* key) { return Member(*this, key); }
+  void clear() { members.clear(); }
+
+  std::string str() const {
+    std::string out = "{";
+    for (size_t i = 0; i < members.size(); i++) {
+      if (i) out += ',';
+      out += quote(members[i].first) + ':' + members[i].second;
+    }
+    return out + '}';
+  }
+
+ private:
+  static std::string quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if ((unsigned char)c < 0x20) {
+        char esc[8];
+        snprintf(esc, sizeof(esc), "\\u%04x", (unsigned char)c);
+        out += esc;
+      } else {
+        out += c;
+      }
+    }
+    return out + '"';
+  }
+
+  void set(const std::string& key, const std::string& json) {
+    for (auto& m : members) {
+      if (m.first == key) {
+        m.second = json;
+        return;
+      }
+    }
+    members.emplace_back(key, json);
+  }
+
+  std::vector<std::pair<std::string, std::string>> members;  // 键与已序列化的值，按插入顺序
+};
+
+template <size_t Capacity>
+class StaticJsonDocument : public JsonDocument {};
+
+inline size_t measureJson(const JsonDocument& doc) {
+  return doc.str().size();
+}
+
+// 与 ArduinoJson 相同：截断到 size-1 并以 NUL 结尾，返回写入的字节数
+inline size_t serializeJson(const JsonDocument& doc, char* buf, size_t size) {
+  if (size == 0) return 0;
+  std::string s = doc.str();
+  size_t n = s.size() < size - 1 ? s.size() : size - 1;
+  memcpy(buf, s.data(), n);
+  buf[n] = '\0';
+  return n;
+}
+
+#endif  // HOST_ARDUINOJSON_H
@@ -1,126 +1,204 @@
 /*
- * html_content.h - Web 配置页面 HTML 内容
- * 
- * 存储在程序存储器 (PROGMEM) 中以节省 RAM
+ * html_content.h - Web 配置页面资源 (由 tools/gen_html.py 从 web/ 生成，请勿手工修改)
+ *
+ * 各文件 gzip 压缩后存储在程序存储器 (PROGMEM) 中，以 Content-Encoding: gzip 原样发送
  */
 
 #ifndef HTML_CONTENT_H
 #define HTML_CONTENT_H
 
 #include <Arduino.h>
+#include "config.h"
 
-// --- Web 配置页面 HTML (存储在程序存储器中) ---
-const char index_html[] PROGMEM = R"rawliteral(
-  <!DOCTYPE HTML><html><head>
-    <meta charset="utf-8">
-    <title>WT32-ETH01 Printer Node</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-      body { font-family: Arial, sans-serif; text-align: center; margin: 20px; background-color: #eef2f3; }
-      .card { background: #fff; padding: 20px; margin: 15px auto; max-width: 500px; border-radius: 8px; box-shadow: 0 2px 10px rgba(0,0,0,0.1); }
-      input { width: 95%; padding: 8px; margin: 5px 0; border: 1px solid #ccc; border-radius: 4px; }
-      button { padding: 10px 20px; background: #28a745; color: white; border: none; cursor: pointer; border-radius: 4px; font-size: 16px; }
-      .btn-red { background: #dc3545; }
-      .val-box { display: flex; justify-content: space-between; border-bottom: 1px solid #eee; padding: 8px 0; }
-      .header-box { background: #444; color: #fff; font-weight: bold; padding: 8px; margin-top: 15px; border-radius: 4px; }
-      .mac-addr { font-size: 1.2em; color: #0056b3; font-weight: bold; font-family: monospace; letter-spacing: 1px; }
-      .serial-no { color: #d32f2f; font-weight: bold; }
-      .status { color: #666; font-style: italic; }
-      h2 { color: #333; }
-      label { font-weight: bold; display: block; text-align: left; margin-top: 10px; }
-      .hint { font-size: 0.8em; color: #888; }
-    </style>
-  </head><body>
-    <h2>🖨️ Printer Node Config</h2>
-    
-    <div class="card">
-      <div style="text-align:center; padding-bottom:10px; border-bottom:2px solid #eee;">
-        <div>Device MAC (WT32)</div>
-        <div id="dev_mac" class="mac-addr">Loading...</div>
-      </div>
-    </div>
-  
-    <div class="card">
-      <div class="header-box">实时监控 (Live View)</div>
-      <div class="val-box"><span>Printer Serial:</span> <b id="v_serial" class="serial-no">-</b></div>
-      <div class="val-box"><span>System Total:</span> <b id="v_st">-</b></div>
-      <div class="val-box"><span>B&W Copies:</span> <b id="v_bc">-</b></div>
-      <div class="val-box"><span>B&W Prints:</span> <b id="v_bp">-</b></div>
-      <div class="val-box"><span>Color Copies:</span> <b id="v_cc">-</b></div>
-      <div class="val-box"><span>Color Prints:</span> <b id="v_cp">-</b></div>
-      <div class="val-box"><span>碳粉 黑:</span> <b id="v_tb">-</b></div>
-      <div class="val-box"><span>碳粉 青:</span> <b id="v_tc">-</b></div>
-      <div class="val-box"><span>碳粉 红:</span> <b id="v_tr">-</b></div>
-      <div class="val-box"><span>碳粉 黄:</span> <b id="v_ty">-</b></div>
-      <p class="status" id="sys_status">Connecting...</p>
-      <p class="status" id="mqtt_status">MQTT: -</p>
-    </div>
-  
-    <div class="card">
-      <h3>⚙️ 系统设置 (Config)</h3>
-      <form action="/save" method="POST">
-        <div class="header-box">1. 网络 (WiFi)</div>
-        <label>SSID</label><input type="text" name="ssid" id="ssid">
-        <label>Password</label><input type="password" name="pass" id="pass">
-  
-        <div class="header-box">2. 打印机识别 (Printer ID)</div>
-        <label>Target Serial Number (搜索用)</label>
-        <input type="text" name="t_ser" id="t_ser" placeholder="输入机身序号以精准搜索">
-        <div class="hint">*若此栏留空，将自动锁定网段内第一台发现的打印机。</div>
-  
-        <div class="header-box">3. IP 设置 (IP Settings)</div>
-        <label>Printer IP (自动锁定)</label><input type="text" name="pip" id="pip">
-        <div id="scan_res" style="color:green; font-weight:bold;"></div>
-        
-        <br><br>
-        <button type="submit" class="btn-red">保存并重启 (Save & Reboot)</button>
-      </form>
-    </div>
-  
-  <script>
-    // 页面加载时读取配置
-    fetch('/config').then(res => res.json()).then(data => {
-      // 显示设备 MAC 地址
-      document.getElementById("dev_mac").innerText = data.mac;
-      // 填充 WiFi 配置
-      document.getElementById("ssid").value = data.ssid;
-      document.getElementById("pass").value = data.pass;
-      // 填充目标序列号
-      document.getElementById("t_ser").value = data.t_ser;
-      // 填充打印机 IP
-      document.getElementById("pip").value = data.pip;
-    });
-  
-    // 定时更新状态 (每 2 秒)
-    setInterval(function() {
-      fetch('/status').then(response => response.json()).then(data => {
-        // 更新打印机数据
-        document.getElementById("v_serial").innerHTML = data.serial ? data.serial : "(Waiting...)"; 
-        document.getElementById("v_st").innerHTML = data.st;
-        document.getElementById("v_bc").innerHTML = data.bc;
-        document.getElementById("v_bp").innerHTML = data.bp;
-        document.getElementById("v_cc").innerHTML = data.cc;
-        document.getElementById("v_cp").innerHTML = data.cp;
-        document.getElementById("v_tb").innerHTML = data.toner_black >= 0 ? data.toner_black + '%' : '-';
-        document.getElementById("v_tc").innerHTML = data.toner_cyan >= 0 ? data.toner_cyan + '%' : '-';
-        document.getElementById("v_tr").innerHTML = data.toner_red >= 0 ? data.toner_red + '%' : '-';
-        document.getElementById("v_ty").innerHTML = data.toner_yellow >= 0 ? data.toner_yellow + '%' : '-';
-        document.getElementById("sys_status").innerHTML = data.msg;
-        
-        // 更新 MQTT 状态
-        var mStatus = document.getElementById("mqtt_status");
-        mStatus.innerHTML = "MQTT: " + data.mqtt_state;
-        mStatus.style.color = (data.mqtt_state === "Connected") ? "green" : "red";
-        
-        // 如果检测到新的 IP，自动更新显示
-        if(data.detectedIP && data.detectedIP.length > 7 && document.getElementById("pip").value != data.detectedIP) {
-            document.getElementById("scan_res").innerHTML = "已锁定序号，IP: " + data.detectedIP;
-            document.getElementById("pip").value = data.detectedIP; 
-        }
-      });
-    }, 2000);
-  </script>
-  </body></html>
-  )rawliteral";
+struct WebAsset {
+  const char* path;      // URL 路径
+  const char* mime;      // Content-Type
+  const uint8_t* data;   // gzip 内容 (PROGMEM)
+  size_t len;            // gzip 字节数
+  const char* etag;      // 强 ETag (含引号)
+};
+
+// index.html: 6934 字节，压缩后 2781 字节
+const uint8_t web_index_html[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x95, 0x59, 0x7b, 0x73, 0xd3, 0x56,
+  0x16, 0xff, 0xdf, 0x9f, 0xe2, 0x56, 0x9d, 0x62, 0x7b, 0xc1, 0xb2, 0xe3, 0x10, 0x1a, 0xe2, 0x47,
+  0xa7, 0x05, 0x76, 0x9a, 0x1d, 0x1e, 0xd9, 0x75, 0x66, 0x99, 0x9d, 0x9d, 0x1d, 0x46, 0x96, 0xae,
+  0x63, 0x15, 0x59, 0xd2, 0x4a, 0xd7, 0x49, 0xbc, 0x94, 0x99, 0xc0, 0x10, 0x12, 0x1e, 0xc1, 0x85,
+  0x42, 0x78, 0x53, 0xc8, 0xc2, 0xc2, 0x96, 0xe6, 0x31, 0xb4, 0x3c, 0x9a, 0x10, 0xf8, 0x2e, 0xbb,
+  0x91, 0x64, 0xff, 0xc5, 0x7e, 0x84, 0x3d, 0xf7, 0xea, 0x61, 0xd9, 0xb1, 0xdd, 0x30, 0x19, 0x88,
+  0x74, 0xef, 0x39, 0xbf, 0xf3, 0x3e, 0xf7, 0x5c, 0x25, 0xfb, 0xc9, 0xc1, 0x63, 0x07, 0xc6, 0xff,
+  0x32, 0x76, 0x08, 0x7d, 0x3d, 0x7e, 0xe4, 0x70, 0x3e, 0x5b, 0x26, 0x15, 0x05, 0xfe, 0xc7, 0x82,
+  0x94, 0x8f, 0x64, 0x2b, 0x98, 0x08, 0x48, 0x2c, 0x0b, 0x86, 0x89, 0x49, 0x8e, 0xab, 0x92, 0x52,
+  0x62, 0x98, 0x83, 0x65, 0x22, 0x13, 0x05, 0xe7, 0x8f, 0x8f, 0x0f, 0xa6, 0x13, 0x87, 0xc6, 0xbf,
+  0x4e, 0x0d, 0xa0, 0x31, 0x43, 0x56, 0x09, 0x36, 0xd0, 0x51, 0x4d, 0xc2, 0xd9, 0xa4, 0xbb, 0xed,
+  0x71, 0xab, 0x42, 0x05, 0xe7, 0xb8, 0x49, 0x19, 0x4f, 0xe9, 0x9a, 0x41, 0x38, 0x24, 0x6a, 0x40,
+  0xa9, 0x02, 0xda, 0x94, 0x2c, 0x91, 0x72, 0x4e, 0xc2, 0x93, 0xb2, 0x88, 0x13, 0xec, 0x65, 0x0f,
+  0x92, 0x55, 0x99, 0xc8, 0x82, 0x92, 0x30, 0x45, 0x41, 0xc1, 0xb9, 0x01, 0x2a, 0xcb, 0x24, 0x35,
+  0x0a, 0x56, 0xd4, 0xa4, 0x1a, 0x3a, 0x85, 0x4a, 0xc0, 0x9d, 0x28, 0x09, 0x15, 0x59, 0xa9, 0x8d,
+  0xa0, 0x2f, 0x0d, 0xa0, 0xdd, 0x83, 0x4c, 0x41, 0x35, 0x13, 0x26, 0x36, 0xe4, 0x52, 0x06, 0x11,
+  0x3c, 0x4d, 0x12, 0x82, 0x22, 0x4f, 0xa8, 0x23, 0x48, 0xc4, 0x54, 0xa7, 0x0c, 0xaa, 0x08, 0xc6,
+  0x84, 0x0c, 0xef, 0xe9, 0x94, 0x3e, 0x9d, 0x41, 0x45, 0x41, 0x3c, 0x39, 0x61, 0x68, 0x55, 0x55,
+  0x4a, 0x88, 0x9a, 0xa2, 0x19, 0x23, 0xe8, 0x53, 0x8c, 0x4b, 0xe9, 0xd2, 0x60, 0x06, 0x9d, 0x8e,
+  0xf0, 0xa2, 0x60, 0x48, 0x20, 0xa6, 0x45, 0x04, 0xdb, 0xa5, 0x12, 0x00, 0xeb, 0x82, 0x24, 0xc9,
+  0xea, 0x84, 0x8f, 0xe2, 0x63, 0x0e, 0x0c, 0xe9, 0xd3, 0x48, 0xa8, 0x12, 0x8d, 0x2e, 0x4d, 0xbb,
+  0x66, 0x8c, 0xa0, 0xa1, 0x94, 0x2b, 0x4a, 0x33, 0x24, 0x6c, 0x24, 0x0c, 0x41, 0x92, 0xab, 0xe6,
+  0x08, 0x1a, 0x76, 0xd7, 0xa6, 0x13, 0x66, 0x59, 0x90, 0xb4, 0xa9, 0x11, 0x94, 0x42, 0x69, 0xe0,
+  0x1e, 0x00, 0x5a, 0x64, 0x4c, 0x14, 0x85, 0x58, 0x6a, 0x0f, 0xfb, 0xe1, 0x07, 0xe2, 0x54, 0x17,
+  0x59, 0xd5, 0xab, 0x04, 0xac, 0xc3, 0x0a, 0x16, 0x09, 0xe8, 0xe4, 0x61, 0xef, 0x1f, 0xfa, 0x2c,
+  0xa4, 0xcd, 0x70, 0x58, 0x19, 0xaa, 0x4b, 0xca, 0x17, 0x0b, 0xba, 0xc1, 0xab, 0xa9, 0x29, 0xb2,
+  0x84, 0x3e, 0x15, 0x45, 0x71, 0x9b, 0x3a, 0x7b, 0x29, 0xeb, 0xe9, 0x48, 0xb1, 0x4a, 0x88, 0xa6,
+  0x02, 0x7e, 0x80, 0xc9, 0x14, 0xea, 0x74, 0x16, 0xf8, 0x21, 0x3d, 0x2c, 0x7c, 0xbe, 0x77, 0x28,
+  0x83, 0x3c, 0xb7, 0x4d, 0x95, 0x65, 0x82, 0x5b, 0xd2, 0x54, 0x4d, 0x85, 0x37, 0xb1, 0x6a, 0x98,
+  0x74, 0x53, 0xd7, 0x64, 0xd7, 0xf9, 0xdd, 0x84, 0xb2, 0x20, 0x9a, 0xf2, 0x3f, 0x30, 0xc8, 0xda,
+  0xe7, 0x6a, 0xc1, 0x17, 0x89, 0x9a, 0x30, 0xf0, 0x36, 0xdf, 0x4b, 0xe2, 0xe0, 0x10, 0x95, 0x09,
+  0x14, 0x93, 0x90, 0x17, 0xe0, 0x3d, 0xa0, 0x90, 0x64, 0x53, 0x57, 0x04, 0x48, 0x80, 0x92, 0x82,
+  0x81, 0xfb, 0x9b, 0xaa, 0x49, 0xe4, 0x52, 0x2d, 0xe1, 0x65, 0xd6, 0x08, 0x32, 0x75, 0x01, 0x52,
+  0xaa, 0x88, 0xc9, 0x14, 0xc6, 0x6a, 0xa0, 0x42, 0x51, 0x03, 0x43, 0x2b, 0x6d, 0x6e, 0xc1, 0x18,
+  0xb7, 0xfb, 0x92, 0xba, 0x0f, 0x44, 0xd1, 0xec, 0x67, 0x1c, 0xd3, 0x9d, 0xfa, 0xec, 0xdd, 0xbb,
+  0x37, 0x70, 0x80, 0x9b, 0x18, 0xcc, 0x98, 0x29, 0x2c, 0x4f, 0x94, 0x41, 0x72, 0x51, 0x53, 0xa4,
+  0xee, 0xd1, 0x49, 0x10, 0x4d, 0x77, 0xd3, 0xa5, 0x57, 0x20, 0xf8, 0x8a, 0x20, 0x26, 0x80, 0xd3,
+  0xf0, 0xd3, 0xdc, 0xf3, 0x10, 0x9f, 0xc6, 0x95, 0x96, 0xcc, 0x54, 0x6a, 0x68, 0x5f, 0x71, 0xb0,
+  0xab, 0xd8, 0xb6, 0xda, 0xa8, 0x68, 0xaa, 0xc6, 0xfc, 0x90, 0x41, 0x0a, 0x26, 0x10, 0x8a, 0x04,
+  0x7d, 0x73, 0xe3, 0xeb, 0xc9, 0xa3, 0x25, 0x03, 0x3e, 0x55, 0x35, 0x10, 0xe8, 0xc3, 0x4b, 0x83,
+  0x69, 0xa8, 0x85, 0xae, 0xf0, 0x94, 0x83, 0x08, 0xa4, 0x6a, 0x86, 0xc8, 0xf7, 0xed, 0xdb, 0xe7,
+  0x87, 0x93, 0x96, 0xe9, 0x08, 0x92, 0x09, 0x14, 0x9f, 0x48, 0x89, 0xcb, 0xe9, 0x10, 0xdd, 0xe0,
+  0x20, 0x2b, 0x2f, 0x45, 0x28, 0x62, 0xc5, 0x37, 0xaf, 0x1d, 0x3d, 0x88, 0x69, 0x51, 0xd1, 0xc4,
+  0x93, 0xed, 0x85, 0xac, 0xe0, 0x12, 0xe9, 0xf0, 0x63, 0xca, 0xb3, 0xa1, 0x0c, 0x69, 0xd6, 0xee,
+  0xaf, 0x14, 0x3f, 0x1c, 0xf6, 0xd7, 0xf0, 0xf0, 0x30, 0x25, 0xcc, 0x26, 0xbd, 0x3e, 0x92, 0x4d,
+  0xb2, 0xd6, 0x96, 0xa5, 0xfd, 0x04, 0xde, 0xca, 0xe9, 0xfc, 0xff, 0x7e, 0x58, 0x7c, 0xf6, 0xe1,
+  0x4d, 0xbd, 0xad, 0x87, 0xa1, 0x03, 0x9a, 0x5a, 0x92, 0x27, 0x80, 0x38, 0x0d, 0x44, 0x92, 0x3c,
+  0x89, 0x44, 0x45, 0x30, 0xcd, 0x1c, 0x47, 0xfb, 0x03, 0xe7, 0x2d, 0x31, 0xc4, 0x1c, 0x17, 0xd2,
+  0xd4, 0xef, 0x38, 0x5e, 0x02, 0xf8, 0x29, 0x37, 0x10, 0xee, 0x06, 0xde, 0x5a, 0xba, 0x3d, 0x0b,
+  0x3d, 0xcc, 0xfc, 0x41, 0xd6, 0x0e, 0xd1, 0x91, 0x2f, 0x0f, 0xa0, 0x18, 0xed, 0xaf, 0xf1, 0x6c,
+  0x92, 0x2e, 0xbb, 0x02, 0x65, 0x29, 0xc7, 0x41, 0xbf, 0x3c, 0x01, 0x89, 0xc2, 0xf9, 0x0a, 0xf9,
+  0x49, 0xc3, 0xe5, 0x0f, 0x6b, 0x02, 0x15, 0xca, 0xf3, 0xbc, 0xcf, 0xd3, 0xfe, 0xab, 0x87, 0x15,
+  0xde, 0x52, 0x2b, 0xe5, 0xb9, 0xbc, 0xb5, 0xf2, 0xc0, 0xbe, 0xf9, 0xca, 0xb9, 0x7b, 0xd5, 0xbe,
+  0xf2, 0x14, 0xc5, 0x0e, 0xcb, 0x93, 0x18, 0xfd, 0x19, 0xfa, 0x77, 0xbc, 0x0b, 0x92, 0x57, 0x94,
+  0x5c, 0x3e, 0x0b, 0xe9, 0xa5, 0xe6, 0x7d, 0x1f, 0x16, 0x58, 0x6a, 0x8d, 0x80, 0xd7, 0xe9, 0x2a,
+  0xca, 0x16, 0x99, 0xee, 0x93, 0x27, 0xdc, 0x94, 0x0b, 0x94, 0x0f, 0x32, 0x90, 0xcb, 0x27, 0xb2,
+  0xc9, 0x62, 0xfe, 0xb7, 0x05, 0x14, 0x6a, 0x26, 0xc1, 0x15, 0x34, 0xae, 0x91, 0xae, 0xf0, 0x64,
+  0xc7, 0x40, 0x5f, 0xed, 0x3a, 0x0e, 0x41, 0xd6, 0x65, 0x6c, 0x6e, 0x87, 0x29, 0x8a, 0x1f, 0x05,
+  0xc3, 0x8c, 0xee, 0x06, 0xa3, 0xef, 0x18, 0xe6, 0x00, 0xcd, 0xd6, 0x9e, 0xfa, 0x88, 0xe2, 0x47,
+  0x02, 0xf5, 0xd2, 0x48, 0xdc, 0xb9, 0x46, 0xce, 0xd2, 0xcf, 0xce, 0x8b, 0x0b, 0xa8, 0xb9, 0x71,
+  0x75, 0x3b, 0x0c, 0x29, 0x7e, 0x34, 0xcc, 0xfd, 0x6b, 0x5d, 0x60, 0xc4, 0x8f, 0x85, 0x71, 0xd6,
+  0x97, 0xba, 0xc0, 0x18, 0x1f, 0x6f, 0xd4, 0xb9, 0x2e, 0x30, 0xb5, 0x2e, 0x30, 0x74, 0x4b, 0x23,
+  0x65, 0x6c, 0x98, 0x5c, 0xb0, 0xae, 0x07, 0xd9, 0xcb, 0xba, 0x21, 0xc7, 0x88, 0xcc, 0x9a, 0x79,
+  0xc2, 0x7b, 0x87, 0x18, 0xa8, 0x2a, 0x1c, 0xd9, 0x7e, 0x2d, 0xea, 0xbd, 0x78, 0x2a, 0x7f, 0x27,
+  0x24, 0x60, 0x3a, 0xf2, 0xc7, 0xf1, 0xf1, 0x11, 0x94, 0x70, 0xc9, 0x7b, 0x57, 0x6c, 0x79, 0x30,
+  0xff, 0x9f, 0x3b, 0xb7, 0x69, 0xbb, 0x72, 0x7e, 0xde, 0x70, 0x36, 0x7e, 0x68, 0xac, 0xbc, 0x73,
+  0x36, 0x57, 0x50, 0xcc, 0xed, 0x57, 0x50, 0xa1, 0x40, 0x10, 0xc9, 0x96, 0x34, 0xa3, 0x82, 0x04,
+  0x50, 0x41, 0x53, 0x73, 0x5c, 0xd2, 0x14, 0x26, 0x31, 0x87, 0x60, 0x18, 0x2b, 0x6b, 0x20, 0x75,
+  0xec, 0x58, 0x61, 0xbc, 0x4f, 0xed, 0x0f, 0xf0, 0xc8, 0xd9, 0xbc, 0xea, 0x6c, 0xdc, 0x83, 0xfe,
+  0x23, 0xff, 0x5e, 0x0e, 0x6a, 0x9e, 0xb5, 0xee, 0x7c, 0xa1, 0x30, 0x7a, 0x30, 0x9b, 0x74, 0x9f,
+  0xb3, 0x6c, 0x40, 0x41, 0xa4, 0xa6, 0x7b, 0x4d, 0x90, 0xf3, 0x66, 0x3d, 0xd3, 0x94, 0x25, 0xcf,
+  0x2b, 0xf4, 0x29, 0x60, 0x1e, 0x03, 0x61, 0x53, 0xd0, 0x04, 0xbb, 0x02, 0xe8, 0xde, 0xa6, 0x0f,
+  0x42, 0xdf, 0x5d, 0x10, 0xf6, 0xd4, 0x5b, 0xe1, 0x34, 0x8f, 0xec, 0x0b, 0xdf, 0x5b, 0x0b, 0x6b,
+  0xf6, 0xbd, 0xf5, 0xc6, 0xea, 0x79, 0x6b, 0xfe, 0x39, 0x8a, 0xf9, 0x6d, 0x68, 0xf4, 0x60, 0x87,
+  0xfe, 0xe3, 0x70, 0x86, 0x60, 0xe2, 0xb5, 0x27, 0x74, 0xb4, 0x5a, 0x29, 0x02, 0x55, 0xcc, 0xfe,
+  0xee, 0x9e, 0xf3, 0xcb, 0x92, 0x73, 0xfd, 0x59, 0xdc, 0x57, 0x2d, 0xd2, 0xd3, 0x38, 0x42, 0x7b,
+  0x98, 0xab, 0x98, 0xf7, 0x08, 0xc7, 0x96, 0x88, 0xcb, 0x70, 0x88, 0x61, 0x23, 0xc7, 0x35, 0xde,
+  0x7d, 0x6f, 0xcd, 0x3e, 0xa1, 0xaa, 0xac, 0x3f, 0xb7, 0xd6, 0xeb, 0x56, 0xfd, 0xf5, 0xd6, 0xc6,
+  0x13, 0xe7, 0xc5, 0x3b, 0x6b, 0xee, 0xbc, 0x2b, 0xa5, 0xd3, 0x12, 0x50, 0x94, 0xcb, 0xff, 0xae,
+  0x71, 0xe9, 0x89, 0xbd, 0xfc, 0xd8, 0x7e, 0x58, 0x77, 0x6e, 0xdc, 0x76, 0xfe, 0xbd, 0xfe, 0xe1,
+  0xed, 0x65, 0x6b, 0xed, 0x7c, 0x63, 0xee, 0x47, 0xeb, 0xe2, 0xb3, 0xe6, 0xf5, 0x33, 0xd6, 0xca,
+  0x1d, 0x88, 0x89, 0xbd, 0xf2, 0xd2, 0x3a, 0x3f, 0xeb, 0xfc, 0xf4, 0xd3, 0xd6, 0x9b, 0x19, 0xab,
+  0xbe, 0x66, 0xd5, 0xaf, 0x3a, 0x57, 0xd6, 0x9c, 0x3b, 0xe7, 0x02, 0xeb, 0xff, 0x3b, 0x73, 0xb6,
+  0x23, 0x5a, 0xa2, 0xa0, 0xa2, 0x23, 0xf4, 0x38, 0x8b, 0xd9, 0x17, 0x9e, 0xdb, 0xf5, 0xba, 0xb3,
+  0xbc, 0xe8, 0xdc, 0x78, 0x12, 0xb2, 0xd2, 0x1b, 0x2e, 0xbd, 0xb8, 0x01, 0xf9, 0x89, 0x0a, 0x90,
+  0x7b, 0xc1, 0x0b, 0x5e, 0x81, 0x50, 0xd3, 0x69, 0x32, 0x21, 0xa8, 0xa7, 0x2a, 0x50, 0xa6, 0xb8,
+  0xfc, 0xf8, 0x81, 0x31, 0xb4, 0x7f, 0x20, 0x95, 0x42, 0xcd, 0xa5, 0x73, 0x8d, 0xf7, 0x73, 0xf6,
+  0xc6, 0x63, 0xb4, 0x1b, 0x15, 0x8e, 0x1e, 0x19, 0xcb, 0x26, 0x5d, 0xda, 0x6d, 0x4c, 0x30, 0xcd,
+  0xd3, 0x7d, 0xe4, 0xfc, 0x78, 0x06, 0x74, 0xb7, 0xaf, 0x2c, 0xd9, 0x2f, 0x2f, 0x81, 0x62, 0x37,
+  0x1f, 0x22, 0x8a, 0x65, 0xd7, 0x1f, 0xd9, 0x17, 0x2e, 0xc5, 0x43, 0xdc, 0x49, 0x57, 0xb9, 0x5e,
+  0xfe, 0x72, 0xb3, 0xd4, 0x13, 0xcd, 0x80, 0xad, 0x5f, 0xdf, 0xdb, 0xd7, 0x96, 0x93, 0x1e, 0xfe,
+  0xcb, 0x33, 0xcd, 0xb9, 0x3a, 0x38, 0xb2, 0xb1, 0xfa, 0x7a, 0x6b, 0xf3, 0x3d, 0x04, 0x17, 0x05,
+  0x2a, 0xdb, 0xcf, 0x1e, 0x59, 0x6f, 0xeb, 0x21, 0x77, 0xf5, 0x48, 0xad, 0x41, 0x1e, 0x8d, 0x8e,
+  0x21, 0xbf, 0xc4, 0xe0, 0xb1, 0x00, 0x93, 0x14, 0x94, 0xb5, 0xd9, 0x91, 0x55, 0x41, 0xba, 0x8d,
+  0xa1, 0x58, 0x38, 0x68, 0xf1, 0xdf, 0x2c, 0x15, 0x5d, 0xd6, 0xbd, 0x24, 0x87, 0x87, 0x50, 0xcf,
+  0x61, 0xbe, 0x37, 0x30, 0x54, 0x80, 0x37, 0x64, 0xb8, 0xe3, 0xcc, 0x84, 0xc1, 0x06, 0xda, 0xf0,
+  0xf8, 0xc4, 0xa6, 0xa7, 0x56, 0x73, 0x72, 0xe5, 0x1d, 0xa3, 0x2d, 0xcb, 0x1f, 0x68, 0x4c, 0x14,
+  0xb3, 0x66, 0x5f, 0x6d, 0x6d, 0xde, 0x0e, 0x12, 0x05, 0x14, 0xdd, 0x41, 0xa6, 0x83, 0x4a, 0x66,
+  0xa0, 0x9c, 0xd9, 0x91, 0xe7, 0x03, 0xfb, 0xd3, 0xfc, 0xc0, 0xbe, 0x61, 0x1e, 0xa6, 0xd3, 0x81,
+  0x3d, 0xa1, 0x97, 0x74, 0xf7, 0xfc, 0x6e, 0xce, 0xdc, 0x84, 0x52, 0xb0, 0xe6, 0xcf, 0x37, 0xef,
+  0x5c, 0x87, 0x98, 0xd8, 0xf7, 0x66, 0xac, 0xc7, 0x77, 0xd0, 0x20, 0x82, 0x3c, 0xfe, 0xf0, 0xf6,
+  0xae, 0x75, 0x77, 0x1d, 0xbc, 0x05, 0x5a, 0xc1, 0xd6, 0xd6, 0x9b, 0x05, 0xab, 0x7e, 0x76, 0xeb,
+  0xcd, 0x15, 0x37, 0x63, 0x43, 0x41, 0x2a, 0x1a, 0x79, 0xfa, 0x0f, 0x1e, 0xdc, 0x1b, 0x8b, 0xab,
+  0xb1, 0x59, 0x2d, 0x56, 0x64, 0x12, 0x4c, 0x14, 0xde, 0x35, 0x82, 0xcb, 0x6f, 0xbd, 0xbf, 0x6f,
+  0x2d, 0xdf, 0xb2, 0x7e, 0x7d, 0xd5, 0x9c, 0x5b, 0xb0, 0xbe, 0x5b, 0x45, 0xb1, 0x02, 0x74, 0x41,
+  0xb4, 0x0b, 0xfd, 0x09, 0x17, 0x35, 0x8d, 0x80, 0xf9, 0x2e, 0x0a, 0xcd, 0x33, 0xda, 0x2d, 0x5b,
+  0x4d, 0xd7, 0x14, 0x0d, 0x59, 0x87, 0xac, 0x4b, 0x26, 0x51, 0xf3, 0xd1, 0xcb, 0xe6, 0xfd, 0x25,
+  0xeb, 0xe2, 0xc3, 0xc6, 0xe6, 0x26, 0x0c, 0x44, 0x8d, 0xd5, 0x0d, 0xab, 0xbe, 0xd8, 0x9c, 0x5d,
+  0x80, 0x74, 0x88, 0x94, 0x30, 0x11, 0xcb, 0xb1, 0x68, 0x52, 0x64, 0x8d, 0x37, 0x1a, 0xe7, 0xc1,
+  0xe5, 0x6a, 0x0c, 0x42, 0x86, 0x72, 0x79, 0x04, 0xbf, 0xf8, 0x6f, 0x4c, 0x4d, 0x8d, 0xc5, 0xbd,
+  0x75, 0x49, 0x80, 0x9b, 0x30, 0x6c, 0x9c, 0xa2, 0xb0, 0xf6, 0xad, 0x77, 0xce, 0xe3, 0x75, 0x48,
+  0x2b, 0xeb, 0xf1, 0x1c, 0x9b, 0xf4, 0xac, 0x7b, 0x6b, 0xd6, 0xfd, 0x99, 0x88, 0xa4, 0x89, 0xd5,
+  0x0a, 0x4c, 0x90, 0x3c, 0xb4, 0xa8, 0x43, 0x0a, 0xa6, 0x8f, 0x5f, 0xd5, 0x46, 0xa5, 0x58, 0x30,
+  0xf3, 0xc5, 0x79, 0x19, 0x4e, 0x16, 0x63, 0x1c, 0x82, 0x84, 0x72, 0x88, 0x62, 0xd2, 0x3b, 0x43,
+  0x86, 0x62, 0x5a, 0x8f, 0x9e, 0x5b, 0xb3, 0xb3, 0x88, 0xb6, 0x6c, 0xe4, 0x69, 0xd8, 0x13, 0x8e,
+  0x75, 0xe5, 0x38, 0xcf, 0xca, 0xd2, 0xc7, 0xa1, 0x6b, 0x99, 0xde, 0x2c, 0xac, 0x07, 0x77, 0xb0,
+  0xd0, 0xb5, 0x90, 0x6c, 0xe7, 0xee, 0x8a, 0xfd, 0x70, 0x8e, 0xf6, 0xbc, 0x79, 0x1a, 0xeb, 0xde,
+  0x58, 0x6e, 0xdb, 0xec, 0x00, 0x63, 0x8b, 0x21, 0xb4, 0x70, 0xae, 0xf6, 0x51, 0x0b, 0xaa, 0xa6,
+  0x53, 0x2b, 0x59, 0x0f, 0xc1, 0x6c, 0x4f, 0xfc, 0xbe, 0x60, 0x66, 0x17, 0x34, 0xb3, 0x4d, 0xab,
+  0x56, 0x17, 0xed, 0xe3, 0xdf, 0xa0, 0x71, 0x76, 0x3a, 0xd9, 0xdf, 0xc8, 0x44, 0x4e, 0xc7, 0x33,
+  0xad, 0x54, 0x70, 0x2e, 0xbe, 0xb2, 0x67, 0xce, 0xd8, 0x37, 0xd6, 0xec, 0x05, 0xe8, 0x33, 0x49,
+  0x3c, 0x09, 0x50, 0x26, 0xb2, 0xaf, 0x3c, 0x6b, 0xc2, 0xea, 0xfc, 0x22, 0x4a, 0x7a, 0xf7, 0xae,
+  0xc6, 0xe6, 0x4a, 0x63, 0x75, 0x29, 0x1e, 0x29, 0x55, 0x55, 0x76, 0xb6, 0x43, 0x9e, 0xa9, 0x50,
+  0x8d, 0x2c, 0xbb, 0xe2, 0x5e, 0x6e, 0xdd, 0xfd, 0xc5, 0x5e, 0x5c, 0x0b, 0x0c, 0x76, 0x31, 0x7b,
+  0xab, 0x1a, 0x4c, 0xe4, 0x5e, 0x6a, 0xd1, 0x4f, 0x40, 0x81, 0xb6, 0xee, 0x21, 0xf9, 0x45, 0xdb,
+  0xdb, 0x08, 0xe2, 0x62, 0xc7, 0x05, 0xd9, 0x1b, 0x6e, 0xe2, 0x5c, 0xa6, 0x2f, 0x36, 0xe9, 0x8a,
+  0x4b, 0xfa, 0x32, 0x15, 0xc5, 0x6e, 0x4c, 0x45, 0xb1, 0x3f, 0x93, 0xde, 0x95, 0x49, 0xef, 0xcb,
+  0x24, 0x76, 0x95, 0x24, 0xf6, 0x97, 0x24, 0x76, 0x95, 0x24, 0xf6, 0x97, 0x04, 0x03, 0x73, 0x17,
+  0x26, 0x68, 0x3f, 0xd8, 0x38, 0x51, 0x84, 0xb6, 0x7a, 0x12, 0xe5, 0x73, 0x28, 0xe5, 0xbb, 0x3a,
+  0xbc, 0xbe, 0x1b, 0x45, 0x3f, 0x8b, 0x82, 0xd7, 0xa3, 0x89, 0x68, 0x7f, 0x09, 0x62, 0x6f, 0x09,
+  0x62, 0x0d, 0xc6, 0x80, 0xed, 0x02, 0xd8, 0xf2, 0x8e, 0xf1, 0x8d, 0xde, 0xf8, 0xf4, 0xb3, 0xcd,
+  0x76, 0x78, 0xba, 0xba, 0x63, 0xf4, 0x5a, 0x6f, 0xf4, 0x1a, 0x56, 0x14, 0x6d, 0xaa, 0x8b, 0x00,
+  0x6f, 0x63, 0x67, 0x32, 0x42, 0xf3, 0x79, 0x17, 0x49, 0x15, 0x73, 0xc2, 0xad, 0xf2, 0xf6, 0x76,
+  0x11, 0x99, 0x14, 0x0c, 0x44, 0xbf, 0x87, 0x02, 0x1d, 0x07, 0xa9, 0x1e, 0x73, 0x7b, 0x82, 0x7f,
+  0xac, 0x7e, 0xfb, 0x2d, 0xfa, 0xeb, 0xdf, 0xe2, 0x3c, 0x1c, 0x1f, 0x87, 0x04, 0x38, 0x0b, 0xfc,
+  0xaa, 0x8c, 0xe9, 0xb4, 0x16, 0x19, 0xdb, 0xee, 0x1c, 0x8a, 0xf6, 0xb9, 0x8e, 0x44, 0x41, 0x79,
+  0x9d, 0x97, 0x75, 0x6a, 0x03, 0xa2, 0x2f, 0x31, 0xdd, 0xaf, 0x33, 0xc0, 0x8e, 0x86, 0x0b, 0x2d,
+  0x1a, 0xa7, 0x44, 0xe1, 0x5b, 0x4b, 0xdb, 0x60, 0x10, 0x8d, 0x30, 0x66, 0x4d, 0x55, 0x64, 0x15,
+  0x83, 0x9b, 0xa2, 0x6c, 0x52, 0x60, 0x6e, 0x81, 0x38, 0xb8, 0xcc, 0x9c, 0x27, 0xcf, 0x24, 0xf4,
+  0xad, 0x75, 0xd3, 0x89, 0xba, 0xdd, 0xa8, 0xa7, 0xeb, 0xbc, 0xfb, 0x4f, 0xbb, 0xdb, 0x98, 0x79,
+  0x5f, 0xb4, 0x5b, 0xd7, 0xf6, 0x09, 0xa1, 0xa3, 0xf1, 0xc6, 0xda, 0x47, 0x12, 0x6f, 0x80, 0xa2,
+  0x0a, 0x31, 0xa4, 0x11, 0xe6, 0xdf, 0xa0, 0x7f, 0x21, 0x7a, 0x1b, 0x42, 0x6e, 0x5b, 0x64, 0x41,
+  0xa8, 0x14, 0xdc, 0x0e, 0x08, 0xf1, 0xea, 0xa5, 0x66, 0xf8, 0x36, 0x05, 0xe6, 0x78, 0x1c, 0x6d,
+  0x4a, 0x73, 0xee, 0x25, 0x8b, 0x03, 0xa9, 0x6e, 0xd8, 0x7d, 0x16, 0xdc, 0xa2, 0x67, 0x6e, 0xe5,
+  0x99, 0x57, 0x81, 0x23, 0xd6, 0x41, 0x87, 0x72, 0x39, 0x80, 0xf1, 0x2e, 0x78, 0x30, 0x66, 0xc4,
+  0xc1, 0x07, 0x1c, 0xf3, 0x35, 0x47, 0x6d, 0xa0, 0x93, 0x87, 0x9b, 0x48, 0xff, 0x3a, 0x6b, 0x3f,
+  0xb8, 0x67, 0xff, 0x73, 0x06, 0x66, 0x5c, 0x6b, 0x7e, 0x0d, 0x4c, 0x82, 0x41, 0xdd, 0x1d, 0x70,
+  0xdc, 0x01, 0xd1, 0xeb, 0xd3, 0xac, 0xfd, 0x47, 0xe4, 0x92, 0x2b, 0x47, 0xc2, 0x84, 0xc1, 0xc2,
+  0x1c, 0xb9, 0x6b, 0x17, 0xea, 0x58, 0xe2, 0x15, 0xac, 0x4e, 0x90, 0x32, 0xca, 0xa3, 0xcf, 0xd9,
+  0xee, 0x4e, 0xce, 0xc4, 0x4f, 0x72, 0x9d, 0x28, 0x34, 0x35, 0xfb, 0x1f, 0x5c, 0x74, 0xea, 0x6c,
+  0x8f, 0x35, 0x67, 0xbd, 0x7e, 0xe1, 0x0e, 0xb4, 0xee, 0x8d, 0x06, 0x8c, 0x18, 0x1d, 0x0b, 0xb9,
+  0xb1, 0x85, 0x9e, 0xf9, 0xa8, 0xa3, 0x3a, 0xcc, 0x77, 0x1a, 0x7e, 0xc0, 0x6f, 0x5b, 0x6f, 0x6f,
+  0x59, 0xb3, 0xf3, 0x74, 0x58, 0x6f, 0x3f, 0x05, 0xe1, 0x9e, 0xc0, 0x4e, 0x32, 0xab, 0x7e, 0xcb,
+  0xba, 0xbc, 0x08, 0xb3, 0x98, 0x7d, 0x61, 0xc1, 0xbe, 0xfe, 0x0a, 0x5c, 0x1b, 0x87, 0xf9, 0xd1,
+  0x7e, 0x59, 0x6f, 0x3c, 0x9d, 0xb7, 0x6e, 0x3f, 0x83, 0xe1, 0xd1, 0xbe, 0xbe, 0x6a, 0x5f, 0xa6,
+  0xa7, 0x66, 0x63, 0x65, 0xa9, 0x79, 0x6b, 0xb6, 0x31, 0x33, 0x0b, 0xda, 0xdb, 0x1b, 0x8f, 0x50,
+  0x6c, 0x28, 0x35, 0x18, 0x47, 0xc0, 0xda, 0x9c, 0x99, 0xb1, 0xee, 0x3e, 0xb0, 0x57, 0xeb, 0x28,
+  0x8d, 0x9c, 0xa7, 0xd7, 0xdc, 0x43, 0xd5, 0x3f, 0x63, 0x59, 0xb6, 0xe9, 0x9a, 0xa2, 0x60, 0x1a,
+  0x7e, 0xb5, 0xaa, 0x28, 0x99, 0xd6, 0x71, 0x0b, 0x24, 0x06, 0x19, 0x83, 0x4d, 0x28, 0xca, 0x18,
+  0xf5, 0xa4, 0x5c, 0x82, 0xaa, 0x63, 0xc4, 0x71, 0x38, 0x8b, 0x49, 0xd5, 0x50, 0x33, 0x91, 0x80,
+  0xd9, 0xc4, 0x64, 0x94, 0x26, 0x3b, 0xd8, 0xdc, 0xea, 0x0d, 0x94, 0xcb, 0x1f, 0x1d, 0x5d, 0x89,
+  0xa1, 0xd1, 0x51, 0xd7, 0x54, 0x13, 0x7b, 0xf3, 0x23, 0x7b, 0x6e, 0x1f, 0x22, 0xdd, 0xd3, 0x1e,
+  0x72, 0xfb, 0xf4, 0x1e, 0x94, 0x4e, 0xa5, 0x52, 0xf4, 0x89, 0xa9, 0x30, 0x25, 0xab, 0x92, 0x36,
+  0xc5, 0x1f, 0xa2, 0x1e, 0x2b, 0x68, 0x55, 0x43, 0xc4, 0x54, 0x0c, 0xb5, 0xc4, 0x73, 0x22, 0x58,
+  0x82, 0xa7, 0x50, 0x68, 0x1f, 0xa4, 0xbb, 0x5b, 0x51, 0x00, 0x71, 0x9f, 0xa0, 0x79, 0x54, 0xb0,
+  0x69, 0x0a, 0x13, 0x34, 0x3e, 0x81, 0xbe, 0x14, 0xc9, 0x1f, 0x33, 0xfe, 0x50, 0x38, 0x76, 0x14,
+  0xa6, 0x3e, 0xc3, 0xc4, 0x31, 0xcc, 0xb3, 0x99, 0x83, 0xfe, 0x9d, 0x22, 0xc4, 0x8f, 0x0d, 0x83,
+  0x55, 0x4d, 0x9b, 0xb5, 0x54, 0x41, 0x8f, 0xc2, 0x80, 0x06, 0x51, 0x2b, 0x04, 0x75, 0x14, 0xd2,
+  0x87, 0x3f, 0x70, 0xf8, 0x58, 0xe1, 0xd0, 0xc1, 0x78, 0x87, 0x8b, 0x33, 0x08, 0x41, 0x52, 0x34,
+  0xde, 0x3f, 0xb0, 0xaf, 0x3c, 0xd9, 0x7a, 0xb3, 0x6c, 0x2f, 0x2e, 0xd3, 0xd0, 0x07, 0xd1, 0x7e,
+  0x7b, 0xc7, 0xbb, 0x6d, 0xcd, 0x2d, 0x00, 0x0d, 0xad, 0xad, 0xa5, 0xe7, 0xf6, 0xa5, 0x6b, 0xce,
+  0xc6, 0x7d, 0x20, 0x83, 0x5c, 0x00, 0x82, 0x08, 0xe8, 0x77, 0x1a, 0x61, 0x05, 0xfc, 0x7a, 0x2a,
+  0xd2, 0x01, 0x1e, 0x61, 0x9f, 0x85, 0xbd, 0x71, 0x1f, 0xfa, 0x21, 0xfd, 0x22, 0x9c, 0x4d, 0xb2,
+  0xbf, 0x7f, 0x45, 0xfe, 0x0f, 0xbd, 0x3f, 0xaf, 0x6b, 0x16, 0x1b, 0x00, 0x00,
+};
+
+const WebAsset webAssets[] = {
+  { "/", "text/html; charset=utf-8", web_index_html, sizeof(web_index_html), "\"" FIRMWARE_VERSION "-2fa5a565\"" },
+};
+const size_t webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);
 
 #endif  // HTML_CONTENT_H
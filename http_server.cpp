@@ -0,0 +1,404 @@
+/*
+ * http_server.cpp - 非阻塞 HTTP 服务器实现
+ *
+ * 每个连接一个固定槽位 (接收缓冲、响应头、响应体缓冲)，状态：
+ *   READ   逐次 recv 到接收缓冲，收齐请求头后解析，有 Content-Length 时再收齐请求体，然后调用处理函数
+ *   WRITE  逐次 send 响应头与响应体 (MSG_DONTWAIT，写不进去就留到下次循环)，写完关闭
+ * 槽位全部占用时不再 accept，新连接留在监听队列中等待。不使用堆
+ */
+
+#include <lwip/sockets.h>
+#include "http_server.h"
+#include "config.h"
+
+#define HTTP_ROUTES_MAX 12       // 路由数上限
+#define HTTP_HEAD_MAX 384        // 响应头 (状态行 + 固定头 + 处理函数追加的头)
+#define HTTP_EXTRA_MAX 224       // 处理函数追加的响应头
+#define HTTP_LISTEN_BACKLOG 4    // 槽位占满时监听队列中等待的连接数
+
+static_assert(HTTP_BODY_MAX >= STATUS_JSON_MAX, "HTTP_BODY_MAX must hold the /status JSON");
+static_assert(HTTP_HEAD_MAX >= HTTP_EXTRA_MAX + 160, "status line and fixed headers need about 160 bytes");
+
+enum ConnState : uint8_t {
+  HC_FREE,
+  HC_READ,
+  HC_WRITE,
+};
+
+struct HttpConn {
+  int fd;
+  ConnState state;
+  unsigned long since;  // 进入当前状态的时间 (超时判断)
+
+  // 接收
+  char rx[HTTP_REQUEST_MAX + 1];  // 多一个字节放请求体结尾的 NUL
+  size_t rxLen;
+  size_t headLen;  // 请求头 (含空行) 长度，0 表示尚未收齐
+  size_t need;     // 请求头 + 请求体的总长度
+  HttpRequest req;
+
+  // 响应
+  char extra[HTTP_EXTRA_MAX];
+  size_t extraLen;
+  char resHead[HTTP_HEAD_MAX];
+  size_t resHeadLen;  // 响应头长度
+  size_t resHeadSent;
+  char body[HTTP_BODY_MAX];
+  const uint8_t* out;  // 响应体 (body 或静态数据)
+  size_t outLen;
+  size_t outSent;
+  volatile bool* busy;
+  bool answered;
+  bool detached;
+};
+
+struct HttpRoute {
+  const char* path;
+  HttpMethod method;
+  HttpHandler handler;
+  const void* ctx;
+};
+
+static HttpConn conns[HTTP_CLIENTS_MAX];
+static HttpRoute routes[HTTP_ROUTES_MAX];
+static uint8_t routeCount = 0;
+static int listenFd = -1;
+static HttpServerStats stats = {};
+
+static const char* reason(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 503: return "Service Unavailable";
+    default: return "Internal Server Error";
+  }
+}
+
+static void closeConn(HttpConn& c) {
+  if (c.fd >= 0) close(c.fd);
+  if (c.busy) *c.busy = false;
+  c.fd = -1;
+  c.busy = nullptr;
+  c.state = HC_FREE;
+  stats.active--;
+}
+
+// --- HttpResponse ---
+void HttpResponse::header(const char* name, const char* value) {
+  HttpConn& c = conns[slot];
+  int n = snprintf(c.extra + c.extraLen, sizeof(c.extra) - c.extraLen, "%s: %s\r\n", name, value);
+  if (n > 0 && c.extraLen + n < sizeof(c.extra)) c.extraLen += n;
+  else c.extra[c.extraLen] = '\0';  // 放不下的头整体丢弃
+}
+
+// 生成响应头并转入 WRITE
+static void respond(HttpConn& c, int code, const char* type, const void* body, size_t len) {
+  if (c.answered || c.detached) return;
+  c.answered = true;
+  int n = snprintf(c.resHead, sizeof(c.resHead), "HTTP/1.1 %d %s\r\n", code, reason(code));
+  if (type) n += snprintf(c.resHead + n, sizeof(c.resHead) - n, "Content-Type: %s\r\n", type);
+  n += snprintf(c.resHead + n, sizeof(c.resHead) - n, "Content-Length: %u\r\nConnection: close\r\n%.*s\r\n",
+                (unsigned)len, (int)c.extraLen, c.extra);
+  c.resHeadLen = (size_t)n < sizeof(c.resHead) ? n : sizeof(c.resHead) - 1;
+  c.resHeadSent = 0;
+  c.out = (const uint8_t*)body;
+  c.outLen = len;
+  c.outSent = 0;
+  c.state = HC_WRITE;
+  c.since = millis();
+}
+
+void HttpResponse::send(int code, const char* type, const char* body) {
+  send(code, type, body, strlen(body));
+}
+
+void HttpResponse::send(int code, const char* type, const char* body, size_t len) {
+  HttpConn& c = conns[slot];
+  if (len > sizeof(c.body)) len = sizeof(c.body);
+  memcpy(c.body, body, len);
+  respond(c, code, type, c.body, len);
+}
+
+char* HttpResponse::buffer(size_t& size) {
+  size = sizeof(conns[slot].body);
+  return conns[slot].body;
+}
+
+void HttpResponse::commit(int code, const char* type, size_t len) {
+  HttpConn& c = conns[slot];
+  respond(c, code, type, c.body, len < sizeof(c.body) ? len : sizeof(c.body));
+}
+
+void HttpResponse::sendStatic(int code, const char* type, const void* body, size_t len, volatile bool* busy) {
+  HttpConn& c = conns[slot];
+  respond(c, code, type, body, len);
+  if (busy && c.answered) {
+    c.busy = busy;
+    *busy = true;
+  }
+}
+
+int HttpResponse::detach() {
+  HttpConn& c = conns[slot];
+  c.detached = true;
+  return c.fd;
+}
+
+// --- 请求解析 ---
+static bool headerIs(const char* line, const char* name, const char** value) {
+  size_t n = strlen(name);
+  if (strncasecmp(line, name, n) != 0 || line[n] != ':') return false;
+  const char* v = line + n + 1;
+  while (*v == ' ' || *v == '\t') v++;
+  *value = v;
+  return true;
+}
+
+// 请求头已收齐：原地切分请求行与各行，返回 0 或错误状态码
+static int parseHead(HttpConn& c) {
+  HttpRequest& r = c.req;
+  r.query = "";
+  r.body = "";
+  r.ifNoneMatch = "";
+  c.need = c.headLen;
+
+  char* save = nullptr;
+  c.rx[c.headLen - 2] = '\0';  // 去掉结尾的空行，之后按 \r\n 切分
+  char* line = strtok_r(c.rx, "\r\n", &save);
+  if (!line) return 400;
+  char* sp1 = strchr(line, ' ');
+  char* sp2 = sp1 ? strchr(sp1 + 1, ' ') : nullptr;
+  if (!sp1 || !sp2) return 400;
+  *sp1 = '\0';
+  *sp2 = '\0';
+  r.method = strcmp(line, "GET") == 0 ? HTTP_METHOD_GET : strcmp(line, "POST") == 0 ? HTTP_METHOD_POST : HTTP_METHOD_OTHER;
+  r.path = sp1 + 1;
+  char* q = strchr(sp1 + 1, '?');
+  if (q) {
+    *q = '\0';
+    r.query = q + 1;
+  }
+
+  while ((line = strtok_r(nullptr, "\r\n", &save))) {
+    const char* value;
+    if (headerIs(line, "Content-Length", &value)) {
+      unsigned long len = strtoul(value, nullptr, 10);
+      if (len > HTTP_REQUEST_MAX - c.headLen) return 413;
+      c.need = c.headLen + len;
+    } else if (headerIs(line, "If-None-Match", &value)) {
+      r.ifNoneMatch = value;
+    } else if (headerIs(line, "Transfer-Encoding", &value)) {
+      return 413;  // 不支持 chunked 请求体
+    }
+  }
+  return 0;
+}
+
+static void dispatch(HttpConn& c, uint8_t slot) {
+  c.rx[c.need] = '\0';
+  if (c.need > c.headLen) c.req.body = c.rx + c.headLen;
+  stats.requests++;
+
+  HttpResponse res;
+  res.slot = slot;
+  bool pathFound = false;
+  for (uint8_t i = 0; i < routeCount; i++) {
+    if (strcmp(routes[i].path, c.req.path) != 0) continue;
+    pathFound = true;
+    if (routes[i].method != c.req.method) continue;
+    c.req.ctx = routes[i].ctx;
+    routes[i].handler(c.req, res);
+    if (c.detached) {
+      c.fd = -1;  // 套接字已交给处理函数
+      closeConn(c);
+      return;
+    }
+    if (!c.answered) respond(c, 500, "text/plain", "", 0);
+    return;
+  }
+  res.send(pathFound ? 405 : 404, "text/plain", pathFound ? "Method Not Allowed" : "Not Found");
+}
+
+static void reject(HttpConn& c, int code) {
+  stats.rejected++;
+  c.extraLen = 0;
+  respond(c, code, "text/plain", "", 0);
+}
+
+// --- 连接推进 ---
+static void readStep(HttpConn& c, uint8_t slot) {
+  if (millis() - c.since > HTTP_REQUEST_TIMEOUT) {
+    stats.timeouts++;  // 包括逐字节慢速发送的客户端
+    closeConn(c);
+    return;
+  }
+  size_t room = HTTP_REQUEST_MAX - c.rxLen;
+  if (room == 0) {
+    reject(c, c.headLen ? 413 : 431);
+    return;
+  }
+  int n = recv(c.fd, c.rx + c.rxLen, room, MSG_DONTWAIT);
+  if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    closeConn(c);  // 对端关闭或出错
+    return;
+  }
+  if (n < 0) return;  // 暂无数据
+
+  size_t from = c.rxLen > 3 ? c.rxLen - 3 : 0;  // 空行可能跨两次 recv
+  c.rxLen += n;
+  if (c.headLen == 0) {
+    for (size_t i = from; i + 4 <= c.rxLen; i++) {
+      if (memcmp(c.rx + i, "\r\n\r\n", 4) == 0) {
+        c.headLen = i + 4;
+        break;
+      }
+    }
+    if (c.headLen == 0) return;
+    int err = parseHead(c);
+    if (err) {
+      reject(c, err);
+      return;
+    }
+  }
+  if (c.rxLen >= c.need) dispatch(c, slot);
+}
+
+static void writeStep(HttpConn& c) {
+  if (millis() - c.since > HTTP_SEND_TIMEOUT) {
+    stats.timeouts++;
+    closeConn(c);
+    return;
+  }
+  while (c.resHeadSent < c.resHeadLen || c.outSent < c.outLen) {
+    const uint8_t* p;
+    size_t len;
+    if (c.resHeadSent < c.resHeadLen) {
+      p = (const uint8_t*)c.resHead + c.resHeadSent;
+      len = c.resHeadLen - c.resHeadSent;
+    } else {
+      p = c.out + c.outSent;
+      len = c.outLen - c.outSent;
+    }
+    int n = send(c.fd, p, len, MSG_DONTWAIT);
+    if (n < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) closeConn(c);
+      return;  // 发送缓冲已满，下次循环继续
+    }
+    if (c.resHeadSent < c.resHeadLen) c.resHeadSent += n;
+    else c.outSent += n;
+  }
+  closeConn(c);
+}
+
+static void acceptStep() {
+  for (uint8_t i = 0; i < HTTP_CLIENTS_MAX; i++) {
+    HttpConn& c = conns[i];
+    if (c.state != HC_FREE) continue;
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return;  // 没有新连接 (EAGAIN)
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    c.fd = fd;
+    c.state = HC_READ;
+    c.since = millis();
+    c.rxLen = 0;
+    c.headLen = 0;
+    c.need = 0;
+    c.extraLen = 0;
+    c.extra[0] = '\0';
+    c.busy = nullptr;
+    c.answered = false;
+    c.detached = false;
+    stats.active++;
+    return;  // 每次循环最多接收一个
+  }
+}
+
+// --- 对外接口 ---
+bool HttpRequest::arg(const char* name, char* out, size_t size) const {
+  if (size == 0) return false;
+  size_t nameLen = strlen(name);
+  const char* sources[] = { query, body };
+  for (const char* s : sources) {
+    while (s && *s) {
+      const char* end = strchr(s, '&');
+      if (!end) end = s + strlen(s);
+      if ((size_t)(end - s) > nameLen && strncmp(s, name, nameLen) == 0 && s[nameLen] == '=') {
+        size_t n = 0;
+        for (const char* p = s + nameLen + 1; p < end && n + 1 < size; p++) {
+          char ch = *p;
+          if (ch == '+') {
+            ch = ' ';
+          } else if (ch == '%' && end - p >= 3 && isxdigit((unsigned char)p[1]) && isxdigit((unsigned char)p[2])) {
+            char hex[3] = { p[1], p[2], '\0' };
+            ch = (char)strtoul(hex, nullptr, 16);
+            p += 2;
+          }
+          out[n++] = ch;
+        }
+        out[n] = '\0';
+        return true;
+      }
+      if ((size_t)(end - s) == nameLen && strncmp(s, name, nameLen) == 0) {
+        out[0] = '\0';  // 只有名字没有值
+        return true;
+      }
+      s = *end ? end + 1 : end;
+    }
+  }
+  out[0] = '\0';
+  return false;
+}
+
+void httpOn(const char* path, HttpMethod method, HttpHandler handler, const void* ctx) {
+  if (routeCount >= HTTP_ROUTES_MAX) {
+    Serial.printf("⚠️ HTTP 路由已满，忽略 %s\n", path);
+    return;
+  }
+  routes[routeCount++] = { path, method, handler, ctx };
+}
+
+void httpServerBegin(uint16_t port) {
+  for (HttpConn& c : conns) {
+    c.fd = -1;
+    c.state = HC_FREE;
+  }
+  listenFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (listenFd < 0) {
+    Serial.println("❌ HTTP 监听套接字创建失败");
+    return;
+  }
+  int one = 1;
+  setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = INADDR_ANY;
+  if (bind(listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFd, HTTP_LISTEN_BACKLOG) < 0) {
+    Serial.println("❌ HTTP 端口监听失败");
+    close(listenFd);
+    listenFd = -1;
+    return;
+  }
+  fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+void httpServerLoop() {
+  if (listenFd < 0) return;
+  acceptStep();
+  for (uint8_t i = 0; i < HTTP_CLIENTS_MAX; i++) {
+    HttpConn& c = conns[i];
+    if (c.state == HC_READ) readStep(c, i);
+    if (c.state == HC_WRITE) writeStep(c);  // 刚生成的响应在同一次循环中开始写出
+  }
+}
+
+const HttpServerStats& httpServerStats() {
+  return stats;
+}
@@ -0,0 +1,78 @@
+/*
+ * http_server.h - 非阻塞 HTTP 服务器 (替代 WebServer)
+ *
+ * 直接使用 lwIP 非阻塞套接字，loop 任务每次调用 httpServerLoop 只对每个连接做一次 recv/send，
+ * 不等待任何一个客户端：请求行与请求头跨多次循环逐步收齐，响应跨多次循环逐步写出，
+ * 最多同时服务 HTTP_CLIENTS_MAX 个连接；/events 推送流由 detach 交给 web_events，
+ * 不占连接槽位，另按 WEB_EVENTS_MAX 计数。
+ * 请求在 HTTP_REQUEST_TIMEOUT 内未收齐、响应在 HTTP_SEND_TIMEOUT 内未写完的连接直接关闭，
+ * 停止读取的浏览器不会拖慢 MQTT 与锁机命令。
+ * 每个响应后关闭连接 (Connection: close)，不支持 chunked 请求体
+ */
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+
+enum HttpMethod : uint8_t {
+  HTTP_METHOD_GET,
+  HTTP_METHOD_POST,
+  HTTP_METHOD_OTHER,
+};
+
+struct HttpRequest {
+  HttpMethod method;
+  const char* path;         // 不含查询串
+  const char* query;        // '?' 之后的部分 (未解码)，无则为 ""
+  const char* body;         // 请求体 (未解码)，无则为 ""
+  const char* ifNoneMatch;  // If-None-Match 请求头，无则为 ""
+  const void* ctx;          // httpOn 登记的参数
+
+  // 取表单参数 (先查查询串，再查 application/x-www-form-urlencoded 请求体)，解码后写入 out；不存在时返回 false
+  bool arg(const char* name, char* out, size_t size) const;
+};
+
+// 处理函数填写响应，返回后由服务器在后续循环中写出
+struct HttpResponse {
+  // 追加一个响应头 (值被复制)
+  void header(const char* name, const char* value);
+
+  // 响应体复制到连接自己的缓冲 (最多 HTTP_BODY_MAX 字节)
+  void send(int code, const char* type, const char* body);
+  void send(int code, const char* type, const char* body, size_t len);
+
+  // 直接在连接缓冲中生成响应体，再以 commit 发出 (省去一次复制)
+  char* buffer(size_t& size);
+  void commit(int code, const char* type, size_t len);
+
+  // 响应体不复制 (PROGMEM 或静态缓冲)。busy 非空时在写出期间置 true，写完或连接关闭后清零，
+  // 处理函数据此判断共用的静态缓冲能否重新生成
+  void sendStatic(int code, const char* type, const void* body, size_t len, volatile bool* busy = nullptr);
+
+  // 接管连接 (如 /events 推送流)：返回非阻塞套接字，服务器不再读写、也不关闭它
+  int detach();
+
+  uint8_t slot;  // 内部使用
+};
+
+typedef void (*HttpHandler)(const HttpRequest& req, HttpResponse& res);
+
+// 登记路由 (路径完全匹配)；ctx 原样放入 HttpRequest::ctx，便于多个路由共用一个处理函数
+void httpOn(const char* path, HttpMethod method, HttpHandler handler, const void* ctx = nullptr);
+
+// 开始监听 (路由登记完成后调用)
+void httpServerBegin(uint16_t port);
+
+// loop 任务：接收新连接，推进各连接的读取与写出
+void httpServerLoop();
+
+struct HttpServerStats {
+  uint32_t requests;  // 已处理的请求数 (含 4xx/5xx)
+  uint32_t timeouts;  // 读取或写出超时而关闭的连接数
+  uint32_t rejected;  // 请求格式错误或过大的请求数
+  uint8_t active;     // 当前由服务器读写的连接数 (不含已接管的推送流)
+};
+const HttpServerStats& httpServerStats();
+
+#endif  // HTTP_SERVER_H
@@ -20,7 +20,7 @@ enum LedState {
 static LedState getLedState() {
   if (!mqttClient.connected()) return LED_SINGLE_BLINK;
   if (!isRegistered) return LED_OFF;
-  return printerLockPinState == "lock" ? LED_DOUBLE_BLINK : LED_ON;
+  return strcmp(printerLockPinState, "lock") == 0 ? LED_DOUBLE_BLINK : LED_ON;
 }
 
 void ledIndicatorLoop() {
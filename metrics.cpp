@@ -0,0 +1,287 @@
+/*
+ * metrics.cpp - 节点运行指标实现
+ *
+ * 直方图的桶上限固定 (见下方 histDefs)，各桶独立计数，输出 /metrics 时再累加成 Prometheus 的累计桶。
+ * 所有直方图共用一把自旋锁：observe 只做几次加法，SNMP 任务与 loop 任务之间几乎没有竞争
+ */
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdarg.h>
+#include <atomic>
+#include <ArduinoJson.h>
+#include "metrics.h"
+#include "config.h"
+#include "globals.h"
+#include "alloc_stats.h"
+#include "mqtt_conn.h"
+#include "snmp_inflight.h"
+#include "snmp_task.h"
+#include "profiler.h"
+#include "snmp_pdu.h"
+#include "web_events.h"
+#include "http_server.h"
+
+#define HIST_MAX_BUCKETS 12  // 含 +Inf 桶
+
+struct HistDef {
+  const char* name;
+  const char* help;
+  const uint32_t* bounds;  // 各桶上限 (含)，升序
+  uint8_t count;           // 上限个数，另有一个 +Inf 桶
+};
+
+struct HistData {
+  uint32_t buckets[HIST_MAX_BUCKETS];
+  uint32_t count;
+  uint64_t sum;
+  uint32_t max;
+};
+
+static const uint32_t rttBounds[] = { 5, 10, 25, 50, 100, 250, 500, 1000, 2500 };
+static const uint32_t loopBounds[] = { 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000 };
+static const uint32_t connectBounds[] = { 50, 100, 250, 500, 1000, 2500, 5000 };
+static const uint32_t publishBounds[] = { 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 60000 };
+
+#define BOUNDS(a) a, sizeof(a) / sizeof(a[0])
+
+// 顺序与 MetricHist 一致
+static const HistDef histDefs[HIST_COUNT] = {
+  { "snmp_rtt_ms", "SNMP request round trip time (ms)", BOUNDS(rttBounds) },
+  { "loop_us", "Arduino loop task iteration time (us)", BOUNDS(loopBounds) },
+  { "snmp_loop_us", "SNMP task iteration time (us)", BOUNDS(loopBounds) },
+  { "mqtt_connect_ms", "MQTT connect time from attempt start to CONNACK (ms)", BOUNDS(connectBounds) },
+  { "poll_publish_ms", "Time from sending a poll to handing its changed data to MQTT (ms)", BOUNDS(publishBounds) },
+};
+
+static HistData hists[HIST_COUNT];
+static portMUX_TYPE histLock = portMUX_INITIALIZER_UNLOCKED;
+static std::atomic<uint32_t> counters[CNT_COUNT];
+static std::atomic<uint32_t> lastScanMs{ 0 };
+
+void metricsObserve(MetricHist hist, uint32_t value) {
+  const HistDef& def = histDefs[hist];
+  uint8_t i = 0;
+  while (i < def.count && value > def.bounds[i]) i++;
+
+  portENTER_CRITICAL(&histLock);
+  HistData& h = hists[hist];
+  h.buckets[i]++;
+  h.count++;
+  h.sum += value;
+  if (value > h.max) h.max = value;
+  portEXIT_CRITICAL(&histLock);
+}
+
+void metricsCount(MetricCounter counter) {
+  counters[counter].fetch_add(1, std::memory_order_relaxed);
+}
+
+void metricsScanDone(unsigned long durationMs) {
+  lastScanMs.store(durationMs, std::memory_order_relaxed);
+  metricsCount(CNT_SCANS);
+}
+
+static void snapshot(MetricHist hist, HistData& out) {
+  portENTER_CRITICAL(&histLock);
+  out = hists[hist];
+  portEXIT_CRITICAL(&histLock);
+}
+
+static uint32_t counter(MetricCounter c) {
+  return counters[c].load(std::memory_order_relaxed);
+}
+
+// 分位数：取 cur - prev 增量中第 q 分位所在桶的上限，落在 +Inf 桶时取历史最大值
+static uint32_t quantile(MetricHist hist, const HistData& cur, const HistData& prev, float q) {
+  const HistDef& def = histDefs[hist];
+  uint32_t total = cur.count - prev.count;
+  if (total == 0) return 0;
+  uint32_t rank = (uint32_t)(total * q);
+  if (rank < 1) rank = 1;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < def.count; i++) {
+    seen += cur.buckets[i] - prev.buckets[i];
+    if (seen >= rank) return def.bounds[i];
+  }
+  return cur.max;
+}
+
+uint32_t metricsQuantile(MetricHist hist, float q) {
+  static const HistData empty = {};
+  HistData cur;
+  snapshot(hist, cur);
+  return quantile(hist, cur, empty, q);
+}
+
+// 任务栈历史最小剩余 (字节)；tcpip 任务句柄取不到时为 0
+static uint32_t tcpipStackFree() {
+  TaskHandle_t h = xTaskGetHandle("tiT");
+  return h ? uxTaskGetStackHighWaterMark(h) : 0;
+}
+
+// --- Prometheus 文本输出 ---
+// 逐行写入，放不下的行整行丢弃，保证输出的每一行都完整
+struct TextOut {
+  char* buf;
+  size_t size;
+  size_t len;
+
+  void line(const char* fmt, ...) {
+    if (len + 1 >= size) return;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + len, size - len, fmt, args);
+    va_end(args);
+    if (n < 0 || len + n >= size) {
+      buf[len] = '\0';
+      size = len;  // 已满，之后的行都不再写入
+      return;
+    }
+    len += n;
+  }
+
+  void meta(const char* name, const char* type, const char* help) {
+    line("# HELP printer_node_%s %s\n# TYPE printer_node_%s %s\n", name, help, name, type);
+  }
+
+  void value(const char* name, const char* type, const char* help, uint32_t v) {
+    meta(name, type, help);
+    line("printer_node_%s %lu\n", name, (unsigned long)v);
+  }
+};
+
+static void renderHist(TextOut& out, MetricHist hist) {
+  const HistDef& def = histDefs[hist];
+  HistData h;
+  snapshot(hist, h);
+  out.meta(def.name, "histogram", def.help);
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < def.count; i++) {
+    cumulative += h.buckets[i];
+    out.line("printer_node_%s_bucket{le=\"%lu\"} %lu\n", def.name, (unsigned long)def.bounds[i], (unsigned long)cumulative);
+  }
+  out.line("printer_node_%s_bucket{le=\"+Inf\"} %lu\n", def.name, (unsigned long)h.count);
+  out.line("printer_node_%s_sum %llu\n", def.name, (unsigned long long)h.sum);
+  out.line("printer_node_%s_count %lu\n", def.name, (unsigned long)h.count);
+  // 最大值不属于直方图族，单独作为 gauge 输出
+  out.line("# TYPE printer_node_%s_max gauge\nprinter_node_%s_max %lu\n", def.name, def.name, (unsigned long)h.max);
+}
+
+// 分阶段耗时 (见 profiler.h)：只输出次数、总耗时、最大值与超预算次数，完整分桶见串口 Stage 行
+static void renderStages(TextOut& out) {
+#if PROFILE_ENABLED
+  ProfStageInfo info[STAGE_COUNT];
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+    if (!profStageInfo(i, info[i])) return;
+  }
+  out.meta("stage_calls_total", "counter", "Loop stage executions");
+  for (const ProfStageInfo& s : info) out.line("printer_node_stage_calls_total{stage=\"%s\"} %lu\n", s.name, (unsigned long)s.count);
+  out.meta("stage_us_total", "counter", "Time spent in each loop stage (us)");
+  for (const ProfStageInfo& s : info) out.line("printer_node_stage_us_total{stage=\"%s\"} %llu\n", s.name, (unsigned long long)s.totalUs);
+  out.meta("stage_us_max", "gauge", "Longest single execution of each loop stage (us)");
+  for (const ProfStageInfo& s : info) out.line("printer_node_stage_us_max{stage=\"%s\"} %lu\n", s.name, (unsigned long)s.maxUs);
+  out.meta("stage_over_budget_total", "counter", "Over-budget iterations where this stage took the longest");
+  for (const ProfStageInfo& s : info) out.line("printer_node_stage_over_budget_total{stage=\"%s\"} %lu\n", s.name, (unsigned long)s.overBudget);
+  out.meta("loop_overruns_total", "counter", "Task iterations over the profiling budget");
+  out.line("printer_node_loop_overruns_total{task=\"loop\"} %lu\n", (unsigned long)profOverruns(PROF_TASK_LOOP));
+  out.line("printer_node_loop_overruns_total{task=\"snmp\"} %lu\n", (unsigned long)profOverruns(PROF_TASK_SNMP));
+#endif
+}
+
+size_t metricsRender(char* buf, size_t size) {
+  if (size == 0) return 0;
+  buf[0] = '\0';
+  TextOut out = { buf, size, 0 };
+
+  out.value("uptime_seconds", "gauge", "Seconds since boot", millis() / 1000);
+
+  // SNMP
+  renderHist(out, HIST_SNMP_RTT);
+  out.meta("snmp_timeouts_total", "counter", "SNMP requests that timed out, by request kind");
+  out.line("printer_node_snmp_timeouts_total{kind=\"poll\"} %lu\n", (unsigned long)counter(CNT_SNMP_TIMEOUT_POLL));
+  out.line("printer_node_snmp_timeouts_total{kind=\"oid\"} %lu\n", (unsigned long)counter(CNT_SNMP_TIMEOUT_OID));
+  out.line("printer_node_snmp_timeouts_total{kind=\"walk\"} %lu\n", (unsigned long)counter(CNT_SNMP_TIMEOUT_WALK));
+  out.value("snmp_retries_total", "counter", "SNMP walk requests resent after a timeout", counter(CNT_SNMP_RETRY));
+  out.value("snmp_inflight", "gauge", "SNMP requests currently in flight", inflightCount());
+  out.value("snmp_tx_bytes_total", "counter", "SNMP request bytes sent (UDP payload)", snmpBytesSent());
+  renderHist(out, HIST_POLL_PUBLISH);
+
+  // 扫描
+  out.value("scans_total", "counter", "Network scans finished or stopped", counter(CNT_SCANS));
+  out.value("scan_duration_ms", "gauge", "Duration of the last network scan (ms)", lastScanMs.load(std::memory_order_relaxed));
+
+  // MQTT
+  const MqttConnStats& mqtt = mqttConnStats();
+  out.value("mqtt_connected", "gauge", "1 if the MQTT session is up", mqttClient.connected() ? 1 : 0);
+  out.value("mqtt_publishes_total", "counter", "MQTT PUBLISH packets written", mqtt.publishes);
+  out.value("mqtt_publish_failures_total", "counter", "MQTT PUBLISH packets that could not be written", mqtt.publishFailures);
+  out.value("mqtt_tx_bytes_total", "counter", "MQTT bytes written (all packets)", mqtt.bytesOut);
+  out.value("mqtt_connect_attempts_total", "counter", "MQTT connection attempts", mqtt.attempts);
+  out.value("mqtt_connect_failures_total", "counter", "MQTT connection attempts that failed", mqtt.failures);
+  out.value("mqtt_connects_total", "counter", "MQTT sessions established (reconnects = value - 1)", mqtt.connects);
+  renderHist(out, HIST_MQTT_CONNECT);
+
+  // Web
+  const HttpServerStats& http = httpServerStats();
+  out.value("http_requests_total", "counter", "HTTP requests dispatched", http.requests);
+  out.value("http_timeouts_total", "counter", "HTTP connections closed for not sending or reading in time", http.timeouts);
+  out.value("http_rejected_total", "counter", "HTTP requests rejected as malformed or too large", http.rejected);
+  out.value("http_connections", "gauge", "HTTP connections being served", http.active);
+  out.value("web_events_subscribers", "gauge", "Open /events streams", webEventsSubscribers());
+  out.value("web_events_frames_total", "counter", "Status frames written to /events streams", webEventsFrames());
+
+  // 循环耗时
+  renderHist(out, HIST_LOOP);
+  renderHist(out, HIST_SNMP_LOOP);
+  renderStages(out);
+
+  // 堆与任务栈
+  HeapStats heap = heapStats();
+  out.value("heap_free_bytes", "gauge", "Free heap", heap.freeBytes);
+  out.value("heap_min_free_bytes", "gauge", "Lowest free heap since boot", heap.minFreeBytes);
+  out.value("heap_largest_block_bytes", "gauge", "Largest contiguous free heap block", heap.largestBlock);
+  out.meta("task_stack_free_bytes", "gauge", "Lowest free stack since the task started");
+  out.line("printer_node_task_stack_free_bytes{task=\"loop\"} %lu\n", (unsigned long)uxTaskGetStackHighWaterMark(NULL));
+  out.line("printer_node_task_stack_free_bytes{task=\"snmp\"} %lu\n", (unsigned long)snmpTaskStackFree());
+  out.line("printer_node_task_stack_free_bytes{task=\"tcpip\"} %lu\n", (unsigned long)tcpipStackFree());
+
+  return out.len;
+}
+
+// --- diag 摘要 ---
+size_t metricsDiagJson(char* buf, size_t size) {
+  static HistData prev[HIST_COUNT];
+  HistData cur[HIST_COUNT];
+  for (uint8_t i = 0; i < HIST_COUNT; i++) snapshot((MetricHist)i, cur[i]);
+
+  const MqttConnStats& mqtt = mqttConnStats();
+  HeapStats heap = heapStats();
+  StaticJsonDocument<512> doc;
+  doc["up"] = millis() / 1000;
+  doc["rtt_p50"] = quantile(HIST_SNMP_RTT, cur[HIST_SNMP_RTT], prev[HIST_SNMP_RTT], 0.5f);
+  doc["rtt_p99"] = quantile(HIST_SNMP_RTT, cur[HIST_SNMP_RTT], prev[HIST_SNMP_RTT], 0.99f);
+  doc["snmp_to"] = counter(CNT_SNMP_TIMEOUT_POLL) + counter(CNT_SNMP_TIMEOUT_OID) + counter(CNT_SNMP_TIMEOUT_WALK);
+  doc["snmp_retry"] = counter(CNT_SNMP_RETRY);
+  doc["scans"] = counter(CNT_SCANS);
+  doc["scan_ms"] = lastScanMs.load(std::memory_order_relaxed);
+  doc["pub"] = mqtt.publishes;
+  doc["pub_fail"] = mqtt.publishFailures;
+  doc["connects"] = mqtt.connects;
+  doc["conn_fail"] = mqtt.failures;
+  doc["conn_ms"] = mqtt.connectMs;
+  doc["loop_max"] = cur[HIST_LOOP].max;
+  doc["loop_p99"] = quantile(HIST_LOOP, cur[HIST_LOOP], prev[HIST_LOOP], 0.99f);
+  doc["snmp_loop_max"] = cur[HIST_SNMP_LOOP].max;
+  doc["snmp_loop_p99"] = quantile(HIST_SNMP_LOOP, cur[HIST_SNMP_LOOP], prev[HIST_SNMP_LOOP], 0.99f);
+  doc["heap"] = heap.freeBytes;
+  doc["heap_min"] = heap.minFreeBytes;
+  doc["heap_blk"] = heap.largestBlock;
+  doc["stk_loop"] = uxTaskGetStackHighWaterMark(NULL);
+  doc["stk_snmp"] = snmpTaskStackFree();
+  doc["stk_tcpip"] = tcpipStackFree();
+
+  if (measureJson(doc) >= size) return 0;
+  memcpy(prev, cur, sizeof(prev));
+  return serializeJson(doc, buf, size);
+}
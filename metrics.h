@@ -0,0 +1,51 @@
+/*
+ * metrics.h - 节点运行指标
+ *
+ * 汇总 SNMP 往返时延/超时/重试、扫描耗时、轮询到发布的时延、MQTT 发布与重连、收发字节、
+ * 两个任务的单次循环耗时、堆与任务栈，
+ * 由 Web /metrics 输出 Prometheus 文本格式，并按 METRICS_DIAG_INTERVAL 发到 MQTT printer/{MAC}/diag。
+ * 写入分布在 SNMP 任务与 loop 任务中：计数器为 relaxed 原子变量，直方图各带一把自旋锁
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// --- 直方图 ---
+enum MetricHist : uint8_t {
+  HIST_SNMP_RTT,      // SNMP 请求往返时延 (毫秒)
+  HIST_LOOP,          // loop 任务单次循环耗时 (微秒)
+  HIST_SNMP_LOOP,     // SNMP 任务单次循环耗时 (微秒)
+  HIST_MQTT_CONNECT,  // MQTT 建立连接耗时 (毫秒，从发起到 CONNACK)
+  HIST_POLL_PUBLISH,  // 轮询请求发出到数据交给 MQTT 的耗时 (毫秒，只统计有变化而发送的采样)
+  HIST_COUNT,
+};
+
+// --- 计数器 ---
+enum MetricCounter : uint8_t {
+  CNT_SNMP_TIMEOUT_POLL,  // 轮询请求超时
+  CNT_SNMP_TIMEOUT_OID,   // OID 查询超时
+  CNT_SNMP_TIMEOUT_WALK,  // 遍历请求超时
+  CNT_SNMP_RETRY,         // 遍历请求重发
+  CNT_SCANS,              // 完成或中止的扫描次数
+  CNT_COUNT,
+};
+
+void metricsObserve(MetricHist hist, uint32_t value);
+void metricsCount(MetricCounter counter);
+
+// 扫描结束 (完成或被锁定打断) 时记录耗时
+void metricsScanDone(unsigned long durationMs);
+
+// 启动以来的第 q 分位 (所在桶的上限，落在 +Inf 桶时为最大值)，没有样本时为 0
+uint32_t metricsQuantile(MetricHist hist, float q);
+
+// 按 Prometheus 文本格式写入 buf，返回长度 (缓冲不足时截断到最后一个完整的行)
+// 任务栈读数取调用方所在任务为 loop 任务，只在 Web 处理中调用
+size_t metricsRender(char* buf, size_t size);
+
+// diag 主题的 JSON 摘要：p50/p99 按上次调用以来的增量计算，返回长度 (0 = 缓冲不足)
+size_t metricsDiagJson(char* buf, size_t size);
+
+#endif  // METRICS_H
@@ -13,6 +13,15 @@
 #include "globals.h"
 #include "ota.h"
 #include "snmp_handler.h"
+#include "printer_monitor.h"
+#include "snmp_trap.h"
+#include "telemetry_codec.h"
+#include "outbox.h"
+#include "data_batch.h"
+#include "mqtt_conn.h"
+#include "snmp_task.h"
+#include "printer_snapshot.h"
+#include "metrics.h"
 
 // MQTT 主题常量
 static const char* MQTT_TOPIC_BROADCAST_UPDATE = "server/ota/broadcast/update";  // 接收 | 广播更新
@@ -27,98 +36,57 @@ static void mqttPublish(const char* topic, const char* payload, bool retain = fa
 // --- 初始化 MQTT 主题 ---
 // 在获取 MAC 地址后调用，构建所有 MQTT 主题字符串
 void initMQTTTopics() {
-  // 构建状态主题: printer/{MAC}/status | 发送 | 上报状态
-  mqtt_topic_status.reserve(8 + deviceMAC.length() + 8);
-  mqtt_topic_status = "printer/";
-  mqtt_topic_status += deviceMAC;
-  mqtt_topic_status += "/status";
-
-  // 构建数据主题: printer/{MAC}/data | 发送 | 上报数据
-  mqtt_topic_data.reserve(8 + deviceMAC.length() + 7);
-  mqtt_topic_data = "printer/";
-  mqtt_topic_data += deviceMAC;
-  mqtt_topic_data += "/data";
-
-  // 构建 OTA 主题: server/{MAC}/ota/update | 接收 | 个人更新
-  mqtt_topic_ota.reserve(8 + deviceMAC.length() + 12);
-  mqtt_topic_ota = "server/";
-  mqtt_topic_ota += deviceMAC;
-  mqtt_topic_ota += "/ota/update";
-
-  // 构建锁定控制主题: server/{MAC}/lock | 接收 | payload: lock / unlock
-  mqtt_topic_lock.reserve(8 + deviceMAC.length() + 6);
-  mqtt_topic_lock = "server/";
-  mqtt_topic_lock += deviceMAC;
-  mqtt_topic_lock += "/lock";
-
-  // 构建锁定状态主题: printer/{MAC}/lock | 发送 | payload: lock/unlock
-  mqtt_topic_lock_state.reserve(8 + deviceMAC.length() + 6);
-  mqtt_topic_lock_state = "printer/";
-  mqtt_topic_lock_state += deviceMAC;
-  mqtt_topic_lock_state += "/lock";
-
-  // 接收 OID 请求: server/oid/{MAC}
-  mqtt_topic_oid_mac.reserve(11 + deviceMAC.length());
-  mqtt_topic_oid_mac = "server/oid/";
-  mqtt_topic_oid_mac += deviceMAC;
-
-  // 发送 OID 结果: printer/oid/{MAC}
-  mqtt_topic_server_oid_mac.reserve(11 + deviceMAC.length());
-  mqtt_topic_server_oid_mac = "printer/oid/";
-  mqtt_topic_server_oid_mac += deviceMAC;
-
-  // 发送 Web 地址: printer/{MAC}/register
-  mqtt_topic_register.reserve(8 + deviceMAC.length() + 10);
-  mqtt_topic_register = "printer/";
-  mqtt_topic_register += deviceMAC;
-  mqtt_topic_register += "/register";
-
-  // 接收注册状态: server/{MAC}/register/status
-  mqtt_topic_register_status.reserve(12 + deviceMAC.length() + 15);
-  mqtt_topic_register_status = "server/";
-  mqtt_topic_register_status += deviceMAC;
-  mqtt_topic_register_status += "/register/status";
+  const char* mac = deviceMAC;
+  snprintf(mqtt_topic_status, MQTT_TOPIC_LEN, "printer/%s/status", mac);                   // 发送 | 上报状态
+  snprintf(mqtt_topic_ota, MQTT_TOPIC_LEN, "server/%s/ota/update", mac);                   // 接收 | 个人更新
+  snprintf(mqtt_topic_lock, MQTT_TOPIC_LEN, "server/%s/lock", mac);                        // 接收 | payload: lock / unlock
+  snprintf(mqtt_topic_lock_state, MQTT_TOPIC_LEN, "printer/%s/lock", mac);                 // 发送 | payload: lock/unlock
+  snprintf(mqtt_topic_oid_mac, MQTT_TOPIC_LEN, "server/oid/%s", mac);                      // 接收 OID 请求
+  snprintf(mqtt_topic_server_oid_mac, MQTT_TOPIC_LEN, "printer/oid/%s", mac);              // 发送 OID 结果
+  snprintf(mqtt_topic_register, MQTT_TOPIC_LEN, "printer/%s/register", mac);               // 发送 Web 地址
+  snprintf(mqtt_topic_register_status, MQTT_TOPIC_LEN, "server/%s/register/status", mac);  // 接收注册状态
+  snprintf(mqtt_topic_outbox, MQTT_TOPIC_LEN, "printer/%s/outbox", mac);                   // 回放断线期间的采样
+  snprintf(mqtt_topic_outbox_ack, MQTT_TOPIC_LEN, "server/%s/outbox/ack", mac);            // 接收回放确认
+  snprintf(mqtt_topic_diag, MQTT_TOPIC_LEN, "printer/%s/diag", mac);                       // 发送运行指标摘要
+}
+
+// --- 连接后需要订阅的主题，每次 loop 订阅一个 ---
+static uint8_t subscribeNext = 0;
+
+static const char* subscribeTopic(uint8_t i) {
+  switch (i) {
+    case 0: return mqtt_topic_ota;
+    case 1: return MQTT_TOPIC_BROADCAST_UPDATE;
+    case 2: return mqtt_topic_lock;
+    case 3: return mqtt_topic_register_status;
+    case 4: return mqtt_topic_outbox_ack;
+    case 5: return MQTT_TOPIC_OID;
+    case 6: return mqtt_topic_oid_mac;
+    default: return nullptr;
+  }
 }
 
 // --- 连接 MQTT ---
+// 推进非阻塞连接一步 (见 mqtt_conn)，会话建立后上报状态与 IP，订阅留给之后的 loop
 void connectMQTT() {
-  // 使用设备 MAC 地址生成唯一的客户端 ID（预分配内存减少碎片）
-  String clientId;
-  clientId.reserve(deviceMAC.length() + 6);
-  clientId = "c-";
-  clientId += deviceMAC;  // 例如: "c-AA:BB:CC:DD:EE:FF"
-  // clientId.replace(":", "");  // 移除冒号: "c-AABBCCDDEEFF"
-
-  const char* willMessage = "offline";  // 遗嘱消息内容
-
-  // 尝试连接 MQTT 服务器，并设置遗嘱
-  // 参数：客户端ID, 用户名, 密码, 遗嘱主题, QoS级别, 保留标志, 遗嘱消息
-  if (mqttClient.connect(clientId.c_str(), MQTT_USER, MQTT_PASS,
-                         mqtt_topic_status.c_str(), 1, true, willMessage)) {
-    Serial.println("✅ MQTT Connected!");
-    mqttClient.publish(mqtt_topic_status.c_str(), "online", true);
-
-    String ip = (ETH.linkUp() && ETH.hasIP()) ? ETH.localIP().toString() : WiFi.localIP().toString();
-    if (ip.length() > 0) {
-      StaticJsonDocument<160> doc;
-      doc["ip"] = ip;
-      doc["version"] = FIRMWARE_VERSION;
-      doc["serial"] = val_PrtSerial;
-      String buf;
-      serializeJson(doc, buf);
-      mqttClient.publish(mqtt_topic_register.c_str(), buf.c_str(), true);
-    }
-
-    flushPendingMQTT();
-
-    // 订阅 OTA 主题
-    mqttClient.subscribe(mqtt_topic_ota.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_BROADCAST_UPDATE);
-    mqttClient.subscribe(mqtt_topic_lock.c_str());
-    mqttClient.subscribe(mqtt_topic_register_status.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_OID);
-    mqttClient.subscribe(mqtt_topic_oid_mac.c_str());
-  }
+  if (!mqttConnStep()) return;
+
+  Serial.println("✅ MQTT Connected!");
+  mqttClient.publish(mqtt_topic_status, "online", true);
+
+  char ip[16];
+  StaticJsonDocument<160> doc;
+  doc["ip"] = (const char*)ipToStr((ETH.linkUp() && ETH.hasIP()) ? ETH.localIP() : WiFi.localIP(), ip);
+  doc["version"] = FIRMWARE_VERSION;
+  PrinterSnapshot s;
+  printerSnapshotRead(0, s);
+  doc["serial"] = (const char*)s.serial;
+  char buf[160];
+  serializeJson(doc, buf, sizeof(buf));
+  mqttClient.publish(mqtt_topic_register, buf, true);
+
+  flushPendingMQTT();
+  subscribeNext = 0;
 }
 
 // --- MQTT 连接管理循环 ---
@@ -131,67 +99,124 @@ void mqttLoop() {
     // TODO: 掉线逻辑
     Serial.println("⚠️ MQTT 已断开");
     setPrinterLockPin(LOW);
+#if DATA_BATCH_WINDOW > 0
+    dataBatchAbort();  // 未发出的批次交给断线暂存
+#endif
+    mqttConnLost();
     wasConnected = false;
   }
   wasConnected = nowConnected;  // 保存当前状态
 
   if (!nowConnected) {
-    static unsigned long lastMqttRetry = 0;
-    if (millis() - lastMqttRetry > 5000) {
-      lastMqttRetry = millis();
-      connectMQTT();
-    }
+    connectMQTT();  // 每次 loop 只推进一个阶段，不阻塞
   } else {
+    if (const char* topic = subscribeTopic(subscribeNext)) {
+      mqttClient.subscribe(topic);
+      subscribeNext++;
+    }
     mqttClient.loop();
     flushPendingMQTT();
   }
+
+  outboxLoop(mqttClient.connected());  // 断线时暂存采样，连接后回放
+}
+
+// --- 打印机数据主题 ---
+bool mqttDataTopic(int slot, const char* serial, const char* suffix, char* topic, size_t size) {
+  if (slot == 0) {
+    snprintf(topic, size, "printer/%s/%s", deviceMAC, suffix);
+    return true;
+  }
+  if (serial[0] == '\0') return false;
+  snprintf(topic, size, "printer/%s/%s/%s", deviceMAC, serial, suffix);
+  return true;
+}
+
+// --- 上报一台打印机的数据（SysTotal 变化或首次有碳粉数据时）---
+// 主打印机 (槽位 0) 沿用 printer/{MAC}/data，其余打印机发到 printer/{MAC}/{serial}/data
+// 数值取自快照，同一条消息中的计数器与碳粉总是来自同一个轮询周期
+static void publishPrinterData(int slot) {
+  PrinterPublishState& p = printerPublish[slot];
+  PrinterSnapshot s;
+  if (!printerSnapshotRead(slot, s)) return;  // 尚无完整的轮询周期
+
+  bool hasValidToner = s.val_TonerBlack >= 0 || s.val_TonerCyan >= 0 || s.val_TonerRed >= 0 || s.val_TonerYellow >= 0;
+  // data 发送条件：SysTotal 变化，或 SysTotal 不变但首次有碳粉数据（避免碳粉数据漏报）
+  bool needSendData = (s.val_SysTotal != p.last_sent_SysTotal && s.val_SysTotal > 0)
+                      || (s.val_SysTotal == p.last_sent_SysTotal && s.val_SysTotal > 0 && !p.last_sent_had_valid_toner && hasValidToner);
+  if (!needSendData) return;  // 无变化 (如告警类 trap)：trap 已随快照结束计时，不记录耗时
+
+  TelemetrySample sample;
+  telemetryFromPrinter(s, sample);
+
+#if DATA_BATCH_WINDOW > 0
+  // 合并发送：采样进入批次，由 dataBatchLoop 在窗口到期/批次满/锁定变化时发出
+  if (slot != 0 && s.serial[0] == '\0') return;  // 序列号未读到前无法确定主题
+  dataBatchAdd(slot, s.serial, sample, s.trapAt);
+#else
+  char topic[96];
+  if (!mqttDataTopic(slot, s.serial, "data", topic, sizeof(topic))) return;
+
+  char json[256];
+  if (telemetryEncodeJson(sample, deviceMAC, s.serial, json, sizeof(json)) == 0) return;
+  mqttPublish(topic, json);
+  Serial.printf("📤 MQTT Sent [%s]: %s\n", topic, json);
+
+#if MQTT_DATA_CBOR
+  // 紧凑格式发到并行主题 .../cdata
+  uint8_t cbor[64];
+  size_t cborLen = telemetryEncodeCbor(sample, cbor, sizeof(cbor));
+  if (cborLen && mqttDataTopic(slot, s.serial, "cdata", topic, sizeof(topic))) mqttClient.publish(topic, cbor, cborLen);
+#endif
+  snmpTrapPublished(slot, s.trapAt, s.serial);
+#endif
+
+  // 轮询到发布的时延 (合并发送时为进入批次的时间，不含窗口等待)
+  metricsObserve(HIST_POLL_PUBLISH, millis() - s.polledAt);
+  p.last_sent_SysTotal = s.val_SysTotal;
+  p.last_sent_had_valid_toner = hasValidToner;
+}
+
+#if METRICS_DIAG_INTERVAL > 0
+// --- 运行指标摘要，每 METRICS_DIAG_INTERVAL 发一次（与 /metrics 同源，见 metrics.h）---
+static void publishDiag() {
+  static unsigned long lastDiag = 0;
+  if (millis() - lastDiag < METRICS_DIAG_INTERVAL) return;
+  lastDiag = millis();
+  char json[448];
+  if (metricsDiagJson(json, sizeof(json))) mqttPublish(mqtt_topic_diag, json);
 }
+#endif
 
 // --- 单一调度：读共享状态，按需调用 mqttPublish（仅在有连接时调用）---
 static void flushPendingMQTT() {
-  bool hasValidToner = val_TonerBlack >= 0 || val_TonerCyan >= 0 || val_TonerRed >= 0 || val_TonerYellow >= 0;
-  // data 发送条件：SysTotal 变化，或 SysTotal 不变但首次有碳粉数据（避免碳粉数据漏报）
-  bool needSendData = (val_SysTotal != last_sent_SysTotal && val_SysTotal > 0)
-                      || (val_SysTotal == last_sent_SysTotal && val_SysTotal > 0 && !last_sent_had_valid_toner && hasValidToner);
-  if (needSendData) {
-    StaticJsonDocument<256> doc;
-    doc["mac"] = deviceMAC;
-    doc["st"] = val_SysTotal;
-    doc["serial"] = val_PrtSerial;
-    doc["col_copies"] = val_ColCopies;
-    doc["bw_copies"] = val_BWCopies;
-    doc["col_prints"] = val_ColPrints;
-    doc["bw_prints"] = val_BWPrints;
-    doc["toner_black"] = val_TonerBlack;
-    doc["toner_cyan"] = val_TonerCyan;
-    doc["toner_red"] = val_TonerRed;
-    doc["toner_yellow"] = val_TonerYellow;
-    String json;
-    serializeJson(doc, json);
-    mqttPublish(mqtt_topic_data.c_str(), json.c_str());
-    Serial.printf("📤 MQTT Sent: %s\n", json.c_str());
-    last_sent_SysTotal = val_SysTotal;
-    last_sent_had_valid_toner = hasValidToner;
-  }
-  if (printerLockPinState != last_sent_lock) {
-    mqttPublish(mqtt_topic_lock_state.c_str(), printerLockPinState.c_str(), true);
+  for (int slot = 0; slot < printerCount; slot++) publishPrinterData(slot);
+#if DATA_BATCH_WINDOW > 0
+  // 锁定状态变化前先发出所有批次，保证服务端看到的计数与锁定状态顺序一致
+  dataBatchLoop(strcmp(printerLockPinState, last_sent_lock) != 0);
+#endif
+  if (strcmp(printerLockPinState, last_sent_lock) != 0) {
+    mqttPublish(mqtt_topic_lock_state, printerLockPinState, true);
     last_sent_lock = printerLockPinState;
   }
-  if (pendingOidResult.length() > 0) {
-    mqttPublish(mqtt_topic_server_oid_mac.c_str(), pendingOidResult.c_str());
-    pendingOidResult = "";
+  while (const char* oidResult = peekOidResult()) {
+    mqttPublish(mqtt_topic_server_oid_mac, oidResult);
+    popOidResult();
   }
+#if METRICS_DIAG_INTERVAL > 0
+  publishDiag();
+#endif
 }
 
 // --- 更新固件 ---
-void updateFirmware(const String& jsonMessage) {
+void updateFirmware(const char* jsonMessage) {
   // 使用 ArduinoJson 解析 JSON（预分配 256 字节足够）
   StaticJsonDocument<256> doc;
   DeserializationError error = deserializeJson(doc, jsonMessage);
 
   if (error) {
     Serial.printf("❌ JSON 解析失败: %s\n", error.c_str());
-    Serial.printf("收到的消息: %s\n", jsonMessage.c_str());
+    Serial.printf("收到的消息: %s\n", jsonMessage);
     return;
   }
 
@@ -200,59 +225,64 @@ void updateFirmware(const String& jsonMessage) {
     return;
   }
 
-  String url = doc["url"].as<String>();
-  if (url.length() == 0) {
+  const char* url = doc["url"].as<const char*>();
+  if (!url || url[0] == '\0') {
     Serial.println("❌ url 字段为空");
     return;
   }
 
-  Serial.printf("📥 提取到固件 URL: %s\n", url.c_str());
+  Serial.printf("📥 提取到固件 URL: %s\n", url);
   performOTAUpdate(url);
 }
 
 // --- 锁定打印机 ---
 void printerLock(bool lock) {
   setPrinterLockPin(lock ? LOW : HIGH);  // 高电平解锁，低电平锁定
+  snmpTaskPost(SNMP_CMD_POLL_RESET);     // 锁定状态变化后缩短轮询间隔，尽快捕捉打印任务
   Serial.println(lock ? "✅ 锁定打印机..." : "✅ 解锁打印机...");
 }
 
 // --- MQTT 消息回调 ---
 void mqttCallback(char* topic, byte* payload, unsigned int length) {
-  // 构建消息（预分配内存减少碎片）
-  String message;
-  message.reserve(length);
-  for (unsigned int i = 0; i < length; i++) {
-    message += (char)payload[i];
-  }
+  // 复制到固定缓冲并补结束符 (payload 不以 \0 结尾；消息不超过 MQTT 缓冲，不会截断)
+  static char message[MQTT_BUFFER_SIZE];
+  if (length >= sizeof(message)) length = sizeof(message) - 1;
+  memcpy(message, payload, length);
+  message[length] = '\0';
 
-  Serial.printf("📨 收到 MQTT 消息 [%s]: %s\n", topic, message.c_str());
+  Serial.printf("📨 收到 MQTT 消息 [%s]: %s\n", topic, message);
 
   // 判断主题类型并处理
-  if (strcmp(topic, mqtt_topic_ota.c_str()) == 0) {
+  if (strcmp(topic, mqtt_topic_ota) == 0) {
     Serial.println("✅ OTA 个人更新主题，开始个人更新...");
     // message 是 JSON 格式: {"url":"http://192.168.14.70/firmware.bin"}
     updateFirmware(message);
   } else if (strcmp(topic, MQTT_TOPIC_BROADCAST_UPDATE) == 0) {
     Serial.println("✅ 广播更新主题，开始广播更新...");
     updateFirmware(message);
-  } else if (strcmp(topic, mqtt_topic_lock.c_str()) == 0) {
-    message.trim();
-    if (message == "lock") {
+  } else if (strcmp(topic, mqtt_topic_lock) == 0) {
+    // 去掉首尾空白
+    char* cmd = message;
+    while (isspace((unsigned char)*cmd)) cmd++;
+    char* end = message + length;
+    while (end > cmd && isspace((unsigned char)end[-1])) *--end = '\0';
+    if (strcmp(cmd, "lock") == 0) {
       printerLock(true);
-    } else if (message == "unlock") {
+    } else if (strcmp(cmd, "unlock") == 0) {
       printerLock(false);
     }
-  } else if (strcmp(topic, mqtt_topic_register_status.c_str()) == 0) {
+  } else if (strcmp(topic, mqtt_topic_outbox_ack) == 0) {
+    StaticJsonDocument<64> doc;
+    if (!deserializeJson(doc, message) && doc.containsKey("seq")) {
+      outboxAck(doc["seq"].as<uint32_t>());
+    }
+  } else if (strcmp(topic, mqtt_topic_register_status) == 0) {
     StaticJsonDocument<64> doc;
     if (!deserializeJson(doc, message)) {
       isRegistered = doc["registered"].as<bool>();
     }
-  } else if (strcmp(topic, MQTT_TOPIC_OID) == 0 || strcmp(topic, mqtt_topic_oid_mac.c_str()) == 0) {
-    if (cfg_printer_ip.length() > 0) {
-      IPAddress target;
-      target.fromString(cfg_printer_ip);
-      sendSNMPOidRequest(target, message);
-    }
+  } else if (strcmp(topic, MQTT_TOPIC_OID) == 0 || strcmp(topic, mqtt_topic_oid_mac) == 0) {
+    snmpTaskPost(SNMP_CMD_OID_REQUEST, message, length);  // SNMP 收发在 SNMP 任务中
   } else {
     Serial.println("❌ 主题不匹配，忽略消息");
   }
@@ -12,12 +12,16 @@
 // 初始化 MQTT 主题字符串（在获取 MAC 地址后调用）
 void initMQTTTopics();
 
-// 连接 MQTT 服务器
+// 推进 MQTT 连接一步（非阻塞，未连接时由 mqttLoop 每次调用）
 void connectMQTT();
 
 // MQTT 连接管理循环（重连、心跳）
 void mqttLoop();
 
+// 打印机数据主题：主打印机 printer/{MAC}/{suffix}，其余打印机 printer/{MAC}/{serial}/{suffix}
+// serial 取自该打印机的快照；其余打印机未读到序列号前无法确定主题，返回 false
+bool mqttDataTopic(int slot, const char* serial, const char* suffix, char* topic, size_t size);
+
 // MQTT 消息回调函数
 void mqttCallback(char* topic, byte* payload, unsigned int length);
 
@@ -0,0 +1,288 @@
+/*
+ * mqtt_conn.cpp - 非阻塞 MQTT 连接状态机实现
+ *
+ * 阶段：
+ *   BACKOFF  等待退避到期
+ *   DNS      MQTT_BROKER 为主机名时异步解析 (lwIP 回调)，IP 字面量直接跳过
+ *   TCP      非阻塞 connect，零超时 select 检查是否完成
+ *   CONNACK  自行编码并发出 CONNECT，等 CONNACK 的 4 个字节到齐后交给 PubSubClient::connect 读取
+ *   UP       已连接，直到 mqttConnLost
+ * 每个阶段最长 MQTT_CONNECT_TIMEOUT；失败后的重试间隔在 [b/2, b] 内随机，b 从 MQTT_RETRY_MIN 起每次失败翻倍，
+ * 上限 MQTT_RETRY_MAX，避免多个节点在 broker 恢复时同时重连
+ */
+
+#include <lwip/sockets.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
+#include <PubSubClient.h>
+#include "mqtt_conn.h"
+#include "config.h"
+#include "globals.h"
+#include "metrics.h"
+
+enum ConnPhase : uint8_t {
+  CONN_BACKOFF,
+  CONN_DNS,
+  CONN_TCP,
+  CONN_CONNACK,
+  CONN_UP,
+};
+
+static const char* const phaseNames[] = { "backoff", "dns", "tcp", "connack", "up" };
+
+static ConnPhase phase = CONN_BACKOFF;
+static unsigned long phaseAt = 0;               // 进入当前阶段的时间
+static unsigned long retryDelay = 0;            // 本次退避时长 (首次立即连接)
+static unsigned long backoff = MQTT_RETRY_MIN;  // 退避基数，每次失败翻倍
+static int sockFd = -1;                         // TCP 阶段的套接字，交给 MqttTransport 后置 -1
+static unsigned long attemptAt = 0;             // 本次尝试的开始时间
+static IPAddress brokerIP;
+static char clientId[32];
+
+// DNS 回调在 tcpip 线程执行；dnsGen 区分已超时放弃的旧查询
+static volatile bool dnsDone = false;
+static volatile uint32_t dnsAddr = 0;
+static uint32_t dnsGen = 0;
+
+static MqttConnStats stats = {};
+
+// --- MqttTransport ---
+void MqttTransport::attach(int fd) {
+  client = WiFiClient(fd);
+}
+
+// PubSubClient 每个 PUBLISH 报文一次写出 (固定头在前)，按首字节类型统计发布数
+size_t MqttTransport::write(const uint8_t* buf, size_t size) {
+  if (swallowWrites) return size;
+  size_t written = client.write(buf, size);
+  stats.bytesOut += written;
+  if (size > 0 && (buf[0] & 0xF0) == 0x30) {
+    stats.publishes++;
+    if (written != size) stats.publishFailures++;
+  }
+  return written;
+}
+
+static void enter(ConnPhase next) {
+  phase = next;
+  phaseAt = millis();
+  stats.phase = phaseNames[next];
+}
+
+// 本次尝试失败：关闭套接字，按退避安排下一次
+static void fail(const char* why) {
+  if (sockFd >= 0) {
+    close(sockFd);
+    sockFd = -1;
+  }
+  mqttTransport.stop();
+  stats.failures++;
+  retryDelay = backoff / 2 + random(backoff / 2 + 1);
+  backoff = backoff * 2 > MQTT_RETRY_MAX ? MQTT_RETRY_MAX : backoff * 2;
+  Serial.printf("⚠️ MQTT 连接失败 (%s)，%lu ms 后重试\n", why, retryDelay);
+  enter(CONN_BACKOFF);
+}
+
+static size_t putString(uint8_t* p, const char* s) {
+  size_t n = strlen(s);
+  p[0] = n >> 8;
+  p[1] = n & 0xFF;
+  memcpy(p + 2, s, n);
+  return n + 2;
+}
+
+// 编码 MQTT 3.1.1 CONNECT：clean session、遗嘱 (QoS 1, retain) "offline"、用户名与密码
+// 与 PubSubClient::connect 使用相同的参数，保证它读到的 CONNACK 对应同一个会话
+static size_t encodeConnect(uint8_t* buf, size_t cap) {
+  const char* strings[] = { clientId, mqtt_topic_status, "offline", MQTT_USER, MQTT_PASS };
+  size_t remaining = 10;
+  for (const char* s : strings) remaining += 2 + strlen(s);
+  if (remaining + 5 > cap) return 0;
+
+  size_t n = 0;
+  buf[n++] = 0x10;  // CONNECT
+  size_t len = remaining;
+  do {
+    uint8_t digit = len % 128;
+    len /= 128;
+    buf[n++] = len ? digit | 0x80 : digit;
+  } while (len);
+
+  static const uint8_t protocol[] = { 0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04 };
+  memcpy(buf + n, protocol, sizeof(protocol));
+  n += sizeof(protocol);
+  buf[n++] = 0x80 | 0x40 | 0x20 | 0x08 | 0x04 | 0x02;  // 用户名、密码、遗嘱 retain、遗嘱 QoS 1、遗嘱、clean session
+  buf[n++] = MQTT_KEEPALIVE >> 8;
+  buf[n++] = MQTT_KEEPALIVE & 0xFF;
+  for (const char* s : strings) n += putString(buf + n, s);
+  return n;
+}
+
+// TCP 已连通：套接字交给传输层，发出 CONNECT
+static void sendConnect() {
+  fcntl(sockFd, F_SETFL, fcntl(sockFd, F_GETFL, 0) & ~O_NONBLOCK);  // WiFiClient 按阻塞套接字写入
+  mqttTransport.attach(sockFd);
+  sockFd = -1;
+
+  uint8_t buf[192];
+  size_t len = encodeConnect(buf, sizeof(buf));
+  if (len == 0 || mqttTransport.write(buf, len) != len) {
+    fail("send connect");
+    return;
+  }
+  enter(CONN_CONNACK);
+}
+
+static void openSocket() {
+  sockFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sockFd < 0) {
+    fail("no socket");
+    return;
+  }
+  fcntl(sockFd, F_SETFL, fcntl(sockFd, F_GETFL, 0) | O_NONBLOCK);
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(MQTT_PORT);
+  addr.sin_addr.s_addr = (uint32_t)brokerIP;
+
+  int rc = connect(sockFd, (struct sockaddr*)&addr, sizeof(addr));
+  if (rc == 0) {
+    sendConnect();
+  } else if (errno == EINPROGRESS) {
+    enter(CONN_TCP);
+  } else {
+    fail("connect");
+  }
+}
+
+static void onDnsFound(const char* name, const ip_addr_t* addr, void* arg) {
+  if ((uint32_t)(uintptr_t)arg != dnsGen) return;
+  dnsAddr = addr ? ip4_addr_get_u32(ip_2_ip4(addr)) : 0;
+  dnsDone = true;
+}
+
+static void beginAttempt() {
+  stats.attempts++;
+  attemptAt = millis();
+  if (clientId[0] == '\0') snprintf(clientId, sizeof(clientId), "c-%s", deviceMAC);
+
+  if (brokerIP.fromString(MQTT_BROKER)) {
+    openSocket();
+    return;
+  }
+
+  ip_addr_t addr;
+  dnsDone = false;
+  dnsGen++;
+  LOCK_TCPIP_CORE();
+  err_t err = dns_gethostbyname_addrtype(MQTT_BROKER, &addr, onDnsFound, (void*)(uintptr_t)dnsGen, LWIP_DNS_ADDRTYPE_IPV4);
+  UNLOCK_TCPIP_CORE();
+  if (err == ERR_OK) {
+    brokerIP = ip4_addr_get_u32(ip_2_ip4(&addr));  // 已在缓存中
+    openSocket();
+  } else if (err == ERR_INPROGRESS) {
+    enter(CONN_DNS);
+  } else {
+    fail("dns");
+  }
+}
+
+static void pollDns(unsigned long now) {
+  if (dnsDone) {
+    if (dnsAddr == 0) {
+      fail("dns not found");
+      return;
+    }
+    brokerIP = (uint32_t)dnsAddr;
+    openSocket();
+  } else if (now - phaseAt > MQTT_CONNECT_TIMEOUT) {
+    fail("dns timeout");
+  }
+}
+
+static void pollTcp(unsigned long now) {
+  fd_set wfds, efds;
+  FD_ZERO(&wfds);
+  FD_ZERO(&efds);
+  FD_SET(sockFd, &wfds);
+  FD_SET(sockFd, &efds);
+  struct timeval tv = { 0, 0 };
+  if (select(sockFd + 1, NULL, &wfds, &efds, &tv) > 0) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(sockFd, SOL_SOCKET, SO_ERROR, &err, &len);
+    if (err == 0) sendConnect();
+    else fail("tcp refused");
+  } else if (now - phaseAt > MQTT_CONNECT_TIMEOUT) {
+    fail("tcp timeout");
+  }
+}
+
+// CONNACK 固定 4 字节，到齐后 PubSubClient::connect 不会再等待
+static bool pollConnack(unsigned long now) {
+  if (mqttTransport.available() >= 4) {
+    mqttTransport.setSwallowWrites(true);
+    bool ok = mqttClient.connect(clientId, MQTT_USER, MQTT_PASS, mqtt_topic_status, 1, true, "offline");
+    mqttTransport.setSwallowWrites(false);
+    if (!ok) {
+      char why[24];
+      snprintf(why, sizeof(why), "rejected rc=%d", mqttClient.state());
+      fail(why);
+      return false;
+    }
+    backoff = MQTT_RETRY_MIN;
+    stats.connects++;
+    stats.connectMs = millis() - attemptAt;
+    metricsObserve(HIST_MQTT_CONNECT, stats.connectMs);
+    enter(CONN_UP);
+    return true;
+  }
+  if (!mqttTransport.connected()) fail("closed");
+  else if (now - phaseAt > MQTT_CONNECT_TIMEOUT) fail("connack timeout");
+  return false;
+}
+
+bool mqttConnStep() {
+  uint32_t start = micros();
+  unsigned long now = millis();
+  bool up = false;
+
+  switch (phase) {
+    case CONN_BACKOFF:
+      if (now - phaseAt >= retryDelay) beginAttempt();
+      break;
+    case CONN_DNS:
+      pollDns(now);
+      break;
+    case CONN_TCP:
+      pollTcp(now);
+      break;
+    case CONN_CONNACK:
+      up = pollConnack(now);
+      break;
+    case CONN_UP:
+      if (!mqttClient.connected()) mqttConnLost();  // 兜底：断开未经 mqttLoop 检测到
+      break;
+  }
+
+  uint32_t us = micros() - start;
+  if (us > stats.stallMaxUs) stats.stallMaxUs = us;
+  return up;
+}
+
+void mqttConnLost() {
+  retryDelay = random(MQTT_RETRY_MIN + 1);
+  enter(CONN_BACKOFF);
+}
+
+unsigned long mqttConnRetryIn() {
+  if (phase != CONN_BACKOFF) return 0;
+  unsigned long elapsed = millis() - phaseAt;
+  return elapsed >= retryDelay ? 0 : retryDelay - elapsed;
+}
+
+const MqttConnStats& mqttConnStats() {
+  if (!stats.phase) stats.phase = phaseNames[phase];
+  return stats;
+}
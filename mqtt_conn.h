@@ -0,0 +1,65 @@
+/*
+ * mqtt_conn.h - 非阻塞 MQTT 连接状态机
+ *
+ * PubSubClient::connect 会阻塞在 TCP 连接和 CONNACK 等待上，broker 不可达时主循环停顿数秒。
+ * 这里把建立连接拆成 DNS -> TCP 连接 -> CONNECT/CONNACK 几个阶段，每次 loop 只推进一步，
+ * 失败后按带抖动的指数退避重试；连接后的订阅由 mqtt.cpp 每次 loop 发出一个
+ */
+
+#ifndef MQTT_CONN_H
+#define MQTT_CONN_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// PubSubClient 的传输层：包装由状态机连好的套接字
+// connect() 不做任何事 (连接由 mqttConnStep 建立)；CONNECT 报文由状态机自行发出，
+// CONNACK 到达后再调用 PubSubClient::connect，此时它重复写出的 CONNECT 被丢弃，只读取 CONNACK
+class MqttTransport : public Client {
+ public:
+  void attach(int fd);  // 接管已完成 TCP 连接的套接字
+  void setSwallowWrites(bool on) { swallowWrites = on; }
+
+  int connect(IPAddress ip, uint16_t port) override { return 0; }
+  int connect(const char* host, uint16_t port) override { return 0; }
+  size_t write(uint8_t b) override { return write(&b, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  int available() override { return client.available(); }
+  int read() override { return client.read(); }
+  int read(uint8_t* buf, size_t size) override { return client.read(buf, size); }
+  int peek() override { return client.peek(); }
+  void flush() override { client.flush(); }
+  void stop() override { client.stop(); }
+  uint8_t connected() override { return client.connected(); }
+  operator bool() override { return client; }
+
+ private:
+  WiFiClient client;
+  bool swallowWrites = false;
+};
+
+// --- 连接统计 ---
+struct MqttConnStats {
+  uint32_t attempts;         // 发起连接的次数
+  uint32_t failures;         // 连接失败次数
+  uint32_t connects;         // 成功建立会话的次数 (重连次数 = connects - 1)
+  uint32_t connectMs;        // 最近一次成功连接的耗时 (毫秒，从发起到 CONNACK)
+  uint32_t stallMaxUs;       // 状态机单步最长耗时 (微秒)，即 broker 不可达时对主循环的最大停顿
+  uint32_t publishes;        // 写出的 PUBLISH 报文数 (在传输层按报文类型统计，覆盖所有发布路径)
+  uint32_t publishFailures;  // 未能完整写出的 PUBLISH 报文数
+  uint32_t bytesOut;         // 写出的字节数 (所有 MQTT 报文，不含 TCP/IP 头)
+  const char* phase;         // 当前阶段：backoff / dns / tcp / connack / up
+};
+
+// 推进连接一步（未连接时每次 loop 调用），CONNACK 成功、会话建立时返回 true
+bool mqttConnStep();
+
+// 已建立的连接断开：稍作随机延迟后重新连接
+void mqttConnLost();
+
+// 距离下一次连接尝试的毫秒数，正在连接或已连接时为 0
+unsigned long mqttConnRetryIn();
+
+const MqttConnStats& mqttConnStats();
+
+#endif  // MQTT_CONN_H
@@ -0,0 +1,89 @@
+/*
+ * oid_table.cpp - 轮询 OID 表与查找实现
+ *
+ * 表在编译期生成开放寻址哈希索引，运行时每个 varbind 只需遍历一次名称、探测几个槽位，
+ * 分发开销与表的行数无关
+ */
+
+#include "oid_table.h"
+#include "config.h"
+#include "globals.h"
+
+#define OID_ROW(oid, kind, dest) { oid, oidHash(oid, oidLen(oid)), (uint8_t)oidLen(oid), kind, dest }
+
+// --- 轮询 OID 表（新增计数器：加一行即可）---
+static constexpr OidEntry OID_TABLE[] = {
+  OID_ROW(OID_PRT_SERIAL, OID_KIND_SERIAL, nullptr),
+  OID_ROW(OID_SYS_TOTAL, OID_KIND_COUNTER, &PrinterState::val_SysTotal),
+  OID_ROW(OID_COL_COPIES, OID_KIND_COUNTER, &PrinterState::val_ColCopies),
+  OID_ROW(OID_BW_COPIES, OID_KIND_COUNTER, &PrinterState::val_BWCopies),
+  OID_ROW(OID_COL_PRINTS, OID_KIND_COUNTER, &PrinterState::val_ColPrints),
+  OID_ROW(OID_BW_PRINTS, OID_KIND_COUNTER, &PrinterState::val_BWPrints),
+  OID_ROW(OID_TONER_BLACK, OID_KIND_TONER, &PrinterState::val_TonerBlack),
+  OID_ROW(OID_TONER_CYAN, OID_KIND_TONER, &PrinterState::val_TonerCyan),
+  OID_ROW(OID_TONER_RED, OID_KIND_TONER, &PrinterState::val_TonerRed),
+  OID_ROW(OID_TONER_YELLOW, OID_KIND_TONER, &PrinterState::val_TonerYellow),
+};
+
+#undef OID_ROW
+
+const OidEntry* const oidTable = OID_TABLE;
+const size_t oidTableSize = sizeof(OID_TABLE) / sizeof(OID_TABLE[0]);
+
+// --- 编译期哈希索引（槽位存 行号+1，0 表示空）---
+static constexpr size_t OID_INDEX_SIZE = 64;
+static_assert(sizeof(OID_TABLE) / sizeof(OID_TABLE[0]) * 2 <= OID_INDEX_SIZE, "OID_INDEX_SIZE 需至少为表行数的两倍");
+
+struct OidIndex {
+  uint8_t slot[OID_INDEX_SIZE];
+};
+
+static constexpr OidIndex buildOidIndex() {
+  OidIndex idx = {};
+  for (size_t i = 0; i < sizeof(OID_TABLE) / sizeof(OID_TABLE[0]); i++) {
+    size_t pos = OID_TABLE[i].hash & (OID_INDEX_SIZE - 1);
+    while (idx.slot[pos]) pos = (pos + 1) & (OID_INDEX_SIZE - 1);
+    idx.slot[pos] = i + 1;
+  }
+  return idx;
+}
+
+static constexpr OidIndex OID_INDEX = buildOidIndex();
+
+// 在索引中查找哈希与长度都匹配的行，并校验前缀后返回
+static const OidEntry* probe(const char* name, uint32_t hash, size_t len) {
+  size_t pos = hash & (OID_INDEX_SIZE - 1);
+  while (uint8_t row = OID_INDEX.slot[pos]) {
+    const OidEntry* e = &OID_TABLE[row - 1];
+    if (e->hash == hash && e->len == len && memcmp(e->oid, name, len) == 0) return e;
+    pos = (pos + 1) & (OID_INDEX_SIZE - 1);
+  }
+  return nullptr;
+}
+
+const OidEntry* oidLookup(const char* name) {
+  if (!name) return nullptr;
+
+  // 一次遍历：计算整个名称的哈希，同时记下最后两个 '.' 之前的前缀哈希 (用于匹配实例后缀)
+  uint32_t h = 2166136261u;
+  uint32_t prefixHash[2] = { 0, 0 };
+  size_t prefixLen[2] = { 0, 0 };
+  size_t n = 0;
+  for (; name[n]; n++) {
+    if (name[n] == '.') {
+      prefixHash[1] = prefixHash[0];
+      prefixLen[1] = prefixLen[0];
+      prefixHash[0] = h;
+      prefixLen[0] = n;
+    }
+    h ^= (uint8_t)name[n];
+    h *= 16777619u;
+  }
+
+  if (const OidEntry* e = probe(name, h, n)) return e;
+  for (int i = 0; i < 2; i++) {
+    if (prefixLen[i] == 0) break;
+    if (const OidEntry* e = probe(name, prefixHash[i], prefixLen[i])) return e;
+  }
+  return nullptr;
+}
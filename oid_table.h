@@ -0,0 +1,53 @@
+/*
+ * oid_table.h - 轮询 OID 表
+ *
+ * 每个轮询的 OID 对应表中一行：OID 字符串、编译期计算的哈希/长度、类别与目标字段。
+ * 新增一个计数器只需在 oid_table.cpp 中加一行；请求构建与响应分发都由此表驱动。
+ */
+
+#ifndef OID_TABLE_H
+#define OID_TABLE_H
+
+#include <Arduino.h>
+#include "globals.h"
+
+// --- OID 类别（决定放入哪个 GetRequest 以及如何解析）---
+enum OidKind : uint8_t {
+  OID_KIND_SERIAL,   // 序列号 (OctetString)，扫描与锁定模式都请求
+  OID_KIND_COUNTER,  // 计数器，随 pollPrinter 的第一个请求
+  OID_KIND_TONER,    // 碳粉余量，pollPrinter 单独请求 (Ricoh 合并请求时只返回前 6 项)
+};
+
+struct OidEntry {
+  const char* oid;  // 点分 OID
+  uint32_t hash;    // oidHash(oid)
+  uint8_t len;      // strlen(oid)
+  OidKind kind;
+  int PrinterState::*dest;  // 数值写入的 PrinterState 字段 (序列号为 nullptr)
+};
+
+// 编译期 FNV-1a 哈希，与 oidLookup 在运行时逐字符计算的结果一致
+constexpr uint32_t oidHash(const char* s, size_t n) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < n; i++) {
+    h ^= (uint8_t)s[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+constexpr size_t oidLen(const char* s) {
+  size_t n = 0;
+  while (s[n]) n++;
+  return n;
+}
+
+// 轮询 OID 表
+extern const OidEntry* const oidTable;
+extern const size_t oidTableSize;
+
+// 按响应中的 OID 名称查表：一次遍历名称，命中精确 OID 或带最多 2 段实例后缀的 OID (如 ...5.1.0)
+// 未命中返回 nullptr
+const OidEntry* oidLookup(const char* name);
+
+#endif  // OID_TABLE_H
@@ -0,0 +1,237 @@
+/*
+ * outbox.cpp - 断线采样暂存实现
+ *
+ * 文件布局：OutboxHeader + OUTBOX_CAPACITY 条定长 OutboxRecord，序号 seq 存放在 seq % OUTBOX_CAPACITY；
+ * head 为下一个写入序号，tail 为最早未确认序号，写满时覆盖最旧的记录。
+ * flash 写入次数有界：同一打印机至少隔 OUTBOX_SAMPLE_INTERVAL 才采样一次，
+ * 采样先放 RAM，每 OUTBOX_FLUSH_INTERVAL (或暂存满) 才写一次文件
+ */
+
+#include "outbox.h"
+#include <LittleFS.h>
+#include <ArduinoJson.h>
+#include "config.h"
+#include "globals.h"
+#include "telemetry_codec.h"
+
+#define OUTBOX_PATH "/outbox.bin"
+#define OUTBOX_MAGIC 0x4F425831  // "OBX1"，记录格式变化时修改
+
+struct OutboxHeader {
+  uint32_t magic;
+  uint32_t head;  // 下一个写入序号
+  uint32_t tail;  // 最早未确认序号
+};
+
+struct OutboxRecord {
+  uint32_t seq;
+  char serial[24];  // 打印机序列号 (回放时区分打印机)
+  TelemetrySample sample;
+};
+
+static bool ready = false;  // LittleFS 与文件就绪
+static OutboxHeader header;
+
+// RAM 暂存 (尚未写入 flash)
+static OutboxRecord stage[OUTBOX_STAGE];
+static uint8_t stageCount = 0;
+static unsigned long lastFlush = 0;
+
+// 断线采样去重 (断线时以 last_sent_SysTotal 为基准)
+static int lastSampledSt[MAX_PRINTERS];
+static unsigned long lastSampleAt[MAX_PRINTERS];
+
+// 回放状态：一次只有一批在途，等确认或超时重发
+static uint32_t awaitingSeq = 0;  // 在途批次的最后一个序号 + 1，0 表示无
+static unsigned long sentAt = 0;
+static uint32_t replayStartTail = 0;
+static unsigned long replayStartAt = 0;
+static bool replaying = false;
+
+static uint32_t flashWrites = 0;
+static uint8_t acksSinceWrite = 0;  // 尚未写入文件头的确认数
+
+static size_t recordOffset(uint32_t seq) {
+  return sizeof(OutboxHeader) + (seq % OUTBOX_CAPACITY) * sizeof(OutboxRecord);
+}
+
+static bool writeHeader(File& f) {
+  return f.seek(0) && f.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+}
+
+void outboxBegin() {
+  if (!LittleFS.begin(true)) {
+    Serial.println("❌ LittleFS 挂载失败，断线暂存不可用");
+    return;
+  }
+  File f = LittleFS.open(OUTBOX_PATH, "r");
+  bool valid = f && f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && header.magic == OUTBOX_MAGIC
+               && header.head - header.tail <= OUTBOX_CAPACITY;
+  if (f) f.close();
+
+  if (!valid) {
+    header = { OUTBOX_MAGIC, 1, 1 };
+    f = LittleFS.open(OUTBOX_PATH, "w");
+    if (!f || !writeHeader(f)) {
+      Serial.println("❌ 断线暂存文件创建失败");
+      if (f) f.close();
+      return;
+    }
+    f.close();
+  }
+  ready = true;
+  Serial.printf("Outbox: %lu pending\n", (unsigned long)(header.head - header.tail));
+}
+
+// RAM 暂存写入 flash：一次打开文件、顺序写入各条记录并更新文件头
+static void flushStage() {
+  if (stageCount == 0) return;
+  File f = LittleFS.open(OUTBOX_PATH, "r+");
+  if (!f) return;
+  for (uint8_t i = 0; i < stageCount; i++) {
+    OutboxRecord& r = stage[i];
+    r.seq = header.head++;
+    if (header.head - header.tail > OUTBOX_CAPACITY) header.tail = header.head - OUTBOX_CAPACITY;  // 覆盖最旧的
+    f.seek(recordOffset(r.seq));
+    f.write((const uint8_t*)&r, sizeof(r));
+  }
+  writeHeader(f);
+  f.close();
+  flashWrites++;
+  Serial.printf("Outbox: +%u samples, %lu pending, %lu flash writes\n", stageCount,
+                (unsigned long)(header.head - header.tail), (unsigned long)flashWrites);
+  stageCount = 0;
+}
+
+// 断线期间：计数有变化且距上次采样足够久的打印机记一条采样
+static void sampleChanges(unsigned long now) {
+  for (int slot = 0; slot < printerCount && stageCount < OUTBOX_STAGE; slot++) {
+    PrinterSnapshot p;
+    if (!printerSnapshotRead(slot, p)) continue;
+    if (p.val_SysTotal <= 0 || p.serial[0] == '\0' || p.val_SysTotal == lastSampledSt[slot]) continue;
+    if (lastSampleAt[slot] != 0 && now - lastSampleAt[slot] < OUTBOX_SAMPLE_INTERVAL) continue;
+
+    OutboxRecord& r = stage[stageCount++];
+    strlcpy(r.serial, p.serial, sizeof(r.serial));
+    telemetryFromPrinter(p, r.sample);
+    lastSampledSt[slot] = p.val_SysTotal;
+    lastSampleAt[slot] = now;
+  }
+}
+
+// 从 tail 起读取一批记录，发到 printer/{MAC}/outbox
+static void replayBatch(unsigned long now) {
+  File f = LittleFS.open(OUTBOX_PATH, "r");
+  if (!f) return;
+
+  StaticJsonDocument<768> doc;
+  doc["seq"] = header.tail;
+  JsonArray samples = doc.createNestedArray("samples");
+  uint32_t seq = header.tail;
+  while (seq != header.head && samples.size() < OUTBOX_BATCH) {
+    OutboxRecord r;
+    if (!f.seek(recordOffset(seq)) || f.read((uint8_t*)&r, sizeof(r)) != sizeof(r)) break;
+    JsonObject item = samples.createNestedObject();
+    item["serial"] = r.serial;
+    if (r.sample.ts) item["ts"] = r.sample.ts;
+    item["st"] = r.sample.st;
+    item["cc"] = r.sample.colCopies;
+    item["bc"] = r.sample.bwCopies;
+    item["cp"] = r.sample.colPrints;
+    item["bp"] = r.sample.bwPrints;
+    JsonArray toner = item.createNestedArray("tn");
+    for (int8_t t : r.sample.toner) toner.add(t);
+    // 超出 MQTT 缓冲时去掉最后一条，留到下一批
+    if (measureJson(doc) > OUTBOX_PAYLOAD_MAX) {
+      samples.remove(samples.size() - 1);
+      break;
+    }
+    seq++;
+  }
+  f.close();
+  if (samples.size() == 0) return;
+
+  char payload[OUTBOX_PAYLOAD_MAX + 1];
+  serializeJson(doc, payload, sizeof(payload));
+  if (mqttClient.publish(mqtt_topic_outbox, payload)) {
+    awaitingSeq = seq;
+    sentAt = now;
+  }
+}
+
+// 连接时：先把暂存写入 flash，再逐批回放；未确认的批次超时后重发 (服务端按 seq 去重)
+static void replayStep(unsigned long now) {
+  if (header.tail == header.head) {
+    if (replaying) {
+      uint32_t n = header.tail - replayStartTail;
+      unsigned long ms = now - replayStartAt;
+      Serial.printf("Outbox replay done: %lu samples in %lu ms (%.1f samples/s)\n", (unsigned long)n, ms,
+                    ms ? n * 1000.0f / ms : 0.0f);
+      replaying = false;
+    }
+    return;
+  }
+  if (!replaying) {
+    replaying = true;
+    replayStartTail = header.tail;
+    replayStartAt = now;
+  }
+  if (awaitingSeq != 0 && now - sentAt < OUTBOX_ACK_TIMEOUT) return;
+  replayBatch(now);
+}
+
+void outboxLoop(bool mqttConnected) {
+  if (!ready) return;
+  unsigned long now = millis();
+
+  static bool wasConnected = true;
+  if (!mqttConnected && wasConnected) {
+    // 刚断线：以最后一次成功上报的值为基准，只记录之后的变化；未确认的批次重连后重发
+    for (int slot = 0; slot < MAX_PRINTERS; slot++) {
+      lastSampledSt[slot] = printerPublish[slot].last_sent_SysTotal;
+      lastSampleAt[slot] = 0;
+    }
+    awaitingSeq = 0;
+  }
+  wasConnected = mqttConnected;
+
+  if (!mqttConnected) {
+    sampleChanges(now);
+    if (stageCount == OUTBOX_STAGE || (stageCount && now - lastFlush >= OUTBOX_FLUSH_INTERVAL)) {
+      flushStage();
+      lastFlush = now;
+    }
+    return;
+  }
+
+  if (stageCount) {
+    flushStage();
+    lastFlush = now;
+  }
+  replayStep(now);
+}
+
+void outboxAck(uint32_t seq) {
+  if (!ready || awaitingSeq == 0) return;
+  // 只接受当前批次范围内的确认
+  if ((int32_t)(seq - header.tail) < 0 || (int32_t)(seq - awaitingSeq) >= 0) return;
+  header.tail = seq + 1;
+  awaitingSeq = 0;
+
+  // 文件头每 OUTBOX_ACK_PERSIST 次确认或回放完毕时才写一次；重启丢失的进度只会导致重发 (服务端按 seq 去重)
+  if (++acksSinceWrite < OUTBOX_ACK_PERSIST && header.tail != header.head) return;
+  acksSinceWrite = 0;
+  File f = LittleFS.open(OUTBOX_PATH, "r+");
+  if (!f) return;
+  writeHeader(f);
+  f.close();
+  flashWrites++;
+}
+
+uint32_t outboxPending() {
+  return header.head - header.tail + stageCount;
+}
+
+uint32_t outboxWrites() {
+  return flashWrites;
+}
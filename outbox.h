@@ -0,0 +1,28 @@
+/*
+ * outbox.h - MQTT 断线期间的计数采样暂存 (store-and-forward)
+ *
+ * MQTT 断开时，计数变化的采样先暂存在 RAM，定时批量写入 LittleFS 上的环形文件，重启后仍在；
+ * 重新连上后按序号顺序分批发到 printer/{MAC}/outbox，服务端在 server/{MAC}/outbox/ack 确认后截断
+ */
+
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <Arduino.h>
+
+// 挂载 LittleFS 并打开环形文件（setup 中调用）
+void outboxBegin();
+
+// 每次 loop 调用：断线时采样、定时写 flash；连接时分批回放
+void outboxLoop(bool mqttConnected);
+
+// 服务端确认：序号 ≤ seq 的采样已收到
+void outboxAck(uint32_t seq);
+
+// 尚未确认的采样数（含 RAM 中未写入 flash 的）
+uint32_t outboxPending();
+
+// 启动以来写 flash 的次数
+uint32_t outboxWrites();
+
+#endif  // OUTBOX_H
@@ -10,7 +10,6 @@
 #include <ETH.h>
 #include <Network.h>
 #include <SPI.h>
-#include <WebServer.h>
 #include <WiFiUdp.h>
 #include <SNMP.h>
 #include <Preferences.h>
@@ -29,6 +28,20 @@
 #include "snmp_handler.h"
 #include "printer_monitor.h"
 #include "led_indicator.h"
+#include "snmp_inflight.h"
+#include "snmp_poll.h"
+#include "telemetry_codec.h"
+#include "outbox.h"
+#include "mqtt_conn.h"
+#include "snmp_task.h"
+#include "printer_snapshot.h"
+#include "alloc_stats.h"
+#include "metrics.h"
+#include "profiler.h"
+#include "sim.h"
+#include "snmp_bench.h"
+#include "http_server.h"
+#include "web_events.h"
 
 // --- 函数前置声明 ---
 void initNetwork();                             // 初始化网络连接
@@ -58,19 +71,21 @@ void onNetworkEvent(arduino_event_id_t event) {
       break;
     case ARDUINO_EVENT_ETH_GOT_IP:
       {
-        IPAddress ip = ETH.localIP();
-        deviceIP = ip.toString();
-        Serial.printf("LAN IP: %s\n", deviceIP.c_str());
-        statusMessage = "Ethernet Connected: " + deviceIP;
+        char ip[16];
+        ipToStr(ETH.localIP(), ip);
+        strlcpy(deviceIP, ip, sizeof(deviceIP));
+        Serial.printf("LAN IP: %s\n", ip);
+        setStatusMessage("Ethernet Connected: %s", ip);
         Network.setDefaultInterface(ETH);
         break;
       }
     case ARDUINO_EVENT_WIFI_STA_GOT_IP:
       {
-        IPAddress ip = WiFi.localIP();
-        if (!ETH.linkUp() || !ETH.hasIP()) deviceIP = ip.toString();
-        Serial.printf("WiFi IP: %s\n", ip.toString().c_str());
-        statusMessage = "WiFi Connected: " + ip.toString();
+        char ip[16];
+        ipToStr(WiFi.localIP(), ip);
+        if (!ETH.linkUp() || !ETH.hasIP()) strlcpy(deviceIP, ip, sizeof(deviceIP));
+        Serial.printf("WiFi IP: %s\n", ip);
+        setStatusMessage("WiFi Connected: %s", ip);
         break;
       }
     default:
@@ -90,69 +105,180 @@ void initNetwork() {
     WiFi.STA.connect(cfg_ssid.c_str(), cfg_pass.c_str());
 }
 
+// --- 状态 JSON (/status 与 /events 共用) ---
+static size_t renderStatusJson(char* buf, size_t size) {
+  const char* mqttState = mqttClient.connected() ? "Connected" : "Disconnected";
+
+  // 计数与碳粉取自快照 (同一轮询周期)，IP 与轮询调度信息取自 SNMP 任务发布的轮询状态
+  PrinterStatus p;
+  printerStatusRead(0, p);
+  PrinterSnapshot s;
+  printerSnapshotRead(0, s);
+  StaticJsonDocument<1024> doc;
+  doc["serial"] = (const char*)s.serial;
+  doc["cc"] = s.val_ColCopies;
+  doc["cp"] = s.val_ColPrints;
+  doc["ct"] = s.calc_ColTotal;
+  doc["bc"] = s.calc_BWCopies;
+  doc["bp"] = s.calc_BWPrints;
+  doc["bt"] = s.calc_BWTotal;
+  doc["st"] = s.val_SysTotal;
+  doc["toner_black"] = s.val_TonerBlack;
+  doc["toner_cyan"] = s.val_TonerCyan;
+  doc["toner_red"] = s.val_TonerRed;
+  doc["toner_yellow"] = s.val_TonerYellow;
+  char msg[64];
+  getStatusMessage(msg, sizeof(msg));
+  doc["msg"] = (const char*)msg;
+  doc["mqtt_state"] = mqttState;
+  char detectedIP[16] = "";
+  if (p.ip) ipToStr(IPAddress(p.ip), detectedIP);
+  doc["detectedIP"] = (const char*)detectedIP;
+  doc["interval"] = p.pollInterval;  // 当前轮询间隔 (毫秒)
+  doc["polls"] = p.pollCount;        // 累计轮询次数
+  doc["polls_dropped"] = p.pollDropped;  // 有请求超时或响应不完整、未发布快照的轮询周期数
+  doc["traps"] = p.trapCount;        // 收到的 trap/inform 数
+  doc["trap_latency"] = printerPublish[0].trapLatency;  // 最近一次 trap 到数据发布的耗时 (毫秒)
+  doc["outbox_pending"] = outboxPending();  // 断线暂存中未确认的采样数
+  doc["outbox_writes"] = outboxWrites();    // 启动以来写 flash 的次数
+  doc["mqtt_phase"] = mqttConnStats().phase;          // 连接阶段 backoff/dns/tcp/connack/up
+  doc["mqtt_retry_in"] = mqttConnRetryIn();           // 距下次重连的毫秒数
+  doc["mqtt_stall_us"] = mqttConnStats().stallMaxUs;  // 连接状态机单步最长耗时 (微秒)
+  HeapStats heap = heapStats();
+  doc["heap_free"] = heap.freeBytes;          // 当前空闲堆 (字节)
+  doc["heap_min"] = heap.minFreeBytes;        // 启动以来最低空闲堆
+  doc["heap_max_block"] = heap.largestBlock;  // 最大连续空闲块，持续下降说明有碎片
+  doc["heap_blocks"] = heap.blocks;           // 已分配块数
+  doc["allocs"] = allocCount();               // 启动以来 operator new 次数
+
+  // 其余打印机的摘要
+  JsonArray others = doc.createNestedArray("printers");
+  for (int slot = 1; slot < printerCount; slot++) {
+    PrinterStatus o;
+    printerStatusRead(slot, o);
+    PrinterSnapshot os;
+    printerSnapshotRead(slot, os);
+    char ip[16];
+    JsonObject item = others.createNestedObject();
+    item["ip"] = ipToStr(IPAddress(o.ip), ip);  // 非 const 的 char* 会被复制进文档
+    item["serial"] = os.serial;
+    item["st"] = os.val_SysTotal;
+    item["online"] = o.online;
+    item["interval"] = o.pollInterval;
+    item["polls"] = o.pollCount;
+    item["traps"] = o.trapCount;
+    item["trap_latency"] = printerPublish[slot].trapLatency;
+  }
+
+  return serializeJson(doc, buf, size);
+}
+
+// --- Web 处理函数 (在 httpServerLoop 中调用，只填写响应，不等待客户端) ---
+static bool restartPending = false;  // /save 之后延迟重启，先让响应写出
+static unsigned long restartAt = 0;
+
+// 页面资源：gzip 原样发送，ETag 匹配时返回 304 (见 html_content.h)
+static void handleAsset(const HttpRequest& req, HttpResponse& res) {
+  const WebAsset* asset = (const WebAsset*)req.ctx;
+  res.header("ETag", asset->etag);
+  res.header("Cache-Control", "max-age=" WEB_ASSET_MAX_AGE);
+  if (strcmp(req.ifNoneMatch, asset->etag) == 0) {
+    res.sendStatic(304, nullptr, nullptr, 0);
+    return;
+  }
+  res.header("Content-Encoding", "gzip");
+  res.sendStatic(200, asset->mime, asset->data, asset->len);
+}
+
+// 配置 API：返回当前配置的 JSON
+static void handleConfig(const HttpRequest& req, HttpResponse& res) {
+  StaticJsonDocument<320> doc;  // 栈上分配, 预分配 320 字节
+  char pip[16] = "";
+  char pips[MAX_PRINTERS * 16] = "";  // 其余打印机 IP，逗号分隔
+  for (int slot = 0; slot < printerCount; slot++) {
+    PrinterStatus st;
+    printerStatusRead(slot, st);
+    char ip[16];
+    if (slot == 0) {
+      if (st.ip) ipToStr(IPAddress(st.ip), pip);
+      continue;
+    }
+    if (pips[0]) strlcat(pips, ",", sizeof(pips));
+    strlcat(pips, ipToStr(IPAddress(st.ip), ip), sizeof(pips));
+  }
+  doc["mac"] = (const char*)deviceMAC;
+  doc["ssid"] = cfg_ssid.c_str();
+  doc["pass"] = cfg_pass.c_str();
+  doc["t_ser"] = cfg_target_serial.c_str();  // 目标打印机序列号
+  doc["pip"] = (const char*)pip;
+  doc["pips"] = (const char*)pips;
+  doc["scan_mode"] = cfg_scan_mode;  // 扫描策略
+
+  size_t size;
+  char* json = res.buffer(size);
+  res.commit(200, "application/json", serializeJson(doc, json, size));
+}
+
+// 保存配置 API：保存配置，响应写出后重启
+static void handleSave(const HttpRequest& req, HttpResponse& res) {
+  char value[MAX_PRINTERS * 16];
+  preferences.begin("net_config", false);
+  req.arg("ssid", value, sizeof(value));
+  preferences.putString("ssid", value);   // 保存 WiFi SSID
+  req.arg("pass", value, sizeof(value));
+  preferences.putString("pass", value);   // 保存 WiFi 密码
+  req.arg("t_ser", value, sizeof(value));
+  preferences.putString("t_ser", value);  // 保存目标打印机序列号
+  req.arg("pip", value, sizeof(value));
+  preferences.putString("pip", value);    // 保存打印机 IP 地址
+  req.arg("pips", value, sizeof(value));
+  preferences.putString("pips", value);   // 保存其余打印机 IP (逗号分隔)
+  req.arg("scan_mode", value, sizeof(value));
+  preferences.putUChar("scan_mode", atoi(value) == SCAN_MODE_SNMP ? SCAN_MODE_SNMP : SCAN_MODE_TCP9100);  // 保存扫描策略
+  preferences.end();
+
+  res.send(200, "text/html; charset=utf-8", "Saved! Rebooting...");  // 保存成功，重启设备
+  restartPending = true;  // 由 loop 在 WEB_RESTART_DELAY 后重启，期间 MQTT 与 SNMP 照常运行
+  restartAt = millis() + WEB_RESTART_DELAY;
+}
+
+// 状态 API：返回实时状态数据 (页面改用 /events 推送，保留给脚本与不支持 EventSource 的浏览器)
+static void handleStatus(const HttpRequest& req, HttpResponse& res) {
+  size_t size;
+  char* json = res.buffer(size);
+  res.commit(200, "application/json", renderStatusJson(json, size));
+}
+
+// 状态推送：数据变化时以 SSE 推送与 /status 相同的 JSON (见 web_events.h)
+static void handleEvents(const HttpRequest& req, HttpResponse& res) {
+  if (!webEventsSubscribe(res)) res.send(503, "text/plain", "Too many subscribers");
+}
+
+// 指标 API：Prometheus 文本格式 (SNMP/MQTT/扫描/循环耗时/堆/任务栈，见 metrics.h)
+static void handleMetrics(const HttpRequest& req, HttpResponse& res) {
+  static char text[METRICS_TEXT_MAX];  // 只在 loop 任务中使用
+  static volatile bool sending = false;  // 上一个响应写出前不重新生成
+  if (sending) {
+    res.header("Retry-After", "1");
+    res.send(503, "text/plain", "Busy");
+    return;
+  }
+  size_t len = metricsRender(text, sizeof(text));
+  res.sendStatic(200, "text/plain; version=0.0.4", text, len, &sending);  // 直接写出缓冲，不复制
+}
+
 // --- 初始化 Web 服务器 ---
 void initWebServer() {
-  // 主页：返回配置页面 HTML
-  server.on("/", HTTP_GET, []() {
-    server.send(200, "text/html; charset=utf-8", index_html);
-  });
-
-  // 配置 API：返回当前配置的 JSON
-  server.on("/config", HTTP_GET, []() {
-    StaticJsonDocument<200> doc;  // 栈上分配, 预分配 200 字节
-    doc["mac"] = deviceMAC;
-    doc["ssid"] = cfg_ssid;
-    doc["pass"] = cfg_pass;
-    doc["t_ser"] = cfg_target_serial;  // 目标打印机序列号
-    doc["pip"] = cfg_printer_ip;
-
-    String json;
-    serializeJson(doc, json);
-    server.send(200, "application/json", json);
-  });
-
-  // 保存配置 API：保存配置并重启
-  server.on("/save", HTTP_POST, []() {
-    preferences.begin("net_config", false);
-    preferences.putString("ssid", server.arg("ssid"));    // 保存 WiFi SSID
-    preferences.putString("pass", server.arg("pass"));    // 保存 WiFi 密码
-    preferences.putString("t_ser", server.arg("t_ser"));  // 保存目标打印机序列号
-    preferences.putString("pip", server.arg("pip"));      // 保存打印机 IP 地址
-    preferences.end();
-
-    server.send(200, "text/html; charset=utf-8", "Saved! Rebooting...");  // 保存成功，重启设备
-    delay(500);
-    ESP.restart();  // 重启设备以应用新配置
-  });
-
-  // 状态 API：返回实时状态数据
-  server.on("/status", HTTP_GET, []() {
-    const char* mqttState = mqttClient.connected() ? "Connected" : "Disconnected";
-
-    StaticJsonDocument<400> doc;
-    doc["serial"] = val_PrtSerial;
-    doc["cc"] = val_ColCopies;
-    doc["cp"] = val_ColPrints;
-    doc["ct"] = calc_ColTotal;
-    doc["bc"] = calc_BWCopies;
-    doc["bp"] = calc_BWPrints;
-    doc["bt"] = calc_BWTotal;
-    doc["st"] = val_SysTotal;
-    doc["toner_black"] = val_TonerBlack;
-    doc["toner_cyan"] = val_TonerCyan;
-    doc["toner_red"] = val_TonerRed;
-    doc["toner_yellow"] = val_TonerYellow;
-    doc["msg"] = statusMessage;
-    doc["mqtt_state"] = mqttState;
-    doc["detectedIP"] = cfg_printer_ip;
-
-    String json;
-    serializeJson(doc, json);
-    server.send(200, "application/json", json);
-  });
+  for (size_t i = 0; i < webAssetCount; i++) httpOn(webAssets[i].path, HTTP_METHOD_GET, handleAsset, &webAssets[i]);
+  httpOn("/config", HTTP_METHOD_GET, handleConfig);
+  httpOn("/save", HTTP_METHOD_POST, handleSave);
+  httpOn("/status", HTTP_METHOD_GET, handleStatus);
+  httpOn("/events", HTTP_METHOD_GET, handleEvents);
+  httpOn("/metrics", HTTP_METHOD_GET, handleMetrics);
+  webEventsBegin(renderStatusJson);
 
   // 启动 Web 服务器
-  server.begin();
+  httpServerBegin(80);
   Serial.println("Web 服务器已启动");
 }
 
@@ -178,13 +304,14 @@ void setup() {
   if (preferences.isKey("pass")) {
     cfg_pass = preferences.getString("pass", "");  // WiFi 密码
   }
-  if (preferences.isKey("pip")) {
-    cfg_printer_ip = preferences.getString("pip", "");  // 打印机 IP 地址
-  }
+  String pip = preferences.getString("pip", "");    // 主打印机 IP 地址
+  String pips = preferences.getString("pips", "");  // 其余打印机 IP (逗号分隔)
   if (preferences.isKey("t_ser")) {
     cfg_target_serial = preferences.getString("t_ser", "");  // 目标打印机序列号
   }
+  cfg_scan_mode = preferences.getUChar("scan_mode", SCAN_MODE_TCP9100);  // 扫描策略
   preferences.end();
+  initPrinters(pip, pips);
 
   // 打印机锁定引脚：输出模式，默认低电平（锁定）
   pinMode(PRINTER_LOCK_PIN, OUTPUT);
@@ -198,12 +325,15 @@ void setup() {
   snmp.onMessage(onSNMPMessage);  // 注册 SNMP 消息回调函数
 
   // 步骤 4: 获取设备 MAC 地址
-  deviceMAC = ETH.macAddress();
-  // 检查 MAC 地址是否有效（空字符串或全零地址视为无效）
-  if (deviceMAC.length() == 0 || deviceMAC == "00:00:00:00:00:00") {
-    deviceMAC = WiFi.macAddress();
+  uint8_t mac[6] = {};
+  ETH.macAddress(mac);
+  // 检查 MAC 地址是否有效（全零地址视为无效）
+  static const uint8_t zeroMac[6] = {};
+  if (memcmp(mac, zeroMac, sizeof(mac)) == 0) {
+    WiFi.macAddress(mac);
   }
-  Serial.printf("Device MAC: %s\n", deviceMAC.c_str());
+  snprintf(deviceMAC, sizeof(deviceMAC), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  Serial.printf("Device MAC: %s\n", deviceMAC);
 
   // 步骤 5: 初始化 MQTT 主题字符串（MAC 地址确定后）
   initMQTTTopics();
@@ -219,38 +349,82 @@ void setup() {
     delay(100);
   }
 
+  // 采样时间戳：SNTP 在后台校时，未校时前采样不带时间
+  configTime(0, 0, NTP_SERVER);
+
+  // 断线暂存：上次断线/重启前未确认的采样在连上 MQTT 后回放
+  outboxBegin();
+
   // 步骤 7: 配置 MQTT 服务器
   mqttClient.setServer(MQTT_BROKER, MQTT_PORT);
   mqttClient.setCallback(mqttCallback);
-  mqttClient.setBufferSize(512);  // 默认 256 不足，OID 请求 payload 约 280+ 字节
+  mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
+
+#if TELEMETRY_BENCHMARK
+  telemetryBenchmark();  // 对比 JSON/CBOR 编码
+#endif
+#if SNMP_BENCHMARK
+  snmpBenchmark();  // SNMP 响应语料：分发正确性、耗时、分配次数与模糊测试
+#endif
 
   // 步骤 8: 初始化 Web 服务器
   initWebServer();
 
   // 步骤 9: 判断启动模式
-  // 情况 1: 如果打印机 IP 为空 -> 进入扫描模式
-  // 情况 2: 如果已配置打印机 IP -> 直接连接
+  // 情况 1: 如果主打印机 IP 为空 -> 进入扫描模式
+  // 情况 2: 如果已配置打印机 IP -> 由 printerSNMPLoop 按错开的时间表轮询
   // 扫描模式下会检查 cfg_target_serial (如果配置了就只找那台，没配置就找第一台)
-  if (cfg_printer_ip == "") {
+  if (printers[0].ip[0] == 0) {
     startScan();
-  } else {
-    IPAddress target;
-    target.fromString(cfg_printer_ip);
-    sendSNMPRequest(target);
   }
+
+  // 步骤 10: 启动 SNMP 任务，此后 SNMP/扫描/轮询/看门狗都在该任务中运行
+  profInit();  // 分阶段计时须在两个任务开始计时前初始化
+  snmpTaskStart();
+}
+
+// --- loop 耗时统计 ---
+// 每 60 秒打印一次期间 loop 任务与 SNMP 任务单次循环的最大耗时，连同打印机数与在途请求数，
+// 用于评估单节点在 SNMP_INTERVAL 下能轮询多少台打印机而不拖慢 Web/MQTT 响应；
+// snmp_stack 为 SNMP 任务栈历史最小剩余 (字节)；
+// poll_allocs 为上一次轮询发送期间的 operator new 次数，稳态应为 0；
+// mqtt_stall 为 MQTT 连接状态机单步的最长耗时，broker 不可达时也应保持在几毫秒内；
+// heap 为空闲堆/最大连续块/已分配块数，长时间运行后最大块持续缩小说明有碎片
+static void loopLatencyReport(uint32_t loopUs) {
+  static uint32_t maxUs = 0;
+  static unsigned long lastReport = 0;
+  metricsObserve(HIST_LOOP, loopUs);
+  if (loopUs > maxUs) maxUs = loopUs;
+  if (millis() - lastReport < 60000) return;
+  lastReport = millis();
+  const MqttConnStats& mqtt = mqttConnStats();
+  HeapStats heap = heapStats();
+  Serial.printf("Loop: max %lu us, snmp task max %lu us, snmp_stack=%lu, printers=%d, inflight=%d, poll_allocs=%lu, "
+                "mqtt_stall=%lu us (%lu attempts, %lu failed), heap=%lu/%lu/%lu blocks\n",
+                (unsigned long)maxUs, (unsigned long)snmpTaskTakeMaxUs(), (unsigned long)snmpTaskStackFree(),
+                printerCount, inflightCount(), (unsigned long)pollLastAllocs(),
+                (unsigned long)mqtt.stallMaxUs, (unsigned long)mqtt.attempts, (unsigned long)mqtt.failures,
+                (unsigned long)heap.freeBytes, (unsigned long)heap.largestBlock, (unsigned long)heap.blocks);
+  profReport();
+  simReport();
+  maxUs = 0;
 }
 
 // --- Arduino 主循环函数 ---
 void loop() {
-  server.handleClient();  // 处理 Web 请求
-  snmp.loop();            // 处理 SNMP 消息
+  uint32_t loopStart = micros();
+
+  // SNMP、扫描、轮询与看门狗在 SNMP 任务中运行 (见 snmp_task.h)
+  profBegin(PROF_TASK_LOOP);
+  httpServerLoop();       // 推进 Web 连接 (非阻塞，不等待客户端)
+  webEventsLoop();        // 向 /events 订阅者推送变化
+  if (restartPending && (long)(millis() - restartAt) >= 0) ESP.restart();  // /save 之后重启以应用新配置
+  profStage(STAGE_WEB);
   mqttLoop();             // 处理 MQTT 连接
+  profStage(STAGE_MQTT);
+  ledIndicatorLoop();     // LED 注册/锁机状态指示灯
+  profStage(STAGE_LED);
+  profEnd(PROF_TASK_LOOP);
 
-  if (isScanning) {     // 如果正在扫描模式，执行扫描循环
-    processScanLoop();  // 扫描模式处理
-  }
-
-  printerSNMPLoop();   // 定时 SNMP 请求
-  printerWatchdog();   // 打印机看门狗检测
-  ledIndicatorLoop();  // LED 注册/锁机状态指示灯
+  loopLatencyReport(micros() - loopStart);
 }
@@ -10,150 +10,255 @@
 #include "config.h"
 #include "globals.h"
 #include "snmp_handler.h"
+#include "scanner.h"
+#include "snmp_poll.h"
+#include "printer_snapshot.h"
+#include "sim.h"
+
+// 槽位是否参与轮询：已配置 IP，且主打印机不在扫描中
+static bool isPolled(int slot) {
+  return printers[slot].ip[0] != 0 && !(slot == 0 && isScanning);
+}
+
+// --- 初始化打印机槽位 ---
+// 槽位 0 为主打印机 (pip，为空时扫描锁定)，其余槽位依次取 pips 中的 IP，超出 MAX_PRINTERS 的忽略
+// 首次轮询在 SNMP_INTERVAL 内均匀错开，避免所有打印机的请求同时发出
+void initPrinters(const String& pip, const String& pips) {
+  printers[0].ip.fromString(pip);
+  printerCount = 1;
+
+  int start = 0;
+  while (start < (int)pips.length() && printerCount < MAX_PRINTERS) {
+    int comma = pips.indexOf(',', start);
+    if (comma < 0) comma = pips.length();
+    String item = pips.substring(start, comma);
+    item.trim();
+    start = comma + 1;
+
+    IPAddress ip;
+    if (!ip.fromString(item) || ip == printers[0].ip) continue;
+    printers[printerCount++].ip = ip;
+  }
+
+  unsigned long now = millis();
+  for (int slot = 0; slot < printerCount; slot++) {
+    if (printers[slot].ip[0] != 0) snmpPollPrepare(slot);
+    printers[slot].nextPollAt = now + (unsigned long)SNMP_INTERVAL * slot / printerCount;
+    printers[slot].lastResponseTime = now;
+  }
+  Serial.printf("Monitoring %d printer slot(s)\n", printerCount);
+}
 
 // --- 开始扫描打印机 ---
 // 初始化扫描模式，准备扫描网段内的打印机
 void startScan() {
-  isScanning = true;  // 进入扫描模式
-  scanCurrentIP = 1;  // 从 IP 地址最后一位 1 开始扫描
+  scannerStop();      // 中止上一次未完成的扫描
+  isScanning = true;  // 进入扫描模式，扫描引擎在 processScanLoop 中启动
 
   // 根据是否配置了目标序列号，设置不同的状态消息
-  statusMessage.reserve(50);
   if (cfg_target_serial != "") {
-    statusMessage = "Scanning for Serial: ";
-    statusMessage += cfg_target_serial;
+    setStatusMessage("Scanning for Serial: %s", cfg_target_serial.c_str());
+    Serial.printf("Scanning for Serial: %s\n", cfg_target_serial.c_str());
   } else {
-    statusMessage = "正在扫描打印机...";
+    setStatusMessage("正在扫描打印机...");
+    Serial.println("正在扫描打印机...");
   }
-  Serial.println(statusMessage);
 }
 
 // --- 扫描循环处理 ---
-// 在扫描模式下，批量检查网段内的 IP 地址
+// 在扫描模式下推进扫描引擎（非阻塞，每次 loop 立即返回）
 void processScanLoop() {
   // 如果不在扫描模式，直接返回
   if (!isScanning) return;
 
-  // 获取本地 IP (以太网优先，与 networkPoll 一致)
-  IPAddress local = (ETH.linkUp() && ETH.hasIP()) ? ETH.localIP() : WiFi.localIP();
-
-  // 如果本地 IP 无效，停止扫描
-  if (local[0] == 0) {
-    isScanning = false;
-    return;
-  }
-
-  // 构建子网前缀 (例如: 192.168.1.)
-  String subnet = String(local[0]) + "." + String(local[1]) + "." + String(local[2]) + ".";
+  if (!scannerRunning()) {
+    // 获取本地 IP 与子网掩码 (以太网优先，与 networkPoll 一致)
+    bool useEth = ETH.linkUp() && ETH.hasIP();
+    IPAddress local = useEth ? ETH.localIP() : WiFi.localIP();
+    IPAddress mask = useEth ? ETH.subnetMask() : WiFi.subnetMask();
+#if SIM_ENABLED
+    simNetwork(local, mask);  // 扫描模拟网段
+#endif
 
-  // 批量扫描，每次处理 SCAN_BATCH_SIZE 个 IP
-  for (int i = 0; i < SCAN_BATCH_SIZE; i++) {
-    // 如果扫描到 255，说明整个网段扫描完毕
-    if (scanCurrentIP >= 255) {
+    // 如果本地 IP 无效，停止扫描
+    if (local[0] == 0) {
       isScanning = false;
-      statusMessage = "Not Found";
       return;
     }
 
-    // 跳过自己的 IP 地址
-    if (scanCurrentIP == local[3]) {
-      scanCurrentIP++;
-      continue;
-    }
-
-    // 构建目标 IP 地址
-    String targetIPStr = subnet + String(scanCurrentIP);
-
-    // 步骤 1: 先用 TCP Port 9100 快速过滤 (打印机通常开放此端口)
-    // 这样可以快速排除非打印机设备，减少 SNMP 请求
-    WiFiClient client;
-    if (client.connect(targetIPStr.c_str(), 9100, SCAN_CONNECT_TIMEOUT)) {
-      client.stop();  // 关闭连接，我们只需要确认端口开放
+    // 上次锁定的打印机 IP (看门狗清空槽位 0 后仍保存在 Preferences 中)，优先探测
+    // SNMP 任务使用自己的 Preferences 实例，不与 loop 任务的全局 preferences 交错 begin/end
+    IPAddress lastKnown;
+    Preferences prefs;
+    prefs.begin("net_config", true);
+    lastKnown.fromString(prefs.getString("pip", ""));
+    prefs.end();
 
-      // 步骤 2: 发现 Port 9100 开启 -> 发送 SNMP 查询序列号
-      Serial.print("Checking: ");
-      Serial.println(targetIPStr);
-
-      IPAddress targetIP;
-      targetIP.fromString(targetIPStr);
-      sendSNMPRequest(targetIP);  // 发送 SNMP 请求查询序列号
-    }
+    scannerStart(local, mask, lastKnown, cfg_scan_mode);
+  }
 
-    scanCurrentIP++;  // 移动到下一个 IP
+  // 整个网段扫描完毕仍未锁定
+  if (!scannerLoop()) {
+    isScanning = false;
+    setStatusMessage("Not Found");
   }
 }
 
 // --- 找到打印机后的处理 ---
-// 当扫描到匹配的打印机时调用此函数
-void foundPrinter(String targetIP) {
-  Serial.println("🎉 Printer LOCKED: " + targetIP);
+// 当扫描到匹配的打印机时调用此函数，锁定为主打印机 (槽位 0)
+void foundPrinter(IPAddress target, const char* serial) {
+  char targetIP[16];
+  ipToStr(target, targetIP);
+  Serial.printf("🎉 Printer LOCKED: %s\n", targetIP);
 
   // 将打印机 IP 保存到非易失性存储，重启后仍有效
-  preferences.begin("net_config", false);
-  preferences.putString("pip", targetIP);
-  preferences.end();
+  Preferences prefs;
+  prefs.begin("net_config", false);
+  prefs.putString("pip", targetIP);
+  prefs.end();
 
   // 更新配置和状态
-  cfg_printer_ip = targetIP;
-  statusMessage = "Locked: " + targetIP;
+  PrinterState& p = printers[0];
+  p.ip = target;
+  strlcpy(p.serial, serial, sizeof(p.serial));  // 保存序列号
+  p.lastResponseTime = millis();
+  setStatusMessage("Locked: %s", targetIP);
   isScanning = false;  // 停止扫描模式
+  scannerStop();       // 关闭仍在途的探测连接
 
-  // 立即发送一次完整的 SNMP 请求以更新所有数据
-  IPAddress target;
-  target.fromString(cfg_printer_ip);
-  sendSNMPRequest(target);
+  // 编码轮询 PDU，并立即发送一次完整的 SNMP 请求以更新所有数据
+  snmpPollPrepare(0);
+  pollPrinter(0);
+  p.pollCount++;
+  p.pollInterval = SNMP_INTERVAL;
+  p.pollIdle = 0;
+  p.nextPollAt = millis() + p.pollInterval;
 }
 
 // --- 检查打印机端口 9100 是否开放 ---
 // 用于看门狗检测，判断打印机是否仍然在线
-bool checkPort9100(String ip) {
+bool checkPort9100(IPAddress ip) {
+#if SIM_ENABLED
+  if (simOwns(ip)) {
+    unsigned long delayMs;
+    bool open = simConnect9100(ip, delayMs);
+    delay(delayMs < 200 ? delayMs : 200);  // 与真实连接一样阻塞到结果出现或超时
+    return open;
+  }
+#endif
   WiFiClient client;
   // 尝试连接端口 9100，超时时间 200 毫秒
-  if (client.connect(ip.c_str(), 9100, 200)) {
+  if (client.connect(ip, 9100, 200)) {
     client.stop();  // 关闭连接
     return true;    // 端口开放，打印机可能在线
   }
   return false;  // 端口关闭，打印机可能离线
 }
 
+// 按活跃度计算下一次轮询间隔：SysTotal 较上次排程有变化 (正在打印) 时取最小间隔，
+// 连续 SNMP_IDLE_POLLS 次未变化后每次翻倍直到 SNMP_INTERVAL_MAX (复位后先按当前间隔轮询几次)
+static void adaptInterval(PrinterState& p) {
+  unsigned long interval = p.pollInterval;
+  if (p.val_SysTotal != p.pollSeenSysTotal) {
+    interval = SNMP_INTERVAL_MIN;
+    p.pollIdle = 0;
+  } else if (p.pollIdle < SNMP_IDLE_POLLS) {
+    p.pollIdle++;
+  } else if (interval < SNMP_INTERVAL_MAX) {
+    interval = interval * 2 > SNMP_INTERVAL_MAX ? SNMP_INTERVAL_MAX : interval * 2;
+  }
+  p.pollSeenSysTotal = p.val_SysTotal;
+
+  if (interval != p.pollInterval) {
+    char ip[16];
+    Serial.printf("Poll %s: interval %lu ms (%lu polls)\n", ipToStr(p.ip, ip), interval, (unsigned long)p.pollCount);
+  }
+  p.pollInterval = interval;
+}
+
 // --- 定时 SNMP 请求 ---
+// 每台打印机按自己的 nextPollAt 和自适应间隔查询；每次 loop 最多轮询一台，
+// 到期的打印机从上次的下一个槽位开始轮流获得发送机会，请求在时间上保持错开；
+// 上一个周期还有请求未结束 (响应或超时) 的打印机顺延，保证每个周期的数据能完整发布
 void printerSNMPLoop() {
-  if (isScanning || cfg_printer_ip == "") return;
-
-  // 如果已经锁定打印机 (非扫描模式)，定时发送 SNMP 请求
-  // 每隔 SNMP_INTERVAL 毫秒查询一次打印机数据
-  if (millis() - lastRequestTime > SNMP_INTERVAL) {
-    IPAddress target;
-    target.fromString(cfg_printer_ip);
-    sendSNMPRequest(target);
-    sendTonerRequest(target);
+  static int cursor = 0;
+  unsigned long now = millis();
+
+  for (int n = 0; n < printerCount; n++) {
+    int slot = (cursor + n) % printerCount;
+    PrinterState& p = printers[slot];
+    if (!isPolled(slot) || (long)(now - p.nextPollAt) < 0 || p.pollPending) continue;
+
+    adaptInterval(p);
+    pollPrinter(slot);
+    p.pollCount++;
+    p.nextPollAt = now + p.pollInterval;
+    cursor = slot + 1;
+    return;
+  }
+}
+
+// --- 轮询间隔复位 ---
+// lock/unlock 意味着马上可能有打印任务，所有打印机回到最小间隔并在下一次 loop 起依次轮询
+void printerPollReset() {
+  unsigned long now = millis();
+  for (int slot = 0; slot < printerCount; slot++) {
+    printers[slot].pollInterval = SNMP_INTERVAL_MIN;
+    printers[slot].pollIdle = 0;
+    printers[slot].nextPollAt = now;
   }
 }
 
+// 失联只看已发出但未应答的轮询；空闲间隔不超过 PRINTER_WATCHDOG_TIMEOUT (config.h)，
+// 打印机断开后最迟约 PRINTER_WATCHDOG_TIMEOUT + SNMP_REQUEST_TIMEOUT 即被发现
+bool printerLost(const PrinterState& p, unsigned long now) {
+  return (long)(p.lastRequestTime - p.lastResponseTime) > 0 && now - p.lastRequestTime > SNMP_REQUEST_TIMEOUT
+         && now - p.lastResponseTime > PRINTER_WATCHDOG_TIMEOUT;
+}
+
 // --- 打印机看门狗检测 ---
+// printerLost 时检查 9100 端口：
+// 主打印机离线则重新扫描，固定 IP 的打印机只记录日志，稍后再检查
+// checkPort9100 会阻塞最多 200 毫秒，每次 loop 最多检查一台
 void printerWatchdog() {
-  if (isScanning || cfg_printer_ip == "") return;
-
-  static unsigned long lastSuccessTime = millis();
   unsigned long currentMillis = millis();
 
-  // 如果状态包含 "Online"，更新成功时间
-  if (String(statusMessage).indexOf("Online") >= 0) {
-    lastSuccessTime = currentMillis;
-  }
+  for (int slot = 0; slot < printerCount; slot++) {
+    PrinterState& p = printers[slot];
+    if (!isPolled(slot) || !printerLost(p, currentMillis)) continue;
 
-  // 如果超过 60 秒没有成功响应，执行看门狗检查
-  if (currentMillis - lastSuccessTime > 60000) {
     // 检查打印机端口 9100 是否仍然开放
-    if (checkPort9100(cfg_printer_ip)) {
+    if (checkPort9100(p.ip)) {
       // 端口开放，但 SNMP 可能有问题
-      statusMessage = "Online / SNMP Error";
-      lastSuccessTime = currentMillis;
-    } else {
+      if (slot == 0) setStatusMessage("Online / SNMP Error");
+      p.lastResponseTime = currentMillis;
+    } else if (slot == 0) {
       // 端口关闭，打印机可能离线，重新扫描
-      statusMessage = "Lost connection, rescanning...";
-      cfg_printer_ip = "";  // 清空 IP
-      startScan();          // 重新扫描 (此时会根据保存的序列号查找)
+      setStatusMessage("Lost connection, rescanning...");
+      p.ip = IPAddress();  // 清空 IP
+      startScan();         // 重新扫描 (此时会根据保存的序列号查找)
+    } else {
+      char ip[16];
+      Serial.printf("Printer %s (%s) offline\n", ipToStr(p.ip, ip), p.serial);
+      p.lastResponseTime = currentMillis;
     }
+    return;
+  }
+}
+
+// --- 轮询状态发布 ---
+// 未变化的槽位不写入，Web 与 /events 按需读取
+void printerStatusLoop() {
+  unsigned long now = millis();
+  for (int slot = 0; slot < printerCount; slot++) {
+    const PrinterState& p = printers[slot];
+    PrinterStatus status = {};
+    status.ip = (uint32_t)p.ip;
+    status.online = !printerLost(p, now);
+    status.pollInterval = p.pollInterval;
+    status.pollCount = p.pollCount;
+    status.pollDropped = p.pollDropped;
+    status.trapCount = p.trapCount;
+    printerStatusPublish(slot, status);
   }
 }
@@ -9,6 +9,10 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
+#include "globals.h"
+
+// 按配置初始化打印机槽位（pip 为主打印机 IP，pips 为逗号分隔的其余打印机 IP），并错开首次轮询
+void initPrinters(const String& pip, const String& pips);
 
 // 开始扫描打印机
 void startScan();
@@ -17,15 +21,25 @@ void startScan();
 void processScanLoop();
 
 // 找到打印机后的处理
-void foundPrinter(String targetIP);
+void foundPrinter(IPAddress target, const char* serial);
 
 // 检查打印机端口 9100 是否开放
-bool checkPort9100(String ip);
+bool checkPort9100(IPAddress ip);
 
-// 定时 SNMP 请求
+// 定时 SNMP 请求（多台打印机错开轮询）
 void printerSNMPLoop();
 
-// 打印机看门狗检测
+// 轮询间隔恢复为最小值并立即轮询（收到 lock/unlock 命令时调用）
+void printerPollReset();
+
+// 打印机是否失联：最近一次轮询超过 SNMP_REQUEST_TIMEOUT 仍无响应，且距上次响应超过 PRINTER_WATCHDOG_TIMEOUT
+// 与轮询间隔无关，空闲退避到长间隔时两次轮询之间不算失联
+bool printerLost(const PrinterState& p, unsigned long now);
+
+// 打印机看门狗检测（逐个槽位）
 void printerWatchdog();
 
+// 发布各槽位的轮询状态供 Web 读取 (printer_snapshot.h 的 PrinterStatus，SNMP 任务每次循环调用)
+void printerStatusLoop();
+
 #endif  // PRINTER_MONITOR_H
@@ -0,0 +1,119 @@
+/*
+ * printer_snapshot.cpp - 打印机数据快照实现
+ */
+
+#include "printer_snapshot.h"
+#include <atomic>
+#include "config.h"
+#include "globals.h"
+
+struct SnapshotCell {
+  std::atomic<uint32_t> seq{0};  // 奇数表示正在写入
+  PrinterSnapshot data = { 0, 0, 0, 0, "", 0, 0, 0, 0, 0, -1, -1, -1, -1, 0, 0, 0, 0, 0 };  // 碳粉 -1 = 未读取
+};
+
+struct StatusCell {
+  std::atomic<uint32_t> seq{0};
+  PrinterStatus data = {};
+};
+
+static SnapshotCell cells[MAX_PRINTERS];
+static StatusCell statusCells[MAX_PRINTERS];
+
+// 写者：序号置为奇数后原地写 data，写完调用 seqEnd
+template <typename Cell>
+static uint32_t seqBegin(Cell& cell) {
+  uint32_t seq = cell.seq.load(std::memory_order_relaxed);
+  cell.seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  return seq;
+}
+
+template <typename Cell>
+static void seqEnd(Cell& cell, uint32_t seq) {
+  cell.seq.store(seq + 2, std::memory_order_release);
+}
+
+// 读者：复制到 out，期间有写入则重读
+template <typename Cell, typename T>
+static void seqRead(Cell& cell, T& out) {
+  for (;;) {
+    uint32_t before = cell.seq.load(std::memory_order_acquire);
+    if (before & 1) continue;  // 写入中 (SNMP 任务在另一个核上，几微秒内完成)
+    out = cell.data;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (cell.seq.load(std::memory_order_relaxed) == before) return;
+  }
+}
+
+static int nonNegative(int v) {
+  return v < 0 ? 0 : v;
+}
+
+void printerSnapshotPublish(uint8_t slot) {
+  if (slot >= MAX_PRINTERS) return;
+  PrinterState& p = printers[slot];
+  SnapshotCell& cell = cells[slot];
+  PrinterSnapshot& s = cell.data;
+
+  uint32_t seq = seqBegin(cell);
+
+  s.generation++;
+  s.at = millis();
+  s.polledAt = p.lastRequestTime;
+  // 本周期轮询发出之后才到达的 trap 留给下一个周期，trapAt 只由 SNMP 任务读写
+  bool trapAnswered = p.trapAt != 0 && (long)(s.polledAt - p.trapAt) >= 0;
+  s.trapAt = trapAnswered ? p.trapAt : 0;
+  if (trapAnswered) p.trapAt = 0;
+  strlcpy(s.serial, p.serial, sizeof(s.serial));
+  s.val_SysTotal = p.val_SysTotal;
+  s.val_ColCopies = p.val_ColCopies;
+  s.val_BWCopies = p.val_BWCopies;
+  s.val_ColPrints = p.val_ColPrints;
+  s.val_BWPrints = p.val_BWPrints;
+  s.val_TonerBlack = p.val_TonerBlack;
+  s.val_TonerCyan = p.val_TonerCyan;
+  s.val_TonerRed = p.val_TonerRed;
+  s.val_TonerYellow = p.val_TonerYellow;
+
+  // 汇总，防止负数 (数据异常时的保护)
+  s.calc_ColTotal = nonNegative(p.val_ColPrints + p.val_ColCopies);
+  s.calc_BWTotal = nonNegative(p.val_BWPrints + p.val_BWCopies);
+  s.calc_TotCopies = nonNegative(p.val_ColCopies + p.val_BWCopies);
+  s.calc_BWCopies = nonNegative(p.val_BWCopies);
+  s.calc_BWPrints = nonNegative(p.val_BWPrints);
+
+  seqEnd(cell, seq);
+}
+
+bool printerSnapshotRead(uint8_t slot, PrinterSnapshot& out) {
+  if (slot >= MAX_PRINTERS) return false;
+  seqRead(cells[slot], out);
+  return out.generation != 0;
+}
+
+uint32_t printerSnapshotVersion(uint8_t slot) {
+  if (slot >= MAX_PRINTERS) return 0;
+  return cells[slot].seq.load(std::memory_order_acquire) / 2;  // 写入中为奇数，取整后仍是上一版本
+}
+
+void printerStatusPublish(uint8_t slot, const PrinterStatus& status) {
+  if (slot >= MAX_PRINTERS) return;
+  StatusCell& cell = statusCells[slot];
+  const PrinterStatus& cur = cell.data;  // 只有写者 (本任务) 修改，直接比较
+  if (cur.ip == status.ip && cur.online == status.online && cur.pollInterval == status.pollInterval
+      && cur.pollCount == status.pollCount && cur.pollDropped == status.pollDropped && cur.trapCount == status.trapCount) {
+    return;
+  }
+  uint32_t seq = seqBegin(cell);
+  cell.data = status;
+  seqEnd(cell, seq);
+}
+
+void printerStatusRead(uint8_t slot, PrinterStatus& out) {
+  if (slot >= MAX_PRINTERS) {
+    out = {};
+    return;
+  }
+  seqRead(statusCells[slot], out);
+}
@@ -0,0 +1,72 @@
+/*
+ * printer_snapshot.h - 打印机数据快照 (seqlock)
+ *
+ * SNMP 任务把一个轮询周期的各个响应写入 PrinterState 的 val_* (私有工作副本)，
+ * 该周期的所有请求都收到响应后，才把全部数值连同汇总一次性发布为快照。
+ * MQTT、断线暂存与 Web 只读取快照：计数器与碳粉总是来自同一个轮询周期，不会半新半旧。
+ *
+ * 轮询状态 (IP、是否在线、间隔与计数) 另有一份 PrinterStatus，由 SNMP 任务每次循环发布，
+ * Web 与 /events 不直接读取 SNMP 任务私有的 PrinterState。
+ *
+ * 每个槽位一个序号：写入前置为奇数、写完置为下一个偶数；读者复制后序号未变且为偶数即为一致副本，
+ * 否则重读。写者只有 SNMP 任务，从不等待读者；读者无需加锁
+ */
+
+#ifndef PRINTER_SNAPSHOT_H
+#define PRINTER_SNAPSHOT_H
+
+#include <Arduino.h>
+
+struct PrinterSnapshot {
+  uint32_t generation;     // 已发布的完整轮询周期数，0 表示尚无数据
+  unsigned long at;        // 发布时间 (millis)
+  unsigned long polledAt;  // 本周期发出轮询请求的时间 (millis)
+  unsigned long trapAt;    // 本周期轮询之前到达、由本快照结束计时的 trap 时间 (millis)，0 表示无
+  char serial[32];         // 打印机序列号
+
+  // SNMP 读取的原始数值
+  int val_SysTotal;
+  int val_ColCopies;
+  int val_BWCopies;
+  int val_ColPrints;
+  int val_BWPrints;
+  int val_TonerBlack;  // 碳粉余量 (%)，-1 表示未读取
+  int val_TonerCyan;
+  int val_TonerRed;
+  int val_TonerYellow;
+
+  // 计算得出的数值 (不小于 0)
+  int calc_ColTotal;   // 彩色总打印数 = 彩色打印 + 彩色复印
+  int calc_BWTotal;    // 黑白总打印数 = 黑白打印 + 黑白复印
+  int calc_TotCopies;  // 总复印数 = 彩色复印 + 黑白复印
+  int calc_BWCopies;   // 黑白复印数
+  int calc_BWPrints;   // 黑白打印数
+};
+
+// 槽位的轮询状态 (不随轮询周期，反映 SNMP 任务最近一次循环时的状态)
+struct PrinterStatus {
+  uint32_t ip;                 // 打印机 IP (IPAddress 的 32 位值)，0 表示未配置/未锁定
+  bool online;                 // 没有失联 (见 printerLost)
+  unsigned long pollInterval;  // 当前轮询间隔 (毫秒)
+  uint32_t pollCount;          // 累计轮询次数
+  uint32_t pollDropped;        // 有请求超时或响应不完整、未发布快照的轮询周期数
+  uint32_t trapCount;          // 收到的 trap/inform 数
+};
+
+// SNMP 任务：一个轮询周期的响应全部到齐后，由 PrinterState 的当前值发布快照；
+// 轮询之前到达的 trap 时间随快照交给读者，PrinterState 中的 trapAt 随即清零
+void printerSnapshotPublish(uint8_t slot);
+
+// 任意任务：读取槽位的最新快照，尚无数据时返回 false
+bool printerSnapshotRead(uint8_t slot, PrinterSnapshot& out);
+
+// 任意任务：槽位快照的版本号 (每次发布递增，不复制快照)，用于判断数据是否变化
+uint32_t printerSnapshotVersion(uint8_t slot);
+
+// SNMP 任务：发布槽位的轮询状态，与上次相同时不写入
+void printerStatusPublish(uint8_t slot, const PrinterStatus& status);
+
+// 任意任务：读取槽位的轮询状态
+void printerStatusRead(uint8_t slot, PrinterStatus& out);
+
+#endif  // PRINTER_SNAPSHOT_H
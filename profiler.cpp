@@ -0,0 +1,164 @@
+/*
+ * profiler.cpp - 分阶段循环耗时剖析实现
+ *
+ * 计时全程以 CPU 周期为单位，直方图的桶边界与预算在 profInit 中换算成周期，热路径上没有除法；
+ * 周期计数器按核心独立，两个任务各自固定在一个核心上，同一任务内的差值有效；
+ * 32 位计数器在 240 MHz 下约 17.9 秒回绕，同时记下 millis()，间隔接近回绕时钳位到 UINT32_MAX (计入最高桶)
+ */
+
+#include "profiler.h"
+
+const uint32_t profHistBounds[PROF_HIST_BUCKETS - 1] = { 10, 100, 1000, 10000, 100000, 1000000 };
+
+#if PROFILE_ENABLED
+
+struct StageDef {
+  const char* name;
+  ProfTask task;
+};
+
+// 顺序与 ProfStage 一致
+static const StageDef stageDefs[STAGE_COUNT] = {
+  { "web", PROF_TASK_LOOP },
+  { "mqtt", PROF_TASK_LOOP },
+  { "led", PROF_TASK_LOOP },
+  { "snmp_cmd", PROF_TASK_SNMP },
+  { "snmp_recv", PROF_TASK_SNMP },
+  { "snmp_timeout", PROF_TASK_SNMP },
+  { "scan", PROF_TASK_SNMP },
+  { "poll", PROF_TASK_SNMP },
+  { "watchdog", PROF_TASK_SNMP },
+};
+
+static const char* const taskNames[PROF_TASK_COUNT] = { "loop", "snmp" };
+static const uint32_t taskBudgetUs[PROF_TASK_COUNT] = { PROFILE_LOOP_BUDGET_US, PROFILE_SNMP_BUDGET_US };
+
+struct StageStats {
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+  uint32_t overBudget;
+  uint32_t hist[PROF_HIST_BUCKETS];
+};
+
+struct TaskState {
+  uint32_t start;                // 本次循环开始的周期数
+  uint32_t mark;                 // 上一个标记的周期数
+  unsigned long startMs;         // 本次循环开始的 millis()，用于识别周期计数器回绕
+  unsigned long markMs;          // 上一个标记的 millis()
+  uint32_t cycles[STAGE_COUNT];  // 本次循环各阶段耗时 (只用本任务的阶段)
+  uint8_t worst;                 // 本次循环最耗时的阶段
+  uint32_t overruns;             // 超预算的循环数
+  unsigned long lastLog;         // 上次输出超预算日志的时间 (限流)
+};
+
+static StageStats stats[STAGE_COUNT];
+static TaskState tasks[PROF_TASK_COUNT];
+static uint32_t cyclesPerUs = 0;
+static uint32_t histCycles[PROF_HIST_BUCKETS - 1];
+static uint32_t budgetCycles[PROF_TASK_COUNT];
+static unsigned long wrapMs;  // 周期计数器回绕一次的毫秒数
+
+// from 到 now 的周期数；经过的毫秒数接近回绕 (差 1 ms 以内也算，millis 与周期计数不是同时读取) 时钳位
+static uint32_t elapsedCycles(uint32_t from, unsigned long fromMs, uint32_t now, unsigned long nowMs) {
+  if (nowMs - fromMs + 1 >= wrapMs) return UINT32_MAX;
+  return now - from;
+}
+
+void profInit() {
+  cyclesPerUs = ESP.getCpuFreqMHz();
+  if (cyclesPerUs == 0) cyclesPerUs = 240;
+  for (uint8_t i = 0; i < PROF_HIST_BUCKETS - 1; i++) histCycles[i] = profHistBounds[i] * cyclesPerUs;
+  for (uint8_t i = 0; i < PROF_TASK_COUNT; i++) budgetCycles[i] = taskBudgetUs[i] * cyclesPerUs;
+  wrapMs = UINT32_MAX / cyclesPerUs / 1000;
+  for (StageStats& s : stats) s.minCycles = UINT32_MAX;
+}
+
+void profBegin(ProfTask task) {
+  if (cyclesPerUs == 0) return;
+  TaskState& t = tasks[task];
+  t.start = t.mark = ESP.getCycleCount();
+  t.startMs = t.markMs = millis();
+  t.worst = STAGE_COUNT;
+}
+
+void profStage(ProfStage stage) {
+  if (cyclesPerUs == 0) return;
+  TaskState& t = tasks[stageDefs[stage].task];
+  uint32_t now = ESP.getCycleCount();
+  unsigned long nowMs = millis();
+  uint32_t cycles = elapsedCycles(t.mark, t.markMs, now, nowMs);
+  t.mark = now;
+  t.markMs = nowMs;
+  t.cycles[stage] = cycles;
+  if (t.worst == STAGE_COUNT || cycles > t.cycles[t.worst]) t.worst = stage;
+
+  StageStats& s = stats[stage];
+  s.count++;
+  s.totalCycles += cycles;
+  if (cycles < s.minCycles) s.minCycles = cycles;
+  if (cycles > s.maxCycles) s.maxCycles = cycles;
+  uint8_t b = 0;
+  while (b < PROF_HIST_BUCKETS - 1 && cycles > histCycles[b]) b++;
+  s.hist[b]++;
+}
+
+void profEnd(ProfTask task) {
+  if (cyclesPerUs == 0) return;
+  TaskState& t = tasks[task];
+  uint32_t total = elapsedCycles(t.start, t.startMs, ESP.getCycleCount(), millis());
+  if (total <= budgetCycles[task] || t.worst == STAGE_COUNT) return;
+
+  t.overruns++;
+  stats[t.worst].overBudget++;
+
+  // 每秒最多输出一次，避免持续超预算时串口本身拖慢循环
+  unsigned long now = millis();
+  if (now - t.lastLog < 1000) return;
+  t.lastLog = now;
+  char detail[160];
+  size_t n = 0;
+  detail[0] = '\0';
+  for (uint8_t i = 0; i < STAGE_COUNT && n < sizeof(detail); i++) {
+    if (stageDefs[i].task != task) continue;
+    int w = snprintf(detail + n, sizeof(detail) - n, "%s%s %lu", n ? ", " : "", stageDefs[i].name,
+                     (unsigned long)(t.cycles[i] / cyclesPerUs));
+    if (w < 0) break;
+    n += w;
+  }
+  Serial.printf("⚠️ %s over budget: %lu us <- %s (%s; %lu overruns)\n", taskNames[task],
+                (unsigned long)(total / cyclesPerUs), stageDefs[t.worst].name, detail, (unsigned long)t.overruns);
+}
+
+bool profStageInfo(uint8_t stage, ProfStageInfo& out) {
+  if (stage >= STAGE_COUNT || cyclesPerUs == 0) return false;
+  const StageStats& s = stats[stage];
+  out.name = stageDefs[stage].name;
+  out.count = s.count;
+  out.minUs = s.count ? s.minCycles / cyclesPerUs : 0;
+  out.maxUs = s.maxCycles / cyclesPerUs;
+  out.totalUs = s.totalCycles / cyclesPerUs;
+  out.overBudget = s.overBudget;
+  memcpy(out.hist, s.hist, sizeof(out.hist));
+  return true;
+}
+
+uint32_t profOverruns(ProfTask task) {
+  return tasks[task].overruns;
+}
+
+void profReport() {
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+    ProfStageInfo info;
+    if (!profStageInfo(i, info) || info.count == 0) continue;
+    Serial.printf("Stage %-12s n=%lu min %lu avg %lu max %lu us, over_budget=%lu, hist[%lu %lu %lu %lu %lu %lu %lu]\n",
+                  info.name, (unsigned long)info.count, (unsigned long)info.minUs,
+                  (unsigned long)(info.totalUs / info.count), (unsigned long)info.maxUs,
+                  (unsigned long)info.overBudget, (unsigned long)info.hist[0], (unsigned long)info.hist[1],
+                  (unsigned long)info.hist[2], (unsigned long)info.hist[3], (unsigned long)info.hist[4],
+                  (unsigned long)info.hist[5], (unsigned long)info.hist[6]);
+  }
+}
+
+#endif  // PROFILE_ENABLED
@@ -0,0 +1,87 @@
+/*
+ * profiler.h - 分阶段循环耗时剖析
+ *
+ * loop 任务与 SNMP 任务的每次循环按阶段计时 (CPU 周期计数器，读一次只需一条指令)，
+ * 每个阶段累计次数、最小/最大耗时与按数量级分桶的直方图。单次循环超过预算
+ * (PROFILE_LOOP_BUDGET_US / PROFILE_SNMP_BUDGET_US) 时，把超时记到本次循环中最耗时的阶段，
+ * 并在串口输出各阶段耗时，用于定位现场偶发的数百毫秒停顿。
+ *
+ * 用法 (每个任务的循环)：
+ *   profBegin(PROF_TASK_LOOP);
+ *   httpServerLoop(); profStage(STAGE_WEB);
+ *   mqttLoop();            profStage(STAGE_MQTT);
+ *   profEnd(PROF_TASK_LOOP);
+ * profStage 记录的是自上一个标记 (profBegin 或上一个 profStage) 以来的耗时。
+ * 每个阶段只由所属任务写入；其他任务读取时可能与写入交错，读数仅供诊断
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+enum ProfTask : uint8_t {
+  PROF_TASK_LOOP,  // Arduino loop 任务：Web、MQTT、LED
+  PROF_TASK_SNMP,  // SNMP 任务：命令、收包、超时、扫描、轮询、看门狗
+  PROF_TASK_COUNT,
+};
+
+enum ProfStage : uint8_t {
+  // loop 任务
+  STAGE_WEB,   // httpServerLoop + webEventsLoop
+  STAGE_MQTT,  // mqttLoop
+  STAGE_LED,   // ledIndicatorLoop
+  // SNMP 任务
+  STAGE_SNMP_CMD,       // 处理 loop 任务投递的命令
+  STAGE_SNMP_RECV,      // snmp.loop
+  STAGE_SNMP_TIMEOUT,   // snmpRequestLoop
+  STAGE_SCAN,           // processScanLoop
+  STAGE_POLL,           // printerSNMPLoop
+  STAGE_WATCHDOG,       // printerWatchdog
+  STAGE_COUNT,
+};
+
+#define PROF_HIST_BUCKETS 7  // <=10us, <=100us, <=1ms, <=10ms, <=100ms, <=1s, >1s
+
+// 单个阶段的统计 (耗时均为微秒)
+struct ProfStageInfo {
+  const char* name;
+  uint32_t count;       // 计时次数
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t overBudget;  // 作为超预算循环中最耗时阶段的次数
+  uint32_t hist[PROF_HIST_BUCKETS];
+};
+
+// 直方图各桶上限 (微秒)，最后一桶无上限
+extern const uint32_t profHistBounds[PROF_HIST_BUCKETS - 1];
+
+#if PROFILE_ENABLED
+// 读取 CPU 频率并换算桶边界与预算，在任何任务开始计时前 (setup 中) 调用一次
+void profInit();
+
+void profBegin(ProfTask task);
+void profStage(ProfStage stage);
+void profEnd(ProfTask task);
+
+// 读取阶段统计，stage 越界返回 false
+bool profStageInfo(uint8_t stage, ProfStageInfo& out);
+
+// 各任务超预算的循环数
+uint32_t profOverruns(ProfTask task);
+
+// 串口输出各阶段统计 (每分钟随 Loop 行输出)
+void profReport();
+#else
+inline void profInit() {}
+inline void profBegin(ProfTask) {}
+inline void profStage(ProfStage) {}
+inline void profEnd(ProfTask) {}
+inline bool profStageInfo(uint8_t, ProfStageInfo&) { return false; }
+inline uint32_t profOverruns(ProfTask) { return 0; }
+inline void profReport() {}
+#endif
+
+#endif  // PROFILER_H
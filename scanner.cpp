@@ -0,0 +1,375 @@
+/*
+ * scanner.cpp - 网段扫描引擎实现
+ *
+ * 两种策略（cfg_scan_mode 选择）：
+ * - SCAN_MODE_TCP9100：同时保持 SCAN_WINDOW 个非阻塞 connect 在途，用零超时 select 轮询完成情况，
+ *   连接成功 (9100 开放) -> 发送 SNMP 序列号查询；连接被拒绝或超时 -> 关闭套接字，补充下一个地址
+ * - SCAN_MODE_SNMP：不做 TCP 预过滤，先向定向广播地址发一次序列号查询，再按 SCAN_BURST_SIZE /
+ *   SCAN_BURST_INTERVAL 节奏逐个单播，响应统一由 onSNMPMessage 异步收集
+ *
+ * 扫描范围取自接口子网掩码（不再写死 /24），候选地址按可能性排序：
+ * 上次锁定的打印机 IP -> ARP 表中的邻居 -> 上次 IP 附近的地址 -> 其余地址顺序遍历
+ */
+
+#include <lwip/sockets.h>
+#include <lwip/etharp.h>
+#include <lwip/tcpip.h>
+#include "scanner.h"
+#include "config.h"
+#include "snmp_handler.h"
+#include "metrics.h"
+#include "sim.h"
+
+// --- 在途连接槽位 ---
+struct ScanSlot {
+  int fd;                   // 套接字，-1 表示空闲
+  IPAddress ip;             // 目标地址
+  unsigned long startedAt;  // 发起连接的时间
+#if SIM_ENABLED
+  bool sim;                 // 模拟网段的地址，没有真实套接字
+  bool simOpen;             // 模拟连接结果
+  unsigned long simDelay;   // 模拟结果出现前的耗时 (ULONG_MAX = 只会超时)
+#endif
+};
+
+#if SIM_ENABLED
+#define SIM_SLOT_FD 0x7FFF  // 模拟槽位的占用标记 (非真实套接字，不参与 select/close)
+#endif
+
+static ScanSlot slots[SCAN_WINDOW];
+static bool running = false;
+static int mode = SCAN_MODE_TCP9100;   // 本次扫描使用的策略
+// --- 候选地址生成（主机字节序，按阶段依次产出，位图去重）---
+enum ScanPhase {
+  PHASE_PRIORITY,  // 上次锁定 IP + ARP 表
+  PHASE_NEARBY,    // 上次 IP 附近 ±SCAN_NEARBY_RADIUS
+  PHASE_SWEEP,     // 其余地址顺序遍历
+  PHASE_DONE,
+};
+
+static uint32_t selfAddr = 0;       // 本机地址
+static uint32_t netAddr = 0;        // 扫描范围起点 (网络地址)
+static uint32_t hostCount = 0;      // 扫描范围内可用主机数 (不含网络/广播地址)
+static uint32_t anchorAddr = 0;     // 附近扫描的中心 (上次 IP，没有则为本机)
+static uint8_t visited[(SCAN_MAX_HOSTS + 7) / 8];
+static uint32_t priority[1 + ARP_TABLE_SIZE];
+static int priorityCount = 0;
+static ScanPhase phase = PHASE_PRIORITY;
+static uint32_t cursor = 0;         // 当前阶段内的位置
+static uint32_t retryAddr = 0;      // 套接字不足时留到下一轮的地址
+static unsigned long startedAt = 0;    // 扫描开始时间
+static unsigned long drainedAt = 0;    // 所有地址探测完毕的时间，0 表示尚未完成
+static unsigned long lastBurstAt = 0;  // 上一批 SNMP 探测的发送时间
+static ScanStats stats = {};
+
+// 关闭一个槽位；abort 为 true 时发送 RST，避免已建立的连接进入 TIME_WAIT 占用 PCB
+static void closeSlot(ScanSlot& slot, bool abort) {
+  if (slot.fd < 0) return;
+#if SIM_ENABLED
+  if (slot.sim) {
+    slot.sim = false;
+    slot.fd = -1;
+    return;
+  }
+#endif
+  if (abort) {
+    struct linger lg = { 1, 0 };
+    setsockopt(slot.fd, SOL_SOCKET, SO_LINGER, &lg, sizeof(lg));
+  }
+  close(slot.fd);
+  slot.fd = -1;
+}
+
+// 对 ip:9100 发起非阻塞连接；只有套接字用尽时返回 false (地址留到下一轮重试)，
+// connect 立即失败的地址按端口关闭计为已探测，槽位保持空闲
+static bool openSlot(ScanSlot& slot, IPAddress ip) {
+#if SIM_ENABLED
+  if (simOwns(ip)) {
+    slot.sim = true;
+    slot.simOpen = simConnect9100(ip, slot.simDelay);
+    slot.fd = SIM_SLOT_FD;
+    slot.ip = ip;
+    slot.startedAt = millis();
+    stats.hostsProbed++;
+    return true;
+  }
+#endif
+  int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) return false;  // 套接字用尽，下一轮再试
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(9100);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+
+  int rc = connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+  if (rc < 0 && errno != EINPROGRESS) {
+    close(fd);
+    stats.hostsProbed++;  // 不重试，否则持续失败的地址会让扫描停在原地
+    return true;
+  }
+  slot.fd = fd;
+  slot.ip = ip;
+  slot.startedAt = millis();
+  stats.hostsProbed++;
+  return true;
+}
+
+// 槽位持有真实套接字 (模拟槽位不参与 select)
+static bool realSocket(const ScanSlot& slot) {
+#if SIM_ENABLED
+  if (slot.sim) return false;
+#endif
+  return slot.fd >= 0;
+}
+
+static uint32_t toHostOrder(IPAddress ip) {
+  return ((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+}
+
+static IPAddress fromHostOrder(uint32_t addr) {
+  return IPAddress(addr >> 24, (addr >> 16) & 0xFF, (addr >> 8) & 0xFF, addr & 0xFF);
+}
+
+static IPAddress broadcastAddr() {
+  return fromHostOrder(netAddr + hostCount + 1);
+}
+
+// 地址在扫描范围内且未探测过时标记并返回 true
+static bool claim(uint32_t addr) {
+  if (addr <= netAddr || addr > netAddr + hostCount || addr == selfAddr) return false;
+  uint32_t idx = addr - netAddr - 1;
+  if (visited[idx / 8] & (1 << (idx % 8))) return false;
+  visited[idx / 8] |= 1 << (idx % 8);
+  return true;
+}
+
+// 根据接口地址/掩码计算扫描范围；超过 SCAN_MAX_HOSTS 时只扫描本机所在的那一段
+static void planRange(IPAddress local, IPAddress mask) {
+  selfAddr = toHostOrder(local);
+  uint32_t m = toHostOrder(mask);
+  if (m == 0 || ((~m + 1) & ~m) || ~m < 3) m = 0xFFFFFF00;  // 掩码无效或 /31、/32 时按 /24 处理
+  uint32_t maxMask = ~(uint32_t)(SCAN_MAX_HOSTS + 1);
+  if (m < maxMask) m = maxMask;
+  netAddr = selfAddr & m;
+  hostCount = (~m) - 1;
+}
+
+// 收集高优先级候选：上次锁定的打印机 IP、ARP 表中同网段的邻居
+static void planPriority(IPAddress lastKnown) {
+  priorityCount = 0;
+  uint32_t last = toHostOrder(lastKnown);
+  anchorAddr = selfAddr;
+  if (last > netAddr && last <= netAddr + hostCount) {
+    priority[priorityCount++] = last;
+    anchorAddr = last;
+  }
+
+  LOCK_TCPIP_CORE();
+  for (size_t i = 0; i < ARP_TABLE_SIZE && priorityCount < (int)(sizeof(priority) / sizeof(priority[0])); i++) {
+    ip4_addr_t* ip;
+    struct netif* netif;
+    struct eth_addr* eth;
+    if (etharp_get_entry(i, &ip, &netif, &eth)) {
+      priority[priorityCount++] = lwip_ntohl(ip4_addr_get_u32(ip));
+    }
+  }
+  UNLOCK_TCPIP_CORE();
+}
+
+// 取下一个待探测地址，扫描范围已遍历完返回 false
+static bool nextCandidate(IPAddress& out) {
+  if (retryAddr) {
+    out = fromHostOrder(retryAddr);
+    retryAddr = 0;
+    return true;
+  }
+  while (phase != PHASE_DONE) {
+    uint32_t addr = 0;
+    switch (phase) {
+      case PHASE_PRIORITY:
+        if ((int)cursor < priorityCount) {
+          addr = priority[cursor++];
+        } else {
+          phase = PHASE_NEARBY;
+          cursor = 0;
+        }
+        break;
+      case PHASE_NEARBY:
+        // 依次产出 anchor+1, anchor-1, anchor+2, anchor-2 ...
+        if (cursor < 2 * SCAN_NEARBY_RADIUS) {
+          uint32_t step = cursor / 2 + 1;
+          addr = (cursor++ % 2) ? anchorAddr - step : anchorAddr + step;
+        } else {
+          phase = PHASE_SWEEP;
+          cursor = 0;
+        }
+        break;
+      case PHASE_SWEEP:
+        if (cursor < hostCount) {
+          addr = netAddr + 1 + cursor++;
+        } else {
+          phase = PHASE_DONE;
+        }
+        break;
+      default:
+        break;
+    }
+    if (addr && claim(addr)) {
+      out = fromHostOrder(addr);
+      return true;
+    }
+  }
+  return false;
+}
+
+// 端口 9100 开放 -> 发送 SNMP 查询序列号
+static void onPortOpen(IPAddress ip) {
+  stats.portOpen++;
+  Serial.print("Checking: ");
+  Serial.println(ip);
+  sendSNMPRequest(ip);
+}
+
+// --- TCP 9100 策略：补满窗口并收集已完成的连接，全部探测完毕返回 true ---
+static bool tcpStep(unsigned long now) {
+  // 步骤 1: 补满窗口
+  int inFlight = 0;
+  bool exhausted = false;
+  for (ScanSlot& slot : slots) {
+    if (slot.fd < 0 && !exhausted) {
+      IPAddress ip;
+      if (nextCandidate(ip)) {
+        if (!openSlot(slot, ip)) retryAddr = toHostOrder(ip);  // 套接字用尽，地址留到下一轮
+      } else {
+        exhausted = true;
+      }
+    }
+    if (slot.fd >= 0) inFlight++;
+  }
+  if (inFlight > stats.peakInFlight) stats.peakInFlight = inFlight;
+  if (inFlight == 0) return exhausted;
+
+#if SIM_ENABLED
+  // 模拟连接：到达设定耗时即完成
+  for (ScanSlot& slot : slots) {
+    if (!slot.sim || now - slot.startedAt < slot.simDelay) continue;
+    IPAddress ip = slot.ip;
+    bool open = slot.simOpen;
+    closeSlot(slot, open);
+    if (open) onPortOpen(ip);
+  }
+#endif
+
+  // 步骤 2: 零超时 select，收集已完成的连接
+  fd_set wfds, efds;
+  FD_ZERO(&wfds);
+  FD_ZERO(&efds);
+  int maxfd = -1;
+  for (ScanSlot& slot : slots) {
+    if (!realSocket(slot)) continue;
+    FD_SET(slot.fd, &wfds);
+    FD_SET(slot.fd, &efds);
+    if (slot.fd > maxfd) maxfd = slot.fd;
+  }
+  struct timeval tv = { 0, 0 };
+  int ready = select(maxfd + 1, NULL, &wfds, &efds, &tv);
+
+  for (ScanSlot& slot : slots) {
+    if (slot.fd < 0) continue;
+    if (ready > 0 && realSocket(slot) && (FD_ISSET(slot.fd, &wfds) || FD_ISSET(slot.fd, &efds))) {
+      int err = 0;
+      socklen_t len = sizeof(err);
+      getsockopt(slot.fd, SOL_SOCKET, SO_ERROR, &err, &len);
+      IPAddress ip = slot.ip;
+      closeSlot(slot, err == 0);
+      if (err == 0) onPortOpen(ip);
+    } else if (now - slot.startedAt > SCAN_CONNECT_TIMEOUT) {
+      closeSlot(slot, false);  // 超时：主机不存在或端口被过滤
+    }
+  }
+  return false;
+}
+
+// --- SNMP 突发策略：按节奏发送一批序列号查询，全部发送完毕返回 true ---
+static bool burstStep(unsigned long now) {
+  if (stats.hostsProbed > 0 && now - lastBurstAt < SCAN_BURST_INTERVAL) return false;
+  lastBurstAt = now;
+
+  // 第一批前先试一次定向广播，支持的 agent 会直接应答
+  if (stats.hostsProbed == 0) {
+    sendSNMPRequest(broadcastAddr());
+  }
+  for (int i = 0; i < SCAN_BURST_SIZE; i++) {
+    IPAddress ip;
+    if (!nextCandidate(ip)) return true;
+    sendSNMPRequest(ip);
+    stats.hostsProbed++;
+  }
+  return false;
+}
+
+void scannerStart(IPAddress local, IPAddress mask, IPAddress lastKnown, int scanMode) {
+  scannerStop();
+  for (ScanSlot& slot : slots) slot.fd = -1;
+  planRange(local, mask);
+  planPriority(lastKnown);
+  memset(visited, 0, sizeof(visited));
+  phase = PHASE_PRIORITY;
+  cursor = 0;
+  retryAddr = 0;
+  mode = scanMode;
+  startedAt = millis();
+  drainedAt = 0;
+  stats = {};
+  running = true;
+  Serial.printf("Scan range: %s + %lu hosts, %d priority candidates\n",
+                fromHostOrder(netAddr).toString().c_str(), (unsigned long)hostCount, priorityCount);
+}
+
+bool scannerLoop() {
+  if (!running) return false;
+  unsigned long now = millis();
+
+  bool exhausted = drainedAt != 0 || (mode == SCAN_MODE_SNMP ? burstStep(now) : tcpStep(now));
+
+  // 全部地址探测完毕后，再等待一段时间接收迟到的 SNMP 响应
+  if (exhausted) {
+    if (drainedAt == 0) {
+      drainedAt = now;
+      stats.durationMs = now - startedAt;
+    }
+    if (now - drainedAt > SCAN_REPLY_GRACE) {
+      running = false;
+      metricsScanDone(stats.durationMs);
+      Serial.printf("Scan done (%s): %u hosts, %u open, %u replies in %lu ms (%.1f hosts/s)\n",
+                    mode == SCAN_MODE_SNMP ? "snmp" : "9100",
+                    stats.hostsProbed, stats.portOpen, stats.snmpReplies, stats.durationMs,
+                    stats.durationMs ? stats.hostsProbed * 1000.0f / stats.durationMs : 0.0f);
+      return false;
+    }
+  }
+  return true;
+}
+
+void scannerNoteReply() {
+  if (running) stats.snmpReplies++;
+}
+
+void scannerStop() {
+  if (!running) return;
+  for (ScanSlot& slot : slots) closeSlot(slot, true);
+  running = false;
+  if (drainedAt == 0) stats.durationMs = millis() - startedAt;
+  metricsScanDone(stats.durationMs);
+  Serial.printf("Scan stopped: %u hosts probed in %lu ms\n", stats.hostsProbed, stats.durationMs);
+}
+
+bool scannerRunning() {
+  return running;
+}
+
+const ScanStats& scannerStats() {
+  return stats;
+}
@@ -0,0 +1,42 @@
+/*
+ * scanner.h - 网段扫描引擎
+ *
+ * 以固定窗口并发发起非阻塞 TCP 9100 连接，或直接按节奏突发 SNMP 序列号查询；
+ * 扫描范围取自子网掩码，候选地址按可能性排序；每次 loop 只推进一步，不阻塞主循环
+ */
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <Arduino.h>
+
+// --- 扫描统计（最近一次扫描）---
+struct ScanStats {
+  unsigned long durationMs;  // 扫描耗时 (毫秒)
+  uint16_t hostsProbed;      // 已探测主机数
+  uint16_t portOpen;         // 9100 开放的主机数
+  uint16_t snmpReplies;      // 扫描期间收到的 SNMP 响应数
+  uint16_t peakInFlight;     // 同时在途连接数峰值
+};
+
+// 开始扫描本机所在网段
+// local/mask 为接口地址与子网掩码，lastKnown 为上次锁定的打印机 IP (没有则为 0.0.0.0)
+// scanMode 为 SCAN_MODE_TCP9100 / SCAN_MODE_SNMP
+void scannerStart(IPAddress local, IPAddress mask, IPAddress lastKnown, int scanMode);
+
+// 推进扫描一步（非阻塞），返回 false 表示整个网段已扫描完毕
+bool scannerLoop();
+
+// 记录一次扫描期间收到的 SNMP 响应（由 onSNMPMessage 调用）
+void scannerNoteReply();
+
+// 中止扫描并关闭所有在途连接（锁定打印机或重新扫描时调用）
+void scannerStop();
+
+// 扫描引擎是否在运行
+bool scannerRunning();
+
+// 最近一次扫描统计
+const ScanStats& scannerStats();
+
+#endif  // SCANNER_H
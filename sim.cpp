@@ -0,0 +1,278 @@
+/*
+ * sim.cpp - 模拟网段与端到端基准实现
+ *
+ * 每个地址的角色 (不存在 / 9100 关闭 / 9100 开放 / Ricoh agent) 由主机号哈希按比例确定，
+ * 同一配置下每次运行都相同，前后两次基准可直接对比。
+ * 请求只在 SNMP 任务中发出、响应也在 SNMP 任务中投递，队列不需要加锁
+ */
+
+#include "sim.h"
+
+#if SIM_ENABLED
+
+#include <climits>
+#include <SNMP.h>
+#include "globals.h"
+#include "oid_table.h"
+#include "snmp_handler.h"
+#include "snmp_pdu.h"
+#include "scanner.h"
+#include "metrics.h"
+#include "alloc_stats.h"
+#include "mqtt_conn.h"
+#include "printer_snapshot.h"
+
+#define SIM_VARBINDS 6                     // Ricoh 合并请求只返回前 6 项
+#define SIM_OID_MAX 48                     // 点分 OID 最大长度
+#define SIM_END_OID "1.3.6.1.6.3.15.1.1.1.0"  // GetNext/GetBulk 的应答：打印机 MIB 之后的 OID，遍历立即结束
+
+static_assert(SIM_PREFIX_LEN >= 22 && SIM_PREFIX_LEN <= 30, "SIM_PREFIX_LEN 需在 22 (扫描上限) 到 30 之间");
+
+enum SimRole : uint8_t {
+  SIM_ROLE_NONE,    // 地址无主机：连接超时，SNMP 无应答
+  SIM_ROLE_CLOSED,  // 主机存在，9100 拒绝连接
+  SIM_ROLE_OPEN,    // 9100 开放，SNMP 无应答 (非 Ricoh 或 community 不符)
+  SIM_ROLE_AGENT,   // 9100 开放，应答 SNMP 的 Ricoh 打印机
+};
+
+struct SimResponse {
+  bool used;
+  unsigned long dueAt;  // 投递时间 (millis)
+  IPAddress from;
+  int32_t requestId;
+  uint8_t version;
+  uint8_t pduType;
+  uint8_t count;
+  char oids[SIM_VARBINDS][SIM_OID_MAX];
+};
+
+static SimResponse queue[SIM_QUEUE];
+static uint32_t netAddr = 0;   // 网络地址 (主机字节序)
+static uint32_t hostMask = 0;  // 主机位掩码
+static uint32_t dropped = 0;   // 队列满丢弃的响应数
+
+static uint32_t toHostOrder(IPAddress ip) {
+  return ((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+}
+
+static IPAddress fromHostOrder(uint32_t addr) {
+  return IPAddress(addr >> 24, (addr >> 16) & 0xFF, (addr >> 8) & 0xFF, addr & 0xFF);
+}
+
+static void plan() {
+  if (hostMask) return;
+  IPAddress net;
+  net.fromString(SIM_NET);
+  hostMask = (1u << (32 - SIM_PREFIX_LEN)) - 1;
+  netAddr = toHostOrder(net) & ~hostMask;
+}
+
+static uint32_t selfHost() {
+  return hostMask - 1;
+}
+
+// 主机号 -> 角色：哈希后依次按三个比例取舍
+static SimRole roleOf(uint32_t host) {
+  if (host == 0 || host >= hostMask || host == selfHost()) return SIM_ROLE_NONE;
+  uint32_t r = host * 2654435761u;
+  r ^= r >> 15;
+  r *= 2246822519u;
+  r ^= r >> 13;
+  if (r % 100 >= SIM_HOST_PERCENT) return SIM_ROLE_NONE;
+  r /= 100;
+  if (r % 100 >= SIM_OPEN_9100_PERCENT) return SIM_ROLE_CLOSED;
+  r /= 100;
+  return r % 100 < SIM_AGENT_PERCENT ? SIM_ROLE_AGENT : SIM_ROLE_OPEN;
+}
+
+void simNetwork(IPAddress& local, IPAddress& mask) {
+  plan();
+  local = fromHostOrder(netAddr + selfHost());
+  mask = fromHostOrder(~hostMask);
+}
+
+bool simOwns(IPAddress ip) {
+  plan();
+  return (toHostOrder(ip) & ~hostMask) == netAddr;
+}
+
+bool simConnect9100(IPAddress ip, unsigned long& delayMs) {
+  SimRole role = roleOf(toHostOrder(ip) & hostMask);
+  delayMs = role == SIM_ROLE_NONE ? ULONG_MAX : SIM_CONNECT_LATENCY_MS;
+  return role == SIM_ROLE_OPEN || role == SIM_ROLE_AGENT;
+}
+
+// --- 请求解析 (只需支持 snmpEncodeRequest 的输出) ---
+// 读取一个 TLV，value/len 为内容，p 前进到下一个 TLV
+static bool berRead(const uint8_t*& p, const uint8_t* end, uint8_t& tag, const uint8_t*& value, size_t& len) {
+  if (end - p < 2) return false;
+  tag = *p++;
+  size_t n = *p++;
+  if (n & 0x80) {
+    uint8_t bytes = n & 0x7F;
+    if (bytes == 0 || bytes > 2 || end - p < bytes) return false;
+    n = 0;
+    while (bytes--) n = (n << 8) | *p++;
+  }
+  if ((size_t)(end - p) < n) return false;
+  value = p;
+  len = n;
+  p += n;
+  return true;
+}
+
+static int32_t berInt(const uint8_t* v, size_t len) {
+  uint32_t x = (len && (v[0] & 0x80)) ? UINT32_MAX : 0;
+  for (size_t i = 0; i < len; i++) x = (x << 8) | v[i];
+  return (int32_t)x;
+}
+
+static bool berOid(const uint8_t* v, size_t len, char* out, size_t size) {
+  if (len == 0) return false;
+  size_t n = snprintf(out, size, "%u.%u", v[0] / 40, v[0] % 40);
+  uint32_t arc = 0;
+  for (size_t i = 1; i < len && n < size; i++) {
+    arc = (arc << 7) | (v[i] & 0x7F);
+    if (v[i] & 0x80) continue;
+    n += snprintf(out + n, size - n, ".%lu", (unsigned long)arc);
+    arc = 0;
+  }
+  return n < size;
+}
+
+static bool parseRequest(const uint8_t* buf, size_t len, SimResponse& r) {
+  const uint8_t* p = buf;
+  const uint8_t* end = buf + len;
+  const uint8_t* v;
+  size_t n;
+  uint8_t tag;
+  if (!berRead(p, end, tag, v, n) || tag != 0x30) return false;
+  p = v;
+  end = v + n;
+  if (!berRead(p, end, tag, v, n) || tag != 0x02) return false;
+  r.version = berInt(v, n);
+  if (!berRead(p, end, tag, v, n) || tag != 0x04) return false;  // community
+  if (!berRead(p, end, tag, v, n)) return false;
+  r.pduType = tag;
+  p = v;
+  end = v + n;
+  if (!berRead(p, end, tag, v, n) || tag != 0x02) return false;
+  r.requestId = berInt(v, n);
+  if (!berRead(p, end, tag, v, n) || !berRead(p, end, tag, v, n)) return false;  // error-status/index
+  if (!berRead(p, end, tag, v, n) || tag != 0x30) return false;
+  p = v;
+  end = v + n;
+  r.count = 0;
+  while (p < end && r.count < SIM_VARBINDS) {
+    const uint8_t* vb;
+    size_t vbLen;
+    if (!berRead(p, end, tag, vb, vbLen) || tag != 0x30) return false;
+    const uint8_t* q = vb;
+    if (!berRead(q, vb + vbLen, tag, v, n) || tag != 0x06) return false;
+    if (!berOid(v, n, r.oids[r.count], SIM_OID_MAX)) return false;
+    r.count++;
+  }
+  return true;
+}
+
+// 登记一个待投递的响应，队列满时丢弃
+static void enqueue(const SimResponse& req, uint32_t host) {
+  for (SimResponse& slot : queue) {
+    if (slot.used) continue;
+    slot = req;
+    slot.used = true;
+    slot.from = fromHostOrder(netAddr + host);
+    slot.dueAt = millis() + SIM_AGENT_LATENCY_MS + host % 4;  // 各 agent 略有差异，避免响应同时到达
+    return;
+  }
+  dropped++;
+}
+
+bool simSnmpSend(IPAddress target, const uint8_t* buf, size_t len) {
+  SimResponse req;
+  if (!parseRequest(buf, len, req)) return false;
+  uint32_t host = toHostOrder(target) & hostMask;
+  if (host == hostMask) {
+    // 定向广播：所有 agent 都应答
+    for (uint32_t h = 1; h < hostMask; h++) {
+      if (roleOf(h) == SIM_ROLE_AGENT) enqueue(req, h);
+    }
+  } else if (roleOf(host) == SIM_ROLE_AGENT) {
+    enqueue(req, host);
+  }
+  return true;  // 与 UDP 一样，无主机的地址也视为发送成功
+}
+
+// --- 模拟 Ricoh agent 的取值 ---
+// 计数器按启动以来的时间增长，各分项按固定比例拆分总数；奇数主机以 OctetString 返回碳粉
+static SNMP::BER* agentValue(uint32_t host, const char* oid) {
+  const OidEntry* e = oidLookup(oid);
+  if (!e) return new SNMP::NullBER();
+  if (e->kind == OID_KIND_SERIAL) {
+    char serial[16];
+    snprintf(serial, sizeof(serial), "SIM%04lu", (unsigned long)host);
+    return new SNMP::OctetStringBER(serial);
+  }
+  if (e->kind == OID_KIND_COUNTER) {
+    int total = host * 1000 + (int)((uint64_t)millis() * SIM_PAGES_PER_MIN / 60000);
+    int value = total;
+    if (e->dest == &PrinterState::val_ColCopies) value = total / 10;
+    else if (e->dest == &PrinterState::val_BWCopies) value = total / 5;
+    else if (e->dest == &PrinterState::val_ColPrints) value = total * 3 / 10;
+    else if (e->dest == &PrinterState::val_BWPrints) value = total - total / 10 - total / 5 - total * 3 / 10;
+    return new SNMP::IntegerBER(value);
+  }
+  int level = 100 - (int)((host * 7 + (e - oidTable) * 13) % 90);
+  if (host & 1) {
+    char text[8];
+    snprintf(text, sizeof(text), "%d", level);
+    return new SNMP::OctetStringBER(text);
+  }
+  return new SNMP::IntegerBER(level);
+}
+
+void simLoop() {
+  unsigned long now = millis();
+  for (SimResponse& r : queue) {
+    if (!r.used || (long)(now - r.dueAt) < 0) continue;
+    uint32_t host = toHostOrder(r.from) & hostMask;
+    SNMP::Message msg(r.version, "public", SNMP::Type::GetResponse);
+    msg.setRequestID(r.requestId);
+    if (r.pduType == SNMP_PDU_GETNEXT || r.pduType == SNMP_PDU_GETBULK) {
+      msg.add(SIM_END_OID, new SNMP::IntegerBER(0));
+    } else {
+      for (uint8_t i = 0; i < r.count; i++) msg.add(r.oids[i], agentValue(host, r.oids[i]));
+    }
+    // 回调中可能立即发出下一个请求，本项投递完才释放，新请求进入其他空位
+    onSNMPMessage(&msg, r.from, SNMP::Port::SNMP);
+    r.used = false;
+  }
+}
+
+// --- 基准行 ---
+// 扫描统计与快照代数由 SNMP 任务写入，这里只读，偶尔读到半更新的扫描统计不影响对比
+void simReport() {
+  static uint32_t prevCycles = 0, prevSnmpBytes = 0, prevMqttBytes = 0, prevAllocs = 0;
+  uint32_t cycles = 0;
+  for (int slot = 0; slot < printerCount; slot++) {
+    PrinterSnapshot s;
+    if (printerSnapshotRead(slot, s)) cycles += s.generation;
+  }
+  uint32_t snmpBytes = snmpBytesSent();
+  uint32_t mqttBytes = mqttConnStats().bytesOut;
+  uint32_t allocs = allocCount();
+  uint32_t n = cycles - prevCycles;
+  const ScanStats& scan = scannerStats();
+  Serial.printf("Sim: scan %lu ms (%u hosts, %u open, %u replies), cycles=%lu, poll->publish p50 %lu p99 %lu ms, "
+                "per cycle: snmp_tx=%lu B, mqtt_tx=%lu B, allocs=%lu, dropped=%lu\n",
+                scan.durationMs, scan.hostsProbed, scan.portOpen, scan.snmpReplies, (unsigned long)n,
+                (unsigned long)metricsQuantile(HIST_POLL_PUBLISH, 0.5f), (unsigned long)metricsQuantile(HIST_POLL_PUBLISH, 0.99f),
+                (unsigned long)(n ? (snmpBytes - prevSnmpBytes) / n : 0), (unsigned long)(n ? (mqttBytes - prevMqttBytes) / n : 0),
+                (unsigned long)(n ? (allocs - prevAllocs) / n : 0), (unsigned long)dropped);
+  prevCycles = cycles;
+  prevSnmpBytes = snmpBytes;
+  prevMqttBytes = mqttBytes;
+  prevAllocs = allocs;
+}
+
+#endif  // SIM_ENABLED
@@ -0,0 +1,46 @@
+/*
+ * sim.h - 模拟网段与端到端基准
+ *
+ * SIM_ENABLED 为 1 时，固件把 SIM_NET 当作本机网段：扫描、9100 检测与发往该网段的 SNMP 请求
+ * 都不经过网络，由这里按配置的主机比例、9100 开放比例与 Ricoh agent 比例确定性地模拟应答。
+ * 模拟 agent 解析固件自己编码的请求 PDU，延迟 SIM_AGENT_LATENCY_MS 后构造 GetResponse 交给 onSNMPMessage，
+ * 计数器随时间增长 (SIM_PAGES_PER_MIN)，部分 agent 以 OctetString 返回碳粉，
+ * 合并请求与真机一样只返回前 6 项。MQTT 仍连接真实 broker (或测试机上的本地 broker)。
+ *
+ * 每分钟随 Loop 行在串口输出一行 Sim：最近一次扫描耗时、轮询到发布的 p50/p99、
+ * 每个完整轮询周期的 SNMP/MQTT 发送字节数与 C++ 堆分配次数，性能改动前后对比这一行即可
+ *
+ * 只在设备上运行 (不进入 host/ 主机构建)：基准数值须来自真实的 lwIP、FreeRTOS 调度与堆分配器
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#if SIM_ENABLED
+// 模拟网段的本机地址与掩码 (替代接口地址，供扫描使用)
+void simNetwork(IPAddress& local, IPAddress& mask);
+
+// 地址是否属于模拟网段 (含广播地址)
+bool simOwns(IPAddress ip);
+
+// 模拟 9100 连接：返回端口是否开放，delayMs 为连接结果出现前的耗时
+// (地址无主机时为 ULONG_MAX，连接只会超时)
+bool simConnect9100(IPAddress ip, unsigned long& delayMs);
+
+// 接收发往模拟网段的 SNMP 请求 (由 snmpSendRaw 转入)，请求无法解析时返回 false
+bool simSnmpSend(IPAddress target, const uint8_t* buf, size_t len);
+
+// SNMP 任务：投递到期的模拟响应
+void simLoop();
+
+// 串口输出基准行 (每分钟随 Loop 行调用，数值为两次调用之间的增量)
+void simReport();
+#else
+inline void simLoop() {}
+inline void simReport() {}
+#endif
+
+#endif  // SIM_H
@@ -0,0 +1,428 @@
+/*
+ * snmp_bench.cpp - SNMP 响应语料基准与模糊测试实现
+ *
+ * 语料按 Ricoh 实际返回的形态整理 (值与类型见各条注释)，以 SNMP::Message 构造后直接交给分发与格式化，
+ * 不经过 UDP 与 SNMP 库的解码；构造消息的分配次数单独列出，近似于库解码同一响应的分配。
+ * 模糊测试的变异保持 OID 为点分数字 (与库解码的输出一致)，值的类型、数值与字符串内容任意
+ */
+
+#include "snmp_bench.h"
+#include "config.h"
+
+#if SNMP_BENCHMARK
+
+#include <SNMP.h>
+#include "globals.h"
+#include "oid_table.h"
+#include "snmp_varbind.h"
+#include "alloc_stats.h"
+
+#define BENCH_SENTINEL -7777       // 分发前各字段的初值，未命中的字段应保持不变
+#define BENCH_SENTINEL_SERIAL "-"
+#define BENCH_MAX_VARBINDS 8
+#define BENCH_OID_MAX 64
+#define BENCH_FAIL_LOG 10          // 最多输出的失败详情条数
+
+enum BenchType : uint8_t {
+  BV_INT,
+  BV_STR,
+  BV_COUNTER32,
+  BV_GAUGE32,
+  BV_TICKS,
+  BV_COUNTER64,
+  BV_OID,
+  BV_IP,
+  BV_NULL,
+  BV_COUNT,
+};
+
+struct BenchVarbind {
+  const char* oid;
+  BenchType type;
+  int64_t num;
+  const char* str;  // BV_STR / BV_OID
+};
+
+struct BenchExpect {
+  int PrinterState::*field;
+  int value;
+};
+
+struct BenchCase {
+  const char* name;
+  const BenchVarbind* varbinds;
+  uint8_t count;
+  const char* serial;  // 期望的序列号，nullptr 表示不应改变
+  const BenchExpect* expect;
+  uint8_t expectCount;
+};
+
+#define LEN(a) (uint8_t)(sizeof(a) / sizeof(a[0]))
+
+// --- 语料 ---
+// 合并请求：序列号 + 5 个计数器 (Ricoh 合并请求只返回前 6 项)
+static const BenchVarbind vbCounters[] = {
+  { OID_PRT_SERIAL, BV_STR, 0, "E123M456789" },
+  { OID_SYS_TOTAL, BV_INT, 1234567, nullptr },
+  { OID_COL_COPIES, BV_INT, 23456, nullptr },
+  { OID_BW_COPIES, BV_INT, 345678, nullptr },
+  { OID_COL_PRINTS, BV_INT, 45678, nullptr },
+  { OID_BW_PRINTS, BV_INT, 567890, nullptr },
+};
+static const BenchExpect exCounters[] = {
+  { &PrinterState::val_SysTotal, 1234567 }, { &PrinterState::val_ColCopies, 23456 }, { &PrinterState::val_BWCopies, 345678 },
+  { &PrinterState::val_ColPrints, 45678 }, { &PrinterState::val_BWPrints, 567890 },
+};
+
+// 碳粉以 Integer 返回：-3 = 有余量但不可测，-100 = 未知 (原样上报)
+static const BenchVarbind vbTonerInt[] = {
+  { OID_TONER_BLACK, BV_INT, 80, nullptr },
+  { OID_TONER_CYAN, BV_INT, 60, nullptr },
+  { OID_TONER_RED, BV_INT, -3, nullptr },
+  { OID_TONER_YELLOW, BV_INT, -100, nullptr },
+};
+static const BenchExpect exTonerInt[] = {
+  { &PrinterState::val_TonerBlack, 80 }, { &PrinterState::val_TonerCyan, 60 },
+  { &PrinterState::val_TonerRed, -3 }, { &PrinterState::val_TonerYellow, -100 },
+};
+
+// 碳粉以 OctetString 返回 (部分机型)
+static const BenchVarbind vbTonerStr[] = {
+  { OID_TONER_BLACK, BV_STR, 0, "85" },
+  { OID_TONER_CYAN, BV_STR, 0, "40" },
+  { OID_TONER_RED, BV_STR, 0, "0" },
+  { OID_TONER_YELLOW, BV_STR, 0, "100" },
+};
+static const BenchExpect exTonerStr[] = {
+  { &PrinterState::val_TonerBlack, 85 }, { &PrinterState::val_TonerCyan, 40 },
+  { &PrinterState::val_TonerRed, 0 }, { &PrinterState::val_TonerYellow, 100 },
+};
+
+// 带实例后缀的 OID：最多 2 段后缀命中，3 段不命中
+static const BenchVarbind vbSuffixed[] = {
+  { OID_PRT_SERIAL ".0", BV_STR, 0, "S-SUFFIX" },
+  { OID_SYS_TOTAL ".0", BV_INT, 42, nullptr },
+  { OID_COL_COPIES ".1.0", BV_INT, 7, nullptr },
+  { OID_BW_COPIES ".1.2.3", BV_INT, 9, nullptr },
+};
+static const BenchExpect exSuffixed[] = {
+  { &PrinterState::val_SysTotal, 42 }, { &PrinterState::val_ColCopies, 7 },
+};
+
+// 其他数值类型：Counter32/Gauge32 接受，Counter64/TimeTicks 不作为计数器
+static const BenchVarbind vbTypes[] = {
+  { OID_SYS_TOTAL, BV_COUNTER32, 4000000000LL, nullptr },
+  { OID_COL_COPIES, BV_GAUGE32, 12, nullptr },
+  { OID_BW_COPIES, BV_COUNTER64, 99, nullptr },
+  { OID_COL_PRINTS, BV_TICKS, 5, nullptr },
+  { OID_BW_PRINTS, BV_INT, -1, nullptr },
+};
+static const BenchExpect exTypes[] = {
+  { &PrinterState::val_SysTotal, (int)4000000000u }, { &PrinterState::val_ColCopies, 12 }, { &PrinterState::val_BWPrints, -1 },
+};
+
+// v1 错误响应 (noSuchName)：原样回显请求，值均为 NULL
+static const BenchVarbind vbV1Error[] = {
+  { OID_PRT_SERIAL, BV_NULL, 0, nullptr },
+  { OID_SYS_TOTAL, BV_NULL, 0, nullptr },
+  { OID_COL_COPIES, BV_NULL, 0, nullptr },
+  { OID_BW_COPIES, BV_NULL, 0, nullptr },
+  { OID_COL_PRINTS, BV_NULL, 0, nullptr },
+  { OID_BW_PRINTS, BV_NULL, 0, nullptr },
+};
+
+// 现场见过的异常值：类型不符、非数字字符串、空串、未知 OID
+static const BenchVarbind vbOdd[] = {
+  { OID_PRT_SERIAL, BV_INT, 5, nullptr },
+  { OID_TONER_BLACK, BV_STR, 0, "OK" },
+  { OID_TONER_CYAN, BV_STR, 0, "" },
+  { "1.3.6.1.2.1.1.5.0", BV_STR, 0, "host" },
+  { OID_TONER_RED, BV_OID, 0, "1.3.6.1" },
+  { OID_SYS_TOTAL, BV_STR, 0, " 123abc" },
+};
+static const BenchExpect exOdd[] = {
+  { &PrinterState::val_TonerBlack, 0 }, { &PrinterState::val_TonerCyan, 0 }, { &PrinterState::val_SysTotal, 123 },
+};
+
+// 超长序列号截断到 31 字节
+static const BenchVarbind vbLongSerial[] = {
+  { OID_PRT_SERIAL, BV_STR, 0, "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcdefghijklmnopqrstuvwxyz" },
+};
+
+static const BenchCase corpus[] = {
+  { "counters", vbCounters, LEN(vbCounters), "E123M456789", exCounters, LEN(exCounters) },
+  { "toner_int", vbTonerInt, LEN(vbTonerInt), nullptr, exTonerInt, LEN(exTonerInt) },
+  { "toner_str", vbTonerStr, LEN(vbTonerStr), nullptr, exTonerStr, LEN(exTonerStr) },
+  { "suffixed", vbSuffixed, LEN(vbSuffixed), "S-SUFFIX", exSuffixed, LEN(exSuffixed) },
+  { "types", vbTypes, LEN(vbTypes), nullptr, exTypes, LEN(exTypes) },
+  { "v1_error", vbV1Error, LEN(vbV1Error), nullptr, nullptr, 0 },
+  { "odd", vbOdd, LEN(vbOdd), nullptr, exOdd, LEN(exOdd) },
+  { "long_serial", vbLongSerial, LEN(vbLongSerial), "ABCDEFGHIJKLMNOPQRSTUVWXYZ01234", nullptr, 0 },
+};
+
+static SNMP::BER* makeValue(BenchType type, int64_t num, const char* str) {
+  switch (type) {
+    case BV_INT: return new SNMP::IntegerBER((int32_t)num);
+    case BV_STR: return new SNMP::OctetStringBER(str);
+    case BV_COUNTER32: return new SNMP::Counter32BER((uint32_t)num);
+    case BV_GAUGE32: return new SNMP::Gauge32BER((uint32_t)num);
+    case BV_TICKS: return new SNMP::TimeTicksBER((uint32_t)num);
+    case BV_COUNTER64: return new SNMP::Counter64BER((uint64_t)num);
+    case BV_OID: return new SNMP::ObjectIdentifierBER(str);
+    case BV_IP: return new SNMP::IPAddressBER(IPAddress((uint32_t)num));
+    default: return new SNMP::NullBER();
+  }
+}
+
+static void resetState(PrinterState& p) {
+  strlcpy(p.serial, BENCH_SENTINEL_SERIAL, sizeof(p.serial));
+  for (size_t i = 0; i < oidTableSize; i++) {
+    if (oidTable[i].dest) p.*(oidTable[i].dest) = BENCH_SENTINEL;
+  }
+}
+
+// --- 1. 语料正确性 ---
+static int checkCase(const BenchCase& c) {
+  SNMP::Message msg(SNMP::Version::V1, "public", SNMP::Type::GetResponse);
+  for (uint8_t i = 0; i < c.count; i++) msg.add(c.varbinds[i].oid, makeValue(c.varbinds[i].type, c.varbinds[i].num, c.varbinds[i].str));
+  PrinterState p;
+  resetState(p);
+  snmpApplyVarbinds(p, msg.getVarBindList());
+
+  int failures = 0;
+  const char* serial = c.serial ? c.serial : BENCH_SENTINEL_SERIAL;
+  if (strcmp(p.serial, serial) != 0) {
+    Serial.printf("❌ SNMP corpus %s: serial \"%s\", want \"%s\"\n", c.name, p.serial, serial);
+    failures++;
+  }
+  for (size_t i = 0; i < oidTableSize; i++) {
+    if (!oidTable[i].dest) continue;
+    int want = BENCH_SENTINEL;
+    for (uint8_t e = 0; e < c.expectCount; e++) {
+      if (c.expect[e].field == oidTable[i].dest) want = c.expect[e].value;
+    }
+    int got = p.*(oidTable[i].dest);
+    if (got != want) {
+      Serial.printf("❌ SNMP corpus %s: %s = %d, want %d\n", c.name, oidTable[i].oid, got, want);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+// --- 2. 耗时与分配次数 ---
+static void benchCase(const BenchCase& c) {
+  const int rounds = 1000;
+  uint32_t allocs = allocCount();
+  SNMP::Message msg(SNMP::Version::V1, "public", SNMP::Type::GetResponse);
+  for (uint8_t i = 0; i < c.count; i++) msg.add(c.varbinds[i].oid, makeValue(c.varbinds[i].type, c.varbinds[i].num, c.varbinds[i].str));
+  uint32_t buildAllocs = allocCount() - allocs;
+
+  SNMP::VarBindList* list = msg.getVarBindList();
+  PrinterState p;
+  allocs = allocCount();
+  uint32_t start = micros();
+  for (int r = 0; r < rounds; r++) snmpApplyVarbinds(p, list);
+  uint32_t applyUs = micros() - start;
+
+  char value[SNMP_VALUE_MAX];
+  start = micros();
+  for (int r = 0; r < rounds; r++) {
+    for (unsigned int i = 0; i < list->count(); i++) snmpValueFormat((*list)[i]->getValue(), value, sizeof(value));
+  }
+  uint32_t formatUs = micros() - start;
+  uint32_t runAllocs = allocCount() - allocs;
+
+  float nsPerVarbind = 1000.0f / ((float)rounds * c.count);
+  Serial.printf("SNMP bench %-11s %u varbinds: apply %.0f ns/varbind, format %.0f ns/varbind, build %lu allocs/msg, "
+                "apply+format %.2f allocs/msg\n",
+                c.name, c.count, applyUs * nsPerVarbind, formatUs * nsPerVarbind, (unsigned long)buildAllocs,
+                runAllocs / (float)rounds);
+}
+
+// --- 3. 差分模糊测试 ---
+struct FuzzVarbind {
+  char oid[BENCH_OID_MAX];
+  BenchType type;
+  int64_t num;
+  char str[SNMP_VALUE_MAX + 64];  // 超过格式化缓冲，覆盖截断路径
+};
+
+static FuzzVarbind fuzz[BENCH_MAX_VARBINDS];
+static uint8_t fuzzCount = 0;
+static uint32_t seed = 1;  // 本次运行的种子，失败时与轮次一起输出以便复现
+static uint32_t rng = 1;
+
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+// 参考实现：逐个去掉最后一段 (最多 2 段)，与表中 OID 逐字符串比较
+static const OidEntry* refLookup(const char* name) {
+  char buf[BENCH_OID_MAX];
+  strlcpy(buf, name, sizeof(buf));
+  for (int strip = 0; strip <= 2; strip++) {
+    if (strip > 0) {
+      char* dot = strrchr(buf, '.');
+      if (!dot) break;
+      *dot = '\0';
+    }
+    for (size_t i = 0; i < oidTableSize; i++) {
+      if (strcmp(buf, oidTable[i].oid) == 0) return &oidTable[i];
+    }
+  }
+  return nullptr;
+}
+
+static void refApply(PrinterState& p) {
+  for (uint8_t i = 0; i < fuzzCount; i++) {
+    const FuzzVarbind& vb = fuzz[i];
+    const OidEntry* e = refLookup(vb.oid);
+    if (!e) continue;
+    if (e->kind == OID_KIND_SERIAL) {
+      if (vb.type == BV_STR) strlcpy(p.serial, vb.str, sizeof(p.serial));
+      continue;
+    }
+    switch (vb.type) {
+      case BV_STR: p.*(e->dest) = atoi(vb.str); break;
+      case BV_INT: p.*(e->dest) = (int32_t)vb.num; break;
+      case BV_COUNTER32:
+      case BV_GAUGE32: p.*(e->dest) = (int)(uint32_t)vb.num; break;
+      default: break;
+    }
+  }
+}
+
+// 点分 OID 的变异：截断到某一段、追加一段、改一位数字、换成表中的 OID
+static void mutateOid(char* oid) {
+  size_t len = strlen(oid);
+  switch (nextRandom() % 4) {
+    case 0: {
+      char* dot = strrchr(oid, '.');
+      if (dot && dot != oid) *dot = '\0';
+      break;
+    }
+    case 1:
+      if (len + 8 < BENCH_OID_MAX) snprintf(oid + len, BENCH_OID_MAX - len, ".%lu", (unsigned long)(nextRandom() % 1000));
+      break;
+    case 2: {
+      if (len == 0) break;
+      size_t pos = nextRandom() % len;
+      if (oid[pos] >= '0' && oid[pos] <= '9') oid[pos] = '0' + nextRandom() % 10;
+      break;
+    }
+    default:
+      strlcpy(oid, oidTable[nextRandom() % oidTableSize].oid, BENCH_OID_MAX);
+      break;
+  }
+}
+
+static void mutate() {
+  int k = 1 + nextRandom() % 3;
+  while (k--) {
+    FuzzVarbind& vb = fuzz[nextRandom() % fuzzCount];
+    switch (nextRandom() % 6) {
+      case 0:
+        mutateOid(vb.oid);
+        break;
+      case 1:
+        vb.type = (BenchType)(nextRandom() % BV_COUNT);
+        if (vb.type == BV_OID) strlcpy(vb.str, oidTable[nextRandom() % oidTableSize].oid, sizeof(vb.str));
+        break;
+      case 2:
+        vb.num = (int64_t)(((uint64_t)nextRandom() << 32) | nextRandom());
+        if (nextRandom() & 1) vb.num = (int32_t)vb.num;
+        break;
+      case 3: {
+        if (vb.type == BV_OID) break;
+        size_t n = nextRandom() % sizeof(vb.str);
+        for (size_t i = 0; i < n; i++) vb.str[i] = 1 + nextRandom() % 255;
+        vb.str[n] = '\0';
+        break;
+      }
+      case 4:
+        if (fuzzCount < BENCH_MAX_VARBINDS) fuzz[fuzzCount++] = vb;
+        break;
+      default:
+        if (fuzzCount > 1) {
+          uint8_t drop = nextRandom() % fuzzCount;
+          fuzz[drop] = fuzz[--fuzzCount];
+        }
+        break;
+    }
+  }
+}
+
+static void logFuzzCase(uint32_t round) {
+  Serial.printf("   round %lu (seed %lu):\n", (unsigned long)round, (unsigned long)seed);
+  for (uint8_t i = 0; i < fuzzCount; i++) {
+    Serial.printf("   %s type=%u num=%lld str[%u]\n", fuzz[i].oid, fuzz[i].type, (long long)fuzz[i].num, (unsigned)strlen(fuzz[i].str));
+  }
+}
+
+// 格式化结果必须以 NUL 结尾、长度与返回值一致且不写出 size 之外
+static bool checkFormat(SNMP::BER* value) {
+  static const size_t sizes[] = { 1, 7, SNMP_VALUE_MAX };
+  char out[SNMP_VALUE_MAX + 1];
+  for (size_t size : sizes) {
+    memset(out, 0x5A, sizeof(out));
+    size_t n = snmpValueFormat(value, out, size);
+    if (n >= size || out[size] != 0x5A || strlen(out) != n) return false;
+  }
+  return true;
+}
+
+static int fuzzCorpus() {
+  int failures = 0;
+  seed = SNMP_FUZZ_SEED ? SNMP_FUZZ_SEED : esp_random() | 1;
+  rng = seed;
+  for (uint32_t round = 0; round < SNMP_FUZZ_ROUNDS; round++) {
+    const BenchCase& c = corpus[nextRandom() % (sizeof(corpus) / sizeof(corpus[0]))];
+    fuzzCount = c.count;
+    for (uint8_t i = 0; i < c.count; i++) {
+      strlcpy(fuzz[i].oid, c.varbinds[i].oid, BENCH_OID_MAX);
+      fuzz[i].type = c.varbinds[i].type;
+      fuzz[i].num = c.varbinds[i].num;
+      strlcpy(fuzz[i].str, c.varbinds[i].str ? c.varbinds[i].str : "", sizeof(fuzz[i].str));
+    }
+    mutate();
+
+    SNMP::Message msg(SNMP::Version::V1, "public", SNMP::Type::GetResponse);
+    for (uint8_t i = 0; i < fuzzCount; i++) msg.add(fuzz[i].oid, makeValue(fuzz[i].type, fuzz[i].num, fuzz[i].str));
+    SNMP::VarBindList* list = msg.getVarBindList();
+
+    PrinterState got, want;
+    resetState(got);
+    resetState(want);
+    snmpApplyVarbinds(got, list);
+    refApply(want);
+
+    bool ok = strcmp(got.serial, want.serial) == 0;
+    for (size_t i = 0; i < oidTableSize && ok; i++) {
+      if (oidTable[i].dest && got.*(oidTable[i].dest) != want.*(oidTable[i].dest)) ok = false;
+    }
+    for (unsigned int i = 0; i < list->count() && ok; i++) ok = checkFormat((*list)[i]->getValue());
+
+    if (!ok && failures++ < BENCH_FAIL_LOG) {
+      Serial.printf("❌ SNMP fuzz mismatch (base %s)\n", c.name);
+      logFuzzCase(round);
+    }
+    if (round % 256 == 255) delay(1);  // 让出 CPU 给同核的空闲任务
+  }
+  Serial.printf("SNMP fuzz: %lu rounds, %d failures (seed %lu)\n", (unsigned long)SNMP_FUZZ_ROUNDS, failures, (unsigned long)seed);
+  return failures;
+}
+
+int snmpBenchmark() {
+  int failures = 0;
+  for (const BenchCase& c : corpus) failures += checkCase(c);
+  Serial.printf("SNMP corpus: %u cases, %d failures\n", (unsigned)(sizeof(corpus) / sizeof(corpus[0])), failures);
+  for (const BenchCase& c : corpus) benchCase(c);
+  failures += fuzzCorpus();
+  return failures;
+}
+
+#endif  // SNMP_BENCHMARK
@@ -0,0 +1,21 @@
+/*
+ * snmp_bench.h - SNMP 响应语料基准与模糊测试
+ *
+ * 内置一组 Ricoh GetResponse 语料 (合并计数器、碳粉以 Integer/OctetString 返回、带实例后缀的 OID、
+ * Counter32/Gauge32/Counter64、v1 错误响应的 NULL 值、超长/非数字字符串、未知 OID)，启动时：
+ *   1. 逐条检查分发结果 (snmpApplyVarbinds 写入的字段与期望一致，未命中的字段不变)
+ *   2. 测量分发与格式化 (snmpValueFormat) 的 ns/varbind，以及每条消息的 operator new 次数
+ *   3. 以语料为种子做 SNMP_FUZZ_ROUNDS 轮变异，与逐字符串比较的参考实现做差分对比，
+ *      并检查格式化结果始终以 NUL 结尾、不越界
+ * 只在 SNMP_BENCHMARK 为 1 时编译，结果输出到串口
+ */
+
+#ifndef SNMP_BENCH_H
+#define SNMP_BENCH_H
+
+#include <Arduino.h>
+
+// 运行语料检查、基准与模糊测试 (setup 中、SNMP 任务启动前调用)，返回失败数
+int snmpBenchmark();
+
+#endif  // SNMP_BENCH_H
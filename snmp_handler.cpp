@@ -7,255 +7,286 @@
 #include "snmp_handler.h"
 #include "config.h"
 #include "globals.h"
+#include "scanner.h"
+#include "printer_monitor.h"
+#include "oid_table.h"
+#include "snmp_inflight.h"
+#include "snmp_walk.h"
+#include "snmp_poll.h"
+#include "snmp_trap.h"
+#include "spsc_queue.h"
+#include "snmp_pdu.h"
+#include "metrics.h"
 #include <ArduinoJson.h>
 #include <cstdlib>
 #include <cstring>
 
-// 将 SNMP BER 值转为字符串
-static String snmpValueToString(SNMP::BER* value) {
-  if (!value) return "";
-  if (value->getType() == SNMP::Type::OctetString) {
-    return String(static_cast<SNMP::OctetStringBER*>(value)->getValue());
-  }
-  if (value->getType() == SNMP::Type::Integer) {
-    return String(static_cast<SNMP::IntegerBER*>(value)->getValue());
-  }
-  if (value->getType() == SNMP::Type::Counter32) {
-    return String(static_cast<SNMP::Counter32BER*>(value)->getValue());
+// --- OID 查询结果队列（SNMP 任务写入，loop 任务中 mqtt 发送后弹出）---
+struct OidResult {
+  char json[OID_RESULT_MAX];
+};
+
+static SpscQueue<OidResult, OID_RESULT_QUEUE> oidResults;
+static int oidReserved = 0;  // 已为在途遍历预留的空位 (只由 SNMP 任务读写)
+
+// 序列化结果并入队；结果过大 (或文档已溢出、内容不完整) 时改为错误应答。
+// reserved 为 true 时使用调用方预留的空位；否则只能使用未预留的空位，没有则丢弃本条
+void pushOidResult(JsonDocument& doc, bool reserved) {
+  if (doc.overflowed() || measureJson(doc) >= OID_RESULT_MAX) {
+    const char* requestId = doc["requestId"];
+    char id[sizeof(InflightEntry::tag)];
+    strlcpy(id, requestId ? requestId : "", sizeof(id));
+    doc.clear();
+    doc["requestId"] = id;
+    doc["error"] = "too large";
   }
-  if (value->getType() == SNMP::Type::Gauge32) {
-    return String(static_cast<SNMP::Gauge32BER*>(value)->getValue());
+  if (reserved && oidReserved > 0) oidReserved--;
+  OidResult* slot = (int)oidResults.free() > oidReserved ? oidResults.back() : nullptr;
+  if (!slot) {
+    Serial.println("OID result queue full, dropped");
+    return;
   }
-  return "";
+  serializeJson(doc, slot->json, OID_RESULT_MAX);
+  oidResults.push();
 }
 
-// --- SNMP 消息回调函数 ---
-// 当收到 SNMP 响应时，此函数会被调用
-void onSNMPMessage(const SNMP::Message* message, const IPAddress remote, const uint16_t port) {
-  SNMP::VarBindList* varbindlist = message->getVarBindList();
+bool oidResultReserve(int count) {
+  if ((int)oidResults.free() - oidReserved < count) return false;
+  oidReserved += count;
+  return true;
+}
 
-  // 优先处理按需 OID 查询的响应（仅当响应中的 OID 均在请求列表中时认定为本次查询）
-  if (pendingOidRequest && remote.toString() == pendingOidTarget) {
-    StaticJsonDocument<256> reqDoc;
-    if (!deserializeJson(reqDoc, pendingOidJson) && reqDoc.is<JsonArray>()) {
-      JsonArray reqArr = reqDoc.as<JsonArray>();
-      bool allMatch = true;
-      for (unsigned int i = 0; i < varbindlist->count() && allMatch; ++i) {
-        const char* name = (*varbindlist)[i]->getName();
-        bool found = false;
-        for (JsonVariant v : reqArr) {
-          if (strcmp(v.as<const char*>(), name) == 0) {
-            found = true;
-            break;
-          }
-        }
-        if (!found) allMatch = false;
-      }
-      if (allMatch && varbindlist->count() > 0) {
-        StaticJsonDocument<512> respDoc;
-        respDoc["requestId"] = pendingOidRequestId;
-        JsonObject results = respDoc.createNestedObject("results");
-        for (unsigned int i = 0; i < varbindlist->count(); ++i) {
-          SNMP::VarBind* vb = (*varbindlist)[i];
-          results[vb->getName()] = snmpValueToString(vb->getValue());
-        }
-        String json;
-        serializeJson(respDoc, json);
-        pendingOidResult = json;
-        pendingOidRequest = false;
-        pendingOidTarget = "";
-        pendingOidRequestId = "";
-        pendingOidJson = "";
-        return;
-      }
-    }
-  }
+void oidResultRelease(int count) {
+  oidReserved = count < oidReserved ? oidReserved - count : 0;
+}
+
+const char* peekOidResult() {
+  OidResult* r = oidResults.front();
+  return r ? r->json : nullptr;
+}
 
-  String currentSerial = "";
-  currentSerial.reserve(32);
+void popOidResult() {
+  if (oidResults.front()) oidResults.pop();
+}
 
-  // 遍历所有变量绑定，解析每个 OID 的值
+// 从响应中取出序列号，没有则返回 nullptr
+static const char* findSerial(SNMP::VarBindList* varbindlist) {
   for (unsigned int index = 0; index < varbindlist->count(); ++index) {
     SNMP::VarBind* varbind = (*varbindlist)[index];
-    const char* name = varbind->getName();   // OID 名称
-    SNMP::BER* value = varbind->getValue();  // OID 的值
+    SNMP::BER* value = varbind->getValue();
+    if (!value || value->getType() != SNMP::Type::OctetString) continue;
+    const OidEntry* entry = oidLookup(varbind->getName());
+    if (entry && entry->kind == OID_KIND_SERIAL) return static_cast<SNMP::OctetStringBER*>(value)->getValue();
+  }
+  return nullptr;
+}
 
-    if (value) {
-      // 处理字符串类型 (如序列号)
-      if (value->getType() == SNMP::Type::OctetString) {
-        const char* octetValue = static_cast<SNMP::OctetStringBER*>(value)->getValue();
-        // 使用 strstr 检查 OID 是否以目标 OID 结尾（避免创建 String 对象）
-        size_t nameLen = strlen(name);
-        size_t oidLen = strlen(OID_PRT_SERIAL);
-        if (nameLen >= oidLen && strcmp(name + nameLen - oidLen, OID_PRT_SERIAL) == 0) {
-          currentSerial = octetValue;
-          // 如果是锁定状态，更新序列号变量
-          if (!isScanning) {
-            val_PrtSerial.reserve(32);
-            val_PrtSerial = octetValue;
-          }
-        }
-        // 碳粉余量 (OctetString 如 "100")，打印机可能返回带实例后缀的 OID 如 ...5.1.0
-        else if (!isScanning) {
-          int tonerVal = atoi(octetValue);
-          size_t len;
-#define MATCH_TONER_OID(oid) ((len = strlen(oid)) <= nameLen && strncmp(name, oid, len) == 0 && (name[len] == '\0' || name[len] == '.'))
-          if (MATCH_TONER_OID(OID_TONER_BLACK)) val_TonerBlack = tonerVal;
-          else if (MATCH_TONER_OID(OID_TONER_CYAN)) val_TonerCyan = tonerVal;
-          else if (MATCH_TONER_OID(OID_TONER_RED)) val_TonerRed = tonerVal;
-          else if (MATCH_TONER_OID(OID_TONER_YELLOW)) val_TonerYellow = tonerVal;
-#undef MATCH_TONER_OID
-        }
-      }
-      // 处理整数类型 (如计数器值)
-      else if (value->getType() == SNMP::Type::Integer || value->getType() == SNMP::Type::Counter32 || value->getType() == SNMP::Type::Gauge32) {
+// 轮询响应：按 OID 表把值写入对应打印机槽位 (工作副本，周期完整后由 snmp_poll 发布快照)
+// 只有完整的响应才刷新看门狗的响应时间
+static void applyPollResponse(uint8_t slot, uint8_t requested, const SNMP::Message* message) {
+  PrinterState& p = printers[slot];
+  // 被排除 OID 的单项复查：不计入周期，恢复后才写入其值
+  if (requested == 0) {
+    if (snmpPollOnProbe(slot, message)) snmpApplyVarbinds(p, message->getVarBindList());
+    return;
+  }
+  snmpApplyVarbinds(p, message->getVarBindList());
+  if (!snmpPollOnResponse(slot, requested, message)) return;
+  p.lastResponseTime = millis();
+  if (slot == 0) setStatusMessage("Online (SNMP OK)");
+}
 
-        int val = 0;
-        // 根据不同的数据类型提取整数值
-        if (value->getType() == SNMP::Type::Integer) {
-          val = static_cast<SNMP::IntegerBER*>(value)->getValue();
-        } else if (value->getType() == SNMP::Type::Counter32) {
-          val = static_cast<SNMP::Counter32BER*>(value)->getValue();
-        } else if (value->getType() == SNMP::Type::Gauge32) {
-          val = static_cast<SNMP::Gauge32BER*>(value)->getValue();
-        }
+// 扫描响应：按序列号决定是否锁定为主打印机 (槽位 0)
+static void handleScanResponse(IPAddress remote, const SNMP::Message* message) {
+  scannerNoteReply();
 
-        // 只有锁定后才更新计数器 (扫描模式下不更新，避免干扰)
-        if (!isScanning) {
-          size_t nameLen = strlen(name);
-          size_t oidLen;
-          // 使用 strcmp 直接比较 OID 后缀（避免创建 String 对象）
-          if ((oidLen = strlen(OID_SYS_TOTAL)) <= nameLen && strcmp(name + nameLen - oidLen, OID_SYS_TOTAL) == 0) {
-            val_SysTotal = val;
-          } else if ((oidLen = strlen(OID_COL_COPIES)) <= nameLen && strcmp(name + nameLen - oidLen, OID_COL_COPIES) == 0) {
-            val_ColCopies = val;
-          } else if ((oidLen = strlen(OID_BW_COPIES)) <= nameLen && strcmp(name + nameLen - oidLen, OID_BW_COPIES) == 0) {
-            val_BWCopies = val;
-          } else if ((oidLen = strlen(OID_COL_PRINTS)) <= nameLen && strcmp(name + nameLen - oidLen, OID_COL_PRINTS) == 0) {
-            val_ColPrints = val;
-          } else if ((oidLen = strlen(OID_BW_PRINTS)) <= nameLen && strcmp(name + nameLen - oidLen, OID_BW_PRINTS) == 0) {
-            val_BWPrints = val;
-          } else if ((oidLen = strlen(OID_TONER_BLACK)) <= nameLen && strncmp(name, OID_TONER_BLACK, oidLen) == 0 && (name[oidLen] == '\0' || name[oidLen] == '.')) {
-            val_TonerBlack = val;
-          } else if ((oidLen = strlen(OID_TONER_CYAN)) <= nameLen && strncmp(name, OID_TONER_CYAN, oidLen) == 0 && (name[oidLen] == '\0' || name[oidLen] == '.')) {
-            val_TonerCyan = val;
-          } else if ((oidLen = strlen(OID_TONER_RED)) <= nameLen && strncmp(name, OID_TONER_RED, oidLen) == 0 && (name[oidLen] == '\0' || name[oidLen] == '.')) {
-            val_TonerRed = val;
-          } else if ((oidLen = strlen(OID_TONER_YELLOW)) <= nameLen && strncmp(name, OID_TONER_YELLOW, oidLen) == 0 && (name[oidLen] == '\0' || name[oidLen] == '.')) {
-            val_TonerYellow = val;
-          }
-        }
-      }
-    }
+  // 已由其他槽位监控的打印机不参与锁定
+  for (int slot = 1; slot < printerCount; slot++) {
+    if (printers[slot].ip == remote) return;
   }
 
-  // === 关键逻辑：扫描模式下的匹配 ===
-  if (isScanning) {
-    // 情况 1: 如果用户设定了目标序列号
-    if (cfg_target_serial != "") {
-      if (currentSerial == cfg_target_serial) {
-        // 序列号匹配！锁定这台打印机
-        val_PrtSerial = currentSerial;  // 保存序列号
-        String remoteIP;
-        remoteIP.reserve(16);
-        remoteIP = remote.toString();
-        foundPrinter(remoteIP);
-      } else {
-        // 序列号不匹配，跳过
-        IPAddress remoteIP = remote;
-        Serial.printf("IP %s Serial: %s (Mismatch, skipping)\n", remoteIP.toString().c_str(), currentSerial.c_str());
-      }
-    }
-    // 情况 2: 如果用户没设定序列号 (留空) -> 回退方案: 锁定第一台响应的打印机
-    else {
-      val_PrtSerial = currentSerial;
-      String remoteIP;
-      remoteIP.reserve(16);
-      remoteIP = remote.toString();
-      foundPrinter(remoteIP);
-    }
+  // 突发模式没有 9100 预过滤，路由器/交换机等 agent 也会应答 (常为 noSuchName 回显)：
+  // 只有无错误且带非空序列号的应答才可能是打印机
+  const char* serial = findSerial(message->getVarBindList());
+  if (message->getErrorStatus() != 0 || !serial || serial[0] == '\0') {
+    char ip[16];
+    Serial.printf("IP %s: SNMP reply without serial (error %d), skipping\n", ipToStr(remote, ip),
+                  (int)message->getErrorStatus());
+    return;
+  }
+
+  // 情况 1: 如果用户设定了目标序列号，只锁定序列号匹配的打印机
+  // 情况 2: 如果用户没设定序列号 (留空) -> 回退方案: 锁定第一台返回序列号的打印机
+  if (cfg_target_serial == "" || cfg_target_serial == serial) {
+    foundPrinter(remote, serial);
   } else {
-    // 锁定状态：正常计算与上传数据
-    // 使用直接从SNMP读取的值
-    calc_BWCopies = val_BWCopies;
-    calc_BWPrints = val_BWPrints;
+    // 序列号不匹配，跳过
+    char ip[16];
+    Serial.printf("IP %s Serial: %s (Mismatch, skipping)\n", ipToStr(remote, ip), serial);
+  }
+}
 
-    // 通过求和计算总数
-    calc_ColTotal = val_ColPrints + val_ColCopies;  // 彩色总数 = 彩色打印 + 彩色复印
-    calc_BWTotal = val_BWPrints + val_BWCopies;     // 黑白总数 = 黑白打印 + 黑白复印
-    calc_TotCopies = val_ColCopies + val_BWCopies;  // 总复印数 = 彩色复印 + 黑白复印
+// --- SNMP 消息回调函数 ---
+// 当收到 SNMP 响应或 trap 时，此函数会被调用
+void onSNMPMessage(const SNMP::Message* message, const IPAddress remote, const uint16_t port) {
+  // 打印机主动发来的 trap/inform (管理器监听 162，与响应走同一回调)
+  if (snmpTrapHandle(message, remote, port)) return;
 
-    // 防止负数 (数据异常时的保护)
-    if (calc_ColTotal < 0) calc_ColTotal = 0;
-    if (calc_BWTotal < 0) calc_BWTotal = 0;
-    if (calc_TotCopies < 0) calc_TotCopies = 0;
-    if (calc_BWCopies < 0) calc_BWCopies = 0;
-    if (calc_BWPrints < 0) calc_BWPrints = 0;
+  SNMP::VarBindList* varbindlist = message->getVarBindList();
 
-    statusMessage = "Online (SNMP OK)";
+  // 按 request-id 匹配在途请求：按需 OID 查询直接生成结果，轮询按 owner 找到打印机槽位再按 OID 表分发
+  InflightEntry* pending = inflightFind(message->getRequestID(), remote);
+  if (pending) metricsObserve(HIST_SNMP_RTT, millis() - pending->sentAt);
+  if (pending && pending->kind == INFLIGHT_WALK) {
+    uint8_t slot = pending->owner;
+    inflightRelease(pending);  // 先释放，遍历会立即登记下一个请求
+    snmpWalkOnResponse(slot, message);
+    return;
+  }
+  if (pending && pending->kind == INFLIGHT_OID) {
+    // 复制的字符串在输出中都带引号，输出不超过 OID_RESULT_MAX 的结果一定放得下；更大的由 pushOidResult 报错
+    StaticJsonDocument<JSON_OBJECT_SIZE(3) + JSON_OBJECT_SIZE(OID_REQUEST_OIDS) + OID_RESULT_MAX> respDoc;
+    respDoc["requestId"] = pending->tag;
+    if (message->getErrorStatus() != 0) respDoc["errorStatus"] = message->getErrorStatus();
+    JsonObject results = respDoc.createNestedObject("results");
+    char value[SNMP_VALUE_MAX];
+    for (unsigned int i = 0; i < varbindlist->count(); ++i) {
+      SNMP::VarBind* vb = (*varbindlist)[i];
+      snmpValueFormat(vb->getValue(), value, sizeof(value));
+      results[vb->getName()] = value;  // 非 const 的 char* 会被复制进文档
+    }
+    pushOidResult(respDoc);
+    inflightRelease(pending);
+    return;
   }
+  if (pending) {
+    uint8_t slot = pending->owner;
+    uint8_t requested = pending->part;
+    inflightRelease(pending);
+    // 槽位在请求发出后可能已重新扫描/更换 IP
+    if (slot < printerCount && printers[slot].ip == remote) {
+      applyPollResponse(slot, requested, message);
+    }
+    return;
+  }
+
+  // 未登记的响应只可能是扫描探测的应答，其余 (已超时或未知) 丢弃以免误归属
+  if (isScanning) handleScanResponse(remote, message);
 }
 
-// --- 发送 SNMP 请求 ---
-// 向目标 IP 发送 SNMP GetRequest 查询打印机数据
+// --- 发送 SNMP 探测请求 ---
+// 扫描时向目标 IP 查询序列号，用于匹配打印机 (不登记在途请求，响应在扫描模式下处理)
+// 探测 PDU 对所有地址相同，首次调用时编码一次，之后直接发送，不再逐个地址构造 SNMP::Message
 void sendSNMPRequest(IPAddress target) {
-  // 创建 SNMP V1 GetRequest 消息，使用 "public" 作为社区字符串
-  SNMP::Message* message = new SNMP::Message(SNMP::Version::V1, "public", SNMP::Type::GetRequest);
-
-  // 总是读取序列号，以便进行匹配 (扫描和锁定模式都需要)
-  message->add(OID_PRT_SERIAL, new SNMP::NullBER());
-
-  // 如果不在扫描模式，才读取计数器 (减少扫描时的数据包大小，提高扫描速度)
-  if (!isScanning) {
-    message->add(OID_SYS_TOTAL, new SNMP::NullBER());
-    message->add(OID_COL_COPIES, new SNMP::NullBER());
-    message->add(OID_BW_COPIES, new SNMP::NullBER());
-    message->add(OID_COL_PRINTS, new SNMP::NullBER());
-    message->add(OID_BW_PRINTS, new SNMP::NullBER());
+  static uint8_t probe[SNMP_PDU_MAX];
+  static size_t probeLen = 0;
+  if (probeLen == 0) {
+    // 只读取序列号 (减少扫描时的数据包大小，提高扫描速度)
+    const char* oids[4];
+    size_t count = 0;
+    for (size_t i = 0; i < oidTableSize && count < 4; i++) {
+      if (oidTable[i].kind == OID_KIND_SERIAL) oids[count++] = oidTable[i].oid;
+    }
+    probeLen = snmpEncodeRequest(probe, sizeof(probe), SNMP_VERSION_1, "public", SNMP_PDU_GET, 0, 0, 0, oids, count);
+    if (probeLen == 0) return;
   }
+  snmpSendRaw(target, probe, probeLen);
+}
 
-  // 发送 SNMP 请求到目标 IP 的 161 端口 (SNMP 标准端口)
-  if (snmp.send(message, target, 161)) {
-    lastRequestTime = millis();  // 更新最后请求时间
+// OID 查询的目标：payload 带 "serial" 时选该序列号的打印机，否则为主打印机 (槽位 0)
+// 未找到返回 nullptr
+static const PrinterState* oidRequestTarget(const char* serial) {
+  for (int slot = 0; slot < printerCount; slot++) {
+    const PrinterState& p = printers[slot];
+    bool polled = p.ip[0] != 0 && !(slot == 0 && isScanning);
+    if (!serial) return polled ? &p : nullptr;
+    if (polled && strcmp(p.serial, serial) == 0) return &p;
   }
-
-  // 释放消息内存
-  delete message;
+  return nullptr;
 }
 
-// --- 单独请求碳粉（Ricoh 合并请求时只返回前 6 项，不返回碳粉）---
-void sendTonerRequest(IPAddress target) {
-  SNMP::Message* message = new SNMP::Message(SNMP::Version::V1, "public", SNMP::Type::GetRequest);
-  message->add(OID_TONER_BLACK, new SNMP::NullBER());
-  message->add(OID_TONER_CYAN, new SNMP::NullBER());
-  message->add(OID_TONER_RED, new SNMP::NullBER());
-  message->add(OID_TONER_YELLOW, new SNMP::NullBER());
-  if (snmp.send(message, target, 161)) lastRequestTime = millis();
-  delete message;
+// 立即返回错误结果
+static void pushOidError(const char* requestId, const char* error) {
+  StaticJsonDocument<96> err;
+  err["requestId"] = requestId;
+  err["error"] = error;
+  pushOidResult(err);
 }
 
 // --- 按 OID 列表请求，结果由 onSNMPMessage 收到后发到 printer/oid/{MAC} ---
-// 接收格式: {"requestId":"uuid","oids":["oid1","oid2"]}
-void sendSNMPOidRequest(IPAddress target, const String& payload) {
+// 接收格式: {"requestId":"uuid","oids":["oid1","oid2"]}，或子树遍历 {"requestId":"uuid","walk":"1.3.6.1.2.1.43.11"}
+// 可选 "serial" 指定打印机，缺省为主打印机
+// 可同时有多个查询在途 (与周期轮询共享在途表)，各自按 request-id 匹配，超时返回 {"requestId","error":"timeout"}
+void sendSNMPOidRequest(const char* payload) {
   StaticJsonDocument<384> doc;
   if (deserializeJson(doc, payload)) return;
   const char* requestId = doc["requestId"];
+  if (!requestId) return;
+
+  const char* serial = doc["serial"];
+  const PrinterState* printer = oidRequestTarget(serial);
+  if (!printer) {
+    // 主打印机尚未锁定时与原来一样忽略；指定了序列号但未找到则告知服务端
+    if (serial) pushOidError(requestId, "unknown serial");
+    return;
+  }
+  IPAddress target = printer->ip;
+
+  const char* walkRoot = doc["walk"];
+  if (walkRoot) {
+    const char* error = startSNMPWalk(target, requestId, walkRoot);
+    if (error) pushOidError(requestId, error);
+    return;
+  }
+
   JsonArray arr = doc["oids"];
-  if (!requestId || !arr || arr.size() == 0) return;
+  if (!arr || arr.size() == 0) return;
 
-  SNMP::Message* message = new SNMP::Message(SNMP::Version::V1, "public", SNMP::Type::GetRequest);
+  const char* oids[OID_REQUEST_OIDS];
+  size_t count = 0;
   for (JsonVariant v : arr) {
     const char* oid = v.as<const char*>();
-    if (oid && strlen(oid) > 0) message->add(oid, new SNMP::NullBER());
+    if (!oid || oid[0] == '\0') continue;
+    if (count == OID_REQUEST_OIDS) {
+      pushOidError(requestId, "too many oids");
+      return;
+    }
+    oids[count++] = oid;
   }
+  if (count == 0) return;
 
-  if (snmp.send(message, target, 161)) {
-    pendingOidRequest = true;
-    pendingOidTarget = target.toString();
-    pendingOidRequestId = requestId;
-    String oidsStr;
-    serializeJson(arr, oidsStr);
-    pendingOidJson = oidsStr;
+  int32_t id = inflightAdd(INFLIGHT_OID, target, SNMP_REQUEST_TIMEOUT, requestId);
+  if (id == 0) {
+    pushOidError(requestId, "busy");
+    return;
+  }
+  // 编码后的 OID 比点分文本短，按 payload 上限分配足够容纳
+  uint8_t buf[OID_REQUEST_MAX + 32];
+  size_t len = snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_1, "public", SNMP_PDU_GET, id, 0, 0, oids, count);
+  if (len == 0 || !snmpSendRaw(target, buf, len)) {
+    inflightRelease(inflightFind(id, target));
+    pushOidError(requestId, len == 0 ? "bad oid" : "busy");
   }
-  delete message;
+}
+
+// 在途请求超时：OID 查询返回超时结果，轮询记为不完整周期
+static void onRequestExpired(const InflightEntry& entry) {
+  if (entry.kind == INFLIGHT_POLL) {
+    metricsCount(CNT_SNMP_TIMEOUT_POLL);
+    snmpPollOnTimeout(entry.owner, entry.target, entry.part);
+  }
+  if (entry.kind == INFLIGHT_WALK) {
+    metricsCount(CNT_SNMP_TIMEOUT_WALK);
+    snmpWalkOnTimeout(entry.owner);
+  }
+  if (entry.kind == INFLIGHT_OID) {
+    metricsCount(CNT_SNMP_TIMEOUT_OID);
+    pushOidError(entry.tag, "timeout");
+  }
+}
+
+// --- 在途请求超时处理 ---
+void snmpRequestLoop() {
+  inflightExpire(onRequestExpired);
+  snmpWalkLoop();
 }
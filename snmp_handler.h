@@ -9,20 +9,35 @@
 
 #include <Arduino.h>
 #include <SNMP.h>
+#include <ArduinoJson.h>
+#include "globals.h"
+#include "snmp_varbind.h"
 
 // SNMP 消息回调函数
 void onSNMPMessage(const SNMP::Message* message, const IPAddress remote, const uint16_t port);
 
-// 发送 SNMP 请求
+// 发送扫描探测请求（只查询序列号）
 void sendSNMPRequest(IPAddress target);
 
-// 单独请求碳粉余量
-void sendTonerRequest(IPAddress target);
+// 按 OID 列表请求（payload: {"requestId":"uuid","oids":["oid1","oid2"]}，可选 "serial" 指定打印机），
+// 结果通过 MQTT printer/oid/{MAC} 上报；在 SNMP 任务中调用 (MQTT 回调经 snmpTaskPost 转交)
+void sendSNMPOidRequest(const char* payload);
 
-// 找到打印机后的处理
-void foundPrinter(String targetIP);
+// 在途请求超时处理、继续暂停的遍历（每次 loop 调用）
+void snmpRequestLoop();
 
-// 按 OID 列表请求（payload: {"requestId":"uuid","oids":["oid1","oid2"]}），结果通过 MQTT printer/oid/{MAC} 上报
-void sendSNMPOidRequest(IPAddress target, const String& payload);
+// OID 查询/遍历结果入队，等待 mqtt 发到 printer/oid/{MAC}（生产者：SNMP 任务）
+// reserved 为 true 时占用一个 oidResultReserve 预留的空位，否则只使用未预留的空位
+void pushOidResult(JsonDocument& doc, bool reserved = false);
+
+// 预留 count 个结果队列空位 (遍历发出请求前按一批的最坏分块数预留)，空位不足返回 false
+bool oidResultReserve(int count);
+
+// 归还未用完的预留空位
+void oidResultRelease(int count);
+
+// 待发送的 OID 查询结果（JSON），无结果返回 nullptr；发送后调用 popOidResult（消费者：loop 任务）
+const char* peekOidResult();
+void popOidResult();
 
 #endif  // SNMP_HANDLER_H
@@ -0,0 +1,65 @@
+/*
+ * snmp_inflight.cpp - 在途 SNMP 请求表实现
+ *
+ * 固定容量 SNMP_INFLIGHT_MAX，线性查找 (容量很小，不值得哈希)
+ */
+
+#include "snmp_inflight.h"
+#include "config.h"
+
+static InflightEntry entries[SNMP_INFLIGHT_MAX];
+static int32_t nextRequestId = 0;
+
+// 生成下一个 request-id（正数，跳过 0；起点随机，避免重启后与旧响应撞号）
+static int32_t allocRequestId() {
+  if (nextRequestId == 0) nextRequestId = (esp_random() & 0x3FFFFFFF) | 1;
+  int32_t id = nextRequestId++;
+  if (nextRequestId <= 0) nextRequestId = 1;
+  return id;
+}
+
+int32_t inflightAdd(InflightKind kind, IPAddress target, unsigned long timeoutMs, const char* tag,
+                    uint8_t owner, uint8_t part) {
+  for (InflightEntry& e : entries) {
+    if (e.requestId != 0) continue;
+    e.requestId = allocRequestId();
+    e.kind = kind;
+    e.owner = owner;
+    e.part = part;
+    e.target = target;
+    e.sentAt = millis();
+    e.deadline = e.sentAt + timeoutMs;
+    strlcpy(e.tag, tag ? tag : "", sizeof(e.tag));
+    return e.requestId;
+  }
+  return 0;
+}
+
+InflightEntry* inflightFind(int32_t requestId, IPAddress remote) {
+  if (requestId == 0) return nullptr;
+  for (InflightEntry& e : entries) {
+    if (e.requestId == requestId && e.target == remote) return &e;
+  }
+  return nullptr;
+}
+
+void inflightRelease(InflightEntry* entry) {
+  if (entry) entry->requestId = 0;
+}
+
+void inflightExpire(void (*onExpire)(const InflightEntry& entry)) {
+  unsigned long now = millis();
+  for (InflightEntry& e : entries) {
+    if (e.requestId == 0 || (long)(now - e.deadline) < 0) continue;
+    if (onExpire) onExpire(e);
+    e.requestId = 0;
+  }
+}
+
+int inflightCount() {
+  int n = 0;
+  for (const InflightEntry& e : entries) {
+    if (e.requestId != 0) n++;
+  }
+  return n;
+}
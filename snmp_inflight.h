@@ -0,0 +1,47 @@
+/*
+ * snmp_inflight.h - 在途 SNMP 请求表
+ *
+ * 每个发出的请求占一个槽位，以 SNMP request-id 为键、带截止时间；
+ * 响应按 request-id + 来源地址匹配，超时的槽位由 inflightExpire 回收并通知调用方
+ */
+
+#ifndef SNMP_INFLIGHT_H
+#define SNMP_INFLIGHT_H
+
+#include <Arduino.h>
+
+// --- 请求类别 ---
+enum InflightKind : uint8_t {
+  INFLIGHT_POLL,  // 周期轮询 (计数器/碳粉)
+  INFLIGHT_OID,   // 按需 OID 查询 (server/oid)
+  INFLIGHT_WALK,  // 子树遍历 (GetBulk/GetNext)
+};
+
+struct InflightEntry {
+  int32_t requestId;       // SNMP request-id，0 表示空闲
+  InflightKind kind;       // 请求类别
+  uint8_t owner;           // 调用方槽位 (遍历为 walk 槽位号，轮询为打印机槽位号)
+  uint8_t part;            // 调用方附加信息 (轮询为请求的 varbind 数，0 为被排除 OID 的单项复查)
+  IPAddress target;        // 目标地址
+  unsigned long sentAt;    // 登记时间 (millis)，用于统计往返时延
+  unsigned long deadline;  // 截止时间 (millis)
+  char tag[40];            // 调用方标识 (OID 查询为 MQTT 侧 requestId)
+};
+
+// 分配一个槽位，返回新的 request-id；表满返回 0
+int32_t inflightAdd(InflightKind kind, IPAddress target, unsigned long timeoutMs, const char* tag = nullptr,
+                    uint8_t owner = 0, uint8_t part = 0);
+
+// 按 request-id 与来源地址查找槽位，未找到返回 nullptr
+InflightEntry* inflightFind(int32_t requestId, IPAddress remote);
+
+// 释放槽位（响应已处理或发送失败）
+void inflightRelease(InflightEntry* entry);
+
+// 回收所有已超时的槽位，对每个槽位调用 onExpire 后释放
+void inflightExpire(void (*onExpire)(const InflightEntry& entry));
+
+// 当前在途请求数
+int inflightCount();
+
+#endif  // SNMP_INFLIGHT_H
@@ -0,0 +1,160 @@
+/*
+ * snmp_pdu.cpp - SNMP 请求 PDU 编码实现
+ *
+ * 先计算各层长度再顺序写出，不分配堆内存
+ */
+
+#include "snmp_pdu.h"
+#include <atomic>
+#include "globals.h"
+#include "sim.h"
+
+static std::atomic<uint32_t> bytesSent{ 0 };
+
+// --- BER 长度辅助 ---
+static size_t lenOfLen(size_t n) {
+  return n < 0x80 ? 1 : (n < 0x100 ? 2 : 3);
+}
+
+static size_t tlvSize(size_t contentLen) {
+  return 1 + lenOfLen(contentLen) + contentLen;
+}
+
+// 最小补码编码的整数字节数
+static size_t intContentLen(int32_t v) {
+  size_t n = 4;
+  while (n > 1) {
+    uint8_t top = (v >> ((n - 1) * 8)) & 0xFF;
+    uint8_t next = (v >> ((n - 2) * 8)) & 0x80;
+    if ((top == 0x00 && !next) || (top == 0xFF && next)) n--;
+    else break;
+  }
+  return n;
+}
+
+// 解析点分 OID 的下一段，失败返回 false
+static bool nextArc(const char*& p, uint32_t& arc) {
+  if (*p < '0' || *p > '9') return false;
+  arc = 0;
+  while (*p >= '0' && *p <= '9') arc = arc * 10 + (*p++ - '0');
+  if (*p == '.') p++;
+  else if (*p != '\0') return false;
+  return true;
+}
+
+static size_t base128Len(uint32_t v) {
+  size_t n = 1;
+  while (v >>= 7) n++;
+  return n;
+}
+
+// OID 值部分的字节数，非法 OID 返回 0
+static size_t oidContentLen(const char* oid) {
+  const char* p = oid;
+  uint32_t a0, a1, arc;
+  if (!nextArc(p, a0) || !nextArc(p, a1) || a0 > 2) return 0;
+  size_t n = base128Len(a0 * 40 + a1);
+  while (*p) {
+    if (!nextArc(p, arc)) return 0;
+    n += base128Len(arc);
+  }
+  return n;
+}
+
+// --- 顺序写出 ---
+struct BerWriter {
+  uint8_t* buf;
+  size_t cap;
+  size_t pos;
+
+  void byte(uint8_t b) {
+    if (pos < cap) buf[pos] = b;
+    pos++;
+  }
+  void header(uint8_t tag, size_t len) {
+    byte(tag);
+    if (len >= 0x100) {
+      byte(0x82);
+      byte(len >> 8);
+    } else if (len >= 0x80) {
+      byte(0x81);
+    }
+    byte(len & 0xFF);
+  }
+  void integer(int32_t v, size_t n) {
+    header(0x02, n);
+    while (n--) byte((v >> (n * 8)) & 0xFF);
+  }
+  void base128(uint32_t v) {
+    for (size_t i = base128Len(v); i > 1; i--) byte(0x80 | ((v >> (7 * (i - 1))) & 0x7F));
+    byte(v & 0x7F);
+  }
+  void oid(const char* s, size_t len) {
+    header(0x06, len);
+    uint32_t a0 = 0, a1 = 0, arc;
+    nextArc(s, a0);
+    nextArc(s, a1);
+    base128(a0 * 40 + a1);
+    while (*s && nextArc(s, arc)) base128(arc);
+  }
+};
+
+size_t snmpEncodeRequest(uint8_t* buf, size_t cap, uint8_t version, const char* community, uint8_t pduType,
+                         int32_t requestId, int32_t field1, int32_t field2,
+                         const char* const* oids, size_t oidCount, size_t* requestIdOffset) {
+  // 第一遍：计算长度
+  size_t vblLen = 0;
+  for (size_t i = 0; i < oidCount; i++) {
+    size_t oidLen = oidContentLen(oids[i]);
+    if (oidLen == 0) return 0;
+    vblLen += tlvSize(tlvSize(oidLen) + 2);  // SEQ { OID, NULL }
+  }
+  size_t communityLen = strlen(community);
+  size_t f1Len = intContentLen(field1);
+  size_t f2Len = intContentLen(field2);
+  size_t pduLen = tlvSize(4) + tlvSize(f1Len) + tlvSize(f2Len) + tlvSize(vblLen);
+  size_t msgLen = tlvSize(1) + tlvSize(communityLen) + tlvSize(pduLen);
+  if (tlvSize(msgLen) > cap) return 0;
+
+  // 第二遍：写出
+  BerWriter w = { buf, cap, 0 };
+  w.header(0x30, msgLen);
+  w.integer(version, 1);
+  w.header(0x04, communityLen);
+  for (size_t i = 0; i < communityLen; i++) w.byte(community[i]);
+  w.header(pduType, pduLen);
+  if (requestIdOffset) *requestIdOffset = w.pos + 2;
+  w.integer(requestId, 4);  // 固定 4 字节，便于原地改写
+  w.integer(field1, f1Len);
+  w.integer(field2, f2Len);
+  w.header(0x30, vblLen);
+  for (size_t i = 0; i < oidCount; i++) {
+    size_t oidLen = oidContentLen(oids[i]);
+    w.header(0x30, tlvSize(oidLen) + 2);
+    w.oid(oids[i], oidLen);
+    w.byte(0x05);  // NULL
+    w.byte(0x00);
+  }
+  return w.pos;
+}
+
+void snmpPatchRequestId(uint8_t* buf, size_t offset, int32_t requestId) {
+  buf[offset] = (requestId >> 24) & 0xFF;
+  buf[offset + 1] = (requestId >> 16) & 0xFF;
+  buf[offset + 2] = (requestId >> 8) & 0xFF;
+  buf[offset + 3] = requestId & 0xFF;
+}
+
+bool snmpSendRaw(IPAddress target, const uint8_t* buf, size_t len, uint16_t port) {
+  bytesSent.fetch_add(len, std::memory_order_relaxed);
+#if SIM_ENABLED
+  if (simOwns(target)) return simSnmpSend(target, buf, len);
+#endif
+  if (!udp.beginPacket(target, port)) return false;
+  udp.write(buf, len);
+  return udp.endPacket();
+}
+
+uint32_t snmpBytesSent() {
+  return bytesSent.load(std::memory_order_relaxed);
+}
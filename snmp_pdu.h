@@ -0,0 +1,39 @@
+/*
+ * snmp_pdu.h - SNMP 请求 PDU 编码
+ *
+ * 直接编码 BER 字节并通过 SNMP 管理器的 UDP 套接字发出，响应仍由 snmp.loop() 解码后交给 onSNMPMessage。
+ * 支持 SNMP 库不提供的 GetNext/GetBulk；request-id 固定编码为 4 字节，便于缓存后原地改写。
+ */
+
+#ifndef SNMP_PDU_H
+#define SNMP_PDU_H
+
+#include <Arduino.h>
+
+// --- PDU 类型 (BER 上下文标签) ---
+#define SNMP_PDU_GET 0xA0
+#define SNMP_PDU_GETNEXT 0xA1
+#define SNMP_PDU_RESPONSE 0xA2
+#define SNMP_PDU_GETBULK 0xA5
+
+// --- 版本字段 ---
+#define SNMP_VERSION_1 0
+#define SNMP_VERSION_2C 1
+
+// 编码请求：varbind 值均为 NULL (也用于 Inform 的 Response 应答)
+// field1/field2 对普通 PDU 为 error-status/error-index (填 0)，对 GetBulk 为 non-repeaters/max-repetitions
+// 成功返回编码长度，OID 非法或缓冲不足返回 0；requestIdOffset 非空时返回 request-id 4 字节的位置
+size_t snmpEncodeRequest(uint8_t* buf, size_t cap, uint8_t version, const char* community, uint8_t pduType,
+                         int32_t requestId, int32_t field1, int32_t field2,
+                         const char* const* oids, size_t oidCount, size_t* requestIdOffset = nullptr);
+
+// 原地改写已编码 PDU 的 request-id
+void snmpPatchRequestId(uint8_t* buf, size_t offset, int32_t requestId);
+
+// 发送已编码的 PDU 到 target:port (请求发往 161，Inform 应答发回来源端口)
+bool snmpSendRaw(IPAddress target, const uint8_t* buf, size_t len, uint16_t port = 161);
+
+// 启动以来 snmpSendRaw 发出的字节数 (不含 IP/UDP 头)
+uint32_t snmpBytesSent();
+
+#endif  // SNMP_PDU_H
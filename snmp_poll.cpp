@@ -0,0 +1,329 @@
+/*
+ * snmp_poll.cpp - 周期轮询请求实现
+ *
+ * 每个槽位一块 SNMP_POLL_ARENA 字节的缓冲，按当前上限依次编码各个 PDU；
+ * request-id 固定 4 字节 (见 snmp_pdu)，轮询时原地改写
+ */
+
+#include "snmp_poll.h"
+#include "config.h"
+#include "globals.h"
+#include "oid_table.h"
+#include "snmp_inflight.h"
+#include "snmp_pdu.h"
+#include "alloc_stats.h"
+#include "printer_snapshot.h"
+
+#define SNMP_ERR_TOO_BIG 1
+#define POLL_OIDS_MAX 32  // 单个请求最多的 varbind 数 (编码时的临时数组)
+
+struct PollPdu {
+  uint16_t offset;    // 在 arena 中的起始位置
+  uint16_t len;       // 编码长度
+  uint16_t idOffset;  // request-id 相对 offset 的位置
+  uint8_t oidCount;   // 请求的 varbind 数
+};
+
+struct PollPlan {
+  uint32_t excluded;    // agent 不支持、不再随周期请求的 OID 表行 (按行号的位图，只在 RAM 中)
+  uint8_t failures[32]; // 各行连续出错次数，达到 SNMP_POLL_EXCLUDE_CONFIRM 后写入 Preferences
+  uint16_t probeIn;     // 距下一次复查被排除行的轮询周期数
+  uint8_t maxVarbinds;  // 单个请求的 varbind 上限
+  uint8_t pduCount;     // 当前打包出的请求数，0 表示未编码
+  bool cacheChecked;    // 已按序列号查过 Preferences 缓存
+  PollPdu pdus[SNMP_POLL_PDU_MAX];
+  uint8_t arena[SNMP_POLL_ARENA];
+};
+
+static PollPlan plans[MAX_PRINTERS];
+static uint32_t lastAllocs = 0;
+
+static bool isExcluded(const PollPlan& plan, size_t row) {
+  return row < 32 && (plan.excluded & (1u << row));
+}
+
+// 序列号与计数器行决定锁定与 data 发布，即使出错也不排除 (周期不完整、不发布，而不是悄悄缺字段)
+static bool isProtected(size_t row) {
+  return oidTable[row].kind == OID_KIND_SERIAL || oidTable[row].kind == OID_KIND_COUNTER;
+}
+
+// 已确认 (连续出错达到阈值) 的排除行，只有这些写入 Preferences
+static uint32_t confirmedRows(const PollPlan& plan) {
+  uint32_t rows = 0;
+  for (size_t row = 0; row < oidTableSize && row < 32; row++) {
+    if (isExcluded(plan, row) && plan.failures[row] >= SNMP_POLL_EXCLUDE_CONFIRM) rows |= 1u << row;
+  }
+  return rows;
+}
+
+// 按 maxVarbinds 把 OID 表 (跳过已排除的行) 依次切分并编码
+static void packPlan(PollPlan& plan) {
+  size_t rows = 0;
+  for (size_t row = 0; row < oidTableSize; row++) {
+    if (!isExcluded(plan, row)) rows++;
+  }
+
+  // 请求数上限固定，表行数超过 上限 × 请求数 时放宽每个请求的 varbind 数
+  size_t per = plan.maxVarbinds;
+  size_t minPer = (rows + SNMP_POLL_PDU_MAX - 1) / SNMP_POLL_PDU_MAX;
+  if (per < minPer) per = minPer;
+  if (per > POLL_OIDS_MAX) per = POLL_OIDS_MAX;
+
+  size_t used = 0;
+  size_t row = 0;
+  plan.pduCount = 0;
+  while (row < oidTableSize && plan.pduCount < SNMP_POLL_PDU_MAX) {
+    const char* oids[POLL_OIDS_MAX];
+    size_t count = 0;
+    for (; row < oidTableSize && count < per; row++) {
+      if (!isExcluded(plan, row)) oids[count++] = oidTable[row].oid;
+    }
+    if (count == 0) break;
+
+    PollPdu& pdu = plan.pdus[plan.pduCount];
+    size_t idOffset = 0;
+    size_t cap = SNMP_POLL_ARENA - used;
+    if (cap > SNMP_PDU_MAX) cap = SNMP_PDU_MAX;
+    size_t len = snmpEncodeRequest(plan.arena + used, cap, SNMP_VERSION_1, "public", SNMP_PDU_GET,
+                                   0, 0, 0, oids, count, &idOffset);
+    if (len == 0) {
+      Serial.println("❌ 轮询 PDU 编码失败 (SNMP_POLL_ARENA 不足?)");
+      break;
+    }
+    pdu.offset = used;
+    pdu.len = len;
+    pdu.idOffset = idOffset;
+    pdu.oidCount = count;
+    used += len;
+    plan.pduCount++;
+  }
+}
+
+// Preferences 键：前缀 (s = 上限，x = 已确认排除的行) + 序列号哈希 (键名最长 15 字符)
+static void cacheKey(char prefix, const char* serial, char* key, size_t size) {
+  snprintf(key, size, "%c%08lx", prefix, (unsigned long)oidHash(serial, strlen(serial)));
+}
+
+// 按序列号读取缓存的上限与已确认排除的行，比当前更严则重新打包 (排除的行在下一周期复查)
+static void loadCachedLimit(uint8_t slot) {
+  PollPlan& plan = plans[slot];
+  const char* serial = printers[slot].serial;
+  plan.cacheChecked = true;
+
+  char key[12];
+  Preferences prefs;  // SNMP 任务中使用独立实例，见 processScanLoop
+  prefs.begin("poll_pack", true);
+  cacheKey('s', serial, key, sizeof(key));
+  uint8_t cached = prefs.getUChar(key, 0);
+  cacheKey('x', serial, key, sizeof(key));
+  uint32_t excluded = prefs.getULong(key, 0);
+  prefs.end();
+
+  bool tighter = false;
+  for (size_t row = 0; row < oidTableSize && row < 32; row++) {
+    if (!(excluded & (1u << row)) || isProtected(row) || isExcluded(plan, row)) continue;
+    plan.excluded |= 1u << row;
+    plan.failures[row] = SNMP_POLL_EXCLUDE_CONFIRM;
+    tighter = true;
+  }
+  if (tighter) plan.probeIn = 1;
+  if (cached != 0 && cached < plan.maxVarbinds) {
+    plan.maxVarbinds = cached;
+    tighter = true;
+  }
+  if (!tighter) return;
+  packPlan(plan);
+  Serial.printf("Poll pack %s (cached): %u varbinds/PDU, %u PDUs, excluded 0x%lx\n", serial, plan.maxVarbinds,
+                plan.pduCount, (unsigned long)plan.excluded);
+}
+
+// 序列号已知时缓存学到的上限与已确认的排除，下次锁定同一台打印机直接使用
+static void storeCachedPlan(uint8_t slot) {
+  const char* serial = printers[slot].serial;
+  if (!serial[0]) return;
+  char key[12];
+  Preferences prefs;
+  prefs.begin("poll_pack", false);
+  cacheKey('s', serial, key, sizeof(key));
+  prefs.putUChar(key, plans[slot].maxVarbinds);
+  cacheKey('x', serial, key, sizeof(key));
+  prefs.putULong(key, confirmedRows(plans[slot]));
+  prefs.end();
+}
+
+// 排除 agent 报错的一个 OID (v1 noSuchName/genErr 的 errorIndex 所指项)，
+// 已排除、受保护或不在表中返回 false
+static bool excludeOid(PollPlan& plan, const char* name) {
+  const OidEntry* entry = oidLookup(name);
+  if (!entry) return false;
+  size_t row = entry - oidTable;
+  if (row >= 32 || isExcluded(plan, row) || isProtected(row)) return false;
+  plan.excluded |= 1u << row;
+  plan.failures[row] = 1;
+  return true;
+}
+
+// 对每个被排除的行单独发一个 Get (part 为 0，不计入本周期)；在途表满时其余行留到下一次复查
+static void probeExcluded(uint8_t slot) {
+  PrinterState& p = printers[slot];
+  PollPlan& plan = plans[slot];
+  for (size_t row = 0; row < oidTableSize && row < 32; row++) {
+    if (!isExcluded(plan, row)) continue;
+    int32_t requestId = inflightAdd(INFLIGHT_POLL, p.ip, SNMP_REQUEST_TIMEOUT, "probe", slot, 0);
+    if (requestId == 0) return;
+    uint8_t buf[SNMP_PDU_MAX];
+    const char* oid = oidTable[row].oid;
+    size_t len = snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_1, "public", SNMP_PDU_GET, requestId, 0, 0, &oid, 1);
+    if (len == 0 || !snmpSendRaw(p.ip, buf, len)) inflightRelease(inflightFind(requestId, p.ip));
+  }
+}
+
+void snmpPollPrepare(uint8_t slot) {
+  PollPlan& plan = plans[slot];
+  printers[slot].pollPending = 0;  // 之前 IP 的请求不再计入周期
+  plan.maxVarbinds = oidTableSize;  // 先整表一个请求，由响应学习上限
+  plan.excluded = 0;
+  memset(plan.failures, 0, sizeof(plan.failures));
+  plan.probeIn = 1;  // 缓存中已确认的排除在锁定后的首个周期复查
+  plan.cacheChecked = false;
+  packPlan(plan);
+  if (printers[slot].serial[0]) loadCachedLimit(slot);
+}
+
+void pollPrinter(uint8_t slot) {
+  uint32_t allocsBefore = allocCount();
+  PrinterState& p = printers[slot];
+  PollPlan& plan = plans[slot];
+  if (plan.pduCount == 0) snmpPollPrepare(slot);
+
+  p.pollPending = 0;
+  p.pollIncomplete = false;
+  for (uint8_t part = 0; part < plan.pduCount; part++) {
+    PollPdu& pdu = plan.pdus[part];
+    uint8_t* buf = plan.arena + pdu.offset;
+    // 以槽位号作为 owner、请求的 varbind 数作为 part 登记，响应按 request-id 写回对应的 PrinterState
+    int32_t requestId = inflightAdd(INFLIGHT_POLL, p.ip, SNMP_REQUEST_TIMEOUT, "poll", slot, pdu.oidCount);
+    if (requestId == 0) {
+      p.pollIncomplete = true;
+      continue;
+    }
+    snmpPatchRequestId(buf, pdu.idOffset, requestId);
+    if (!snmpSendRaw(p.ip, buf, pdu.len)) {
+      inflightRelease(inflightFind(requestId, p.ip));
+      p.pollIncomplete = true;
+      continue;
+    }
+    p.pollPending++;
+  }
+  if (p.pollPending == 0 && p.pollIncomplete) p.pollDropped++;
+
+  if (plan.excluded && --plan.probeIn == 0) {
+    plan.probeIn = SNMP_POLL_REPROBE;
+    probeExcluded(slot);
+  }
+
+  p.lastRequestTime = millis();  // 更新最后请求时间
+  lastAllocs = allocCount() - allocsBefore;
+}
+
+// 本周期的一个请求有了结果 (响应或超时)；全部结束且没有缺失时发布快照
+static void finishRequest(uint8_t slot, bool answered) {
+  PrinterState& p = printers[slot];
+  if (p.pollPending == 0) return;
+  if (!answered) p.pollIncomplete = true;
+  if (--p.pollPending > 0) return;
+  if (p.pollIncomplete) p.pollDropped++;
+  else printerSnapshotPublish(slot);
+}
+
+void snmpPollOnTimeout(uint8_t slot, IPAddress target, uint8_t requested) {
+  if (requested == 0) return;  // 复查超时既不确认也不恢复，下一次复查再试
+  if (slot < printerCount && printers[slot].ip == target) finishRequest(slot, false);
+}
+
+bool snmpPollOnProbe(uint8_t slot, const SNMP::Message* message) {
+  PollPlan& plan = plans[slot];
+  SNMP::VarBindList* list = message->getVarBindList();
+  if (list->count() == 0) return false;
+  const OidEntry* entry = oidLookup((*list)[0]->getName());
+  if (!entry) return false;
+  size_t row = entry - oidTable;
+  if (!isExcluded(plan, row)) return false;
+
+  const char* serial = printers[slot].serial;
+  char ip[16];
+  const char* name = serial[0] ? serial : ipToStr(printers[slot].ip, ip);
+  bool wasConfirmed = plan.failures[row] >= SNMP_POLL_EXCLUDE_CONFIRM;
+  if (message->getErrorStatus() != 0) {
+    // 仍然出错：累计到阈值时才写入 Preferences
+    if (plan.failures[row] < 255) plan.failures[row]++;
+    if (!wasConfirmed && plan.failures[row] >= SNMP_POLL_EXCLUDE_CONFIRM) {
+      Serial.printf("Poll pack %s: %s excluded (confirmed)\n", name, entry->oid);
+      storeCachedPlan(slot);
+    }
+    return false;
+  }
+
+  // 复查成功 (如更换固件或装上了对应碳粉)：恢复该行并重新打包
+  plan.excluded &= ~(1u << row);
+  plan.failures[row] = 0;
+  packPlan(plan);
+  Serial.printf("Poll pack %s: %s restored, %u PDUs, excluded 0x%lx\n", name, entry->oid, plan.pduCount,
+                (unsigned long)plan.excluded);
+  if (wasConfirmed) storeCachedPlan(slot);
+  return true;
+}
+
+bool snmpPollOnResponse(uint8_t slot, uint8_t requested, const SNMP::Message* message) {
+  // 只有无错误且返回了全部请求项的响应才算应答；tooBig、被截断或带错误状态的响应
+  // 使本周期不完整，不发布只刷新了部分字段的快照
+  unsigned int received = message->getVarBindList()->count();
+  bool complete = message->getErrorStatus() == 0 && received >= requested;
+  finishRequest(slot, complete);
+
+  PollPlan& plan = plans[slot];
+  const char* serial = printers[slot].serial;
+  if (!plan.cacheChecked && serial[0]) loadCachedLimit(slot);
+
+  // 响应可能属于重新打包前发出的请求，按登记时的请求项数判断：
+  // tooBig → 减半；无错误但返回项少于请求项 (如 Ricoh 只返回前 6 项) → 以返回项数为上限；
+  // 其他错误 (noSuchName/genErr，如该型号没有的碳粉颜色) → 排除 errorIndex 所指的 OID (只在 RAM 中，之后复查)，
+  // 没有可用的 errorIndex 时减半拆分，直到单项请求出错再排除该项，不再反复发送同一个失败的打包；
+  // 序列号与计数器行不排除，出错的周期保持不完整
+  SNMP::VarBindList* list = message->getVarBindList();
+  unsigned int errorIndex = message->getErrorIndex();
+  uint8_t limit = plan.maxVarbinds;
+  bool excluded = false;
+  if (message->getErrorStatus() == SNMP_ERR_TOO_BIG) {
+    limit = requested > 1 ? requested / 2 : 1;
+  } else if (message->getErrorStatus() != 0) {
+    if (errorIndex >= 1 && errorIndex <= received) {
+      excluded = excludeOid(plan, (*list)[errorIndex - 1]->getName());
+    } else if (requested == 1 && received == 1) {
+      excluded = excludeOid(plan, (*list)[0]->getName());
+    } else {
+      limit = requested > 1 ? requested / 2 : 1;
+    }
+  } else if (received > 0 && received < requested) {
+    limit = received;
+  }
+  if (limit >= plan.maxVarbinds && !excluded) return complete;
+
+  bool tighter = limit < plan.maxVarbinds;
+  if (tighter) plan.maxVarbinds = limit;
+  packPlan(plan);
+  char ip[16];
+  Serial.printf("Poll pack %s: %u varbinds/PDU, %u PDUs, excluded 0x%lx\n",
+                serial[0] ? serial : ipToStr(printers[slot].ip, ip), plan.maxVarbinds, plan.pduCount,
+                (unsigned long)plan.excluded);
+  if (tighter) storeCachedPlan(slot);  // 新的排除要等复查确认后才写入
+  return complete;
+}
+
+uint8_t snmpPollPduCount(uint8_t slot) {
+  return plans[slot].pduCount;
+}
+
+uint32_t pollLastAllocs() {
+  return lastAllocs;
+}
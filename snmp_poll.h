@@ -0,0 +1,43 @@
+/*
+ * snmp_poll.h - 周期轮询请求
+ *
+ * 每个打印机槽位的轮询 PDU 在锁定/配置时编码一次并缓存为字节，
+ * 每次轮询只改写 request-id 后直接交给 UDP 套接字，稳态下不分配堆内存。
+ *
+ * OID 表按 agent 能接受的 varbind 数打包成尽量少的 GetRequest：
+ * 初始整表一个请求，响应被截断 (返回项少于请求项) 或 tooBig 时缩小并重新打包；
+ * noSuchName/genErr 响应按 errorIndex 把 agent 不支持的 OID 排除出打包 (序列号与计数器行除外)。
+ * 排除先只记在 RAM 中，每 SNMP_POLL_REPROBE 个周期 (及重新锁定后的首个周期) 单独复查一次，
+ * 复查成功即恢复；连续出错 SNMP_POLL_EXCLUDE_CONFIRM 次后才与学到的上限一起按序列号缓存在 Preferences 中
+ */
+
+#ifndef SNMP_POLL_H
+#define SNMP_POLL_H
+
+#include <Arduino.h>
+#include <SNMP.h>
+
+// 为槽位编码轮询 PDU（打印机锁定或按配置加载时调用），打包上限恢复为整表
+void snmpPollPrepare(uint8_t slot);
+
+// 轮询指定槽位的打印机：按当前打包发出全部请求
+void pollPrinter(uint8_t slot);
+
+// 轮询响应（已写入 PrinterState 后调用）：requested 为该请求的 varbind 数，据此学习 agent 的上限；
+// 本周期的请求全部收到无错误、未截断的响应后发布快照 (printer_snapshot.h)
+// 返回该响应是否完整 (无错误且返回了全部请求项)
+bool snmpPollOnResponse(uint8_t slot, uint8_t requested, const SNMP::Message* message);
+
+// 被排除 OID 的单项复查响应 (requested 为 0 的轮询请求)：返回该 OID 是否已恢复，恢复时调用方写入其值
+bool snmpPollOnProbe(uint8_t slot, const SNMP::Message* message);
+
+// 轮询请求超时：本周期不再发布快照 (复查请求超时不计)
+void snmpPollOnTimeout(uint8_t slot, IPAddress target, uint8_t requested);
+
+// 当前每次轮询发出的请求数
+uint8_t snmpPollPduCount(uint8_t slot);
+
+// 上一次 pollPrinter 期间的 operator new 次数（稳态应为 0）
+uint32_t pollLastAllocs();
+
+#endif  // SNMP_POLL_H
@@ -0,0 +1,105 @@
+/*
+ * snmp_task.cpp - SNMP 任务实现
+ *
+ * 每次循环：处理 loop 任务投递的命令 -> SNMP 收包 -> 在途超时 -> 扫描 -> 轮询 -> 看门狗，
+ * 然后让出 1 个 tick。扫描的突发节奏 (SCAN_BURST_INTERVAL) 与连接超时都以毫秒计，不受影响
+ */
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <atomic>
+#include "snmp_task.h"
+#include "config.h"
+#include "globals.h"
+#include "snmp_handler.h"
+#include "printer_monitor.h"
+#include "spsc_queue.h"
+#include "metrics.h"
+#include "profiler.h"
+#include "sim.h"
+
+struct SnmpCommand {
+  SnmpCommandType type;
+  char payload[OID_REQUEST_MAX];
+};
+
+static SpscQueue<SnmpCommand, SNMP_COMMAND_QUEUE> commands;
+static TaskHandle_t task = nullptr;
+static std::atomic<uint32_t> maxLoopUs{0};
+
+static void runCommand(const SnmpCommand& cmd) {
+  switch (cmd.type) {
+    case SNMP_CMD_OID_REQUEST:
+      sendSNMPOidRequest(cmd.payload);
+      break;
+    case SNMP_CMD_POLL_RESET:
+      printerPollReset();
+      break;
+  }
+}
+
+static void snmpTask(void*) {
+  for (;;) {
+    uint32_t start = micros();
+    profBegin(PROF_TASK_SNMP);
+
+    while (SnmpCommand* cmd = commands.front()) {
+      runCommand(*cmd);
+      commands.pop();
+    }
+    profStage(STAGE_SNMP_CMD);
+
+    snmp.loop();        // 处理 SNMP 消息
+    simLoop();          // 投递模拟网段的响应 (SIM_ENABLED)
+    profStage(STAGE_SNMP_RECV);
+    snmpRequestLoop();  // 在途 SNMP 请求超时处理
+    profStage(STAGE_SNMP_TIMEOUT);
+
+    if (isScanning) {     // 如果正在扫描模式，执行扫描循环
+      processScanLoop();  // 扫描模式处理
+      profStage(STAGE_SCAN);
+    }
+
+    printerSNMPLoop();  // 定时 SNMP 请求
+    profStage(STAGE_POLL);
+    printerWatchdog();  // 打印机看门狗检测
+    printerStatusLoop();  // 发布轮询状态 (Web 不直接读 PrinterState)
+    profStage(STAGE_WATCHDOG);
+    profEnd(PROF_TASK_SNMP);
+
+    uint32_t us = micros() - start;
+    metricsObserve(HIST_SNMP_LOOP, us);
+    if (us > maxLoopUs.load(std::memory_order_relaxed)) maxLoopUs.store(us, std::memory_order_relaxed);
+    vTaskDelay(1);
+  }
+}
+
+void snmpTaskStart() {
+  if (task) return;
+  xTaskCreatePinnedToCore(snmpTask, "snmp", SNMP_TASK_STACK, nullptr, SNMP_TASK_PRIORITY, &task, SNMP_TASK_CORE);
+}
+
+bool snmpTaskPost(SnmpCommandType type, const char* payload, size_t len) {
+  if (len >= OID_REQUEST_MAX) {
+    Serial.printf("SNMP command too large (%u bytes), dropped\n", (unsigned)len);
+    return false;
+  }
+  SnmpCommand* cmd = commands.back();
+  if (!cmd) {
+    Serial.println("SNMP command queue full, dropped");
+    return false;
+  }
+  cmd->type = type;
+  if (payload) memcpy(cmd->payload, payload, len);
+  cmd->payload[payload ? len : 0] = '\0';
+  commands.push();
+  return true;
+}
+
+uint32_t snmpTaskTakeMaxUs() {
+  return maxLoopUs.exchange(0, std::memory_order_relaxed);
+}
+
+uint32_t snmpTaskStackFree() {
+  return task ? uxTaskGetStackHighWaterMark(task) : 0;
+}
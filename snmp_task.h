@@ -0,0 +1,35 @@
+/*
+ * snmp_task.h - SNMP 任务
+ *
+ * SNMP 收发、在途请求超时、扫描、周期轮询与看门狗运行在独立的 FreeRTOS 任务中 (SNMP_TASK_CORE)，
+ * Arduino loop 任务只处理 Web、MQTT 与 LED。扫描连接、看门狗的 9100 检测等慢操作不再拖慢
+ * MQTT 命令 (如 lock/unlock)，OTA 下载期间轮询也不中断。
+ *
+ * 两个任务之间只通过单生产者/单消费者队列通信：
+ *   loop -> SNMP  命令队列 (OID 查询请求、轮询间隔复位)，见 snmpTaskPost
+ *   SNMP -> loop  OID 查询结果队列，见 snmp_handler.h 的 pushOidResult / peekOidResult
+ */
+
+#ifndef SNMP_TASK_H
+#define SNMP_TASK_H
+
+#include <Arduino.h>
+
+enum SnmpCommandType : uint8_t {
+  SNMP_CMD_OID_REQUEST,  // MQTT OID 查询/遍历请求，payload 为原始 JSON
+  SNMP_CMD_POLL_RESET,   // 收到 lock/unlock，所有打印机回到最小轮询间隔
+};
+
+// 启动 SNMP 任务（setup 末尾调用，此后上述函数只在 SNMP 任务中运行）
+void snmpTaskStart();
+
+// 向 SNMP 任务投递命令；只能从 loop 任务调用 (单生产者)。队列满或 payload 过长返回 false
+bool snmpTaskPost(SnmpCommandType type, const char* payload = nullptr, size_t len = 0);
+
+// SNMP 任务单次循环的最长耗时 (微秒)，读取后清零
+uint32_t snmpTaskTakeMaxUs();
+
+// SNMP 任务栈剩余的最小值 (字节)
+uint32_t snmpTaskStackFree();
+
+#endif  // SNMP_TASK_H
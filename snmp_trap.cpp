@@ -0,0 +1,78 @@
+/*
+ * snmp_trap.cpp - SNMP trap/inform 接收实现
+ *
+ * 去抖：窗口外的第一个 trap 立即触发轮询，窗口内后续的 trap 合并为窗口结束时的一次补充轮询，
+ * 连续的作业完成 trap 既能及时上报，又不会每个 trap 都发一轮请求
+ */
+
+#include "snmp_trap.h"
+#include "config.h"
+#include "globals.h"
+#include "snmp_pdu.h"
+
+#define SNMP_TRAP_ACK_OIDS 16  // Inform 应答回显的最大 varbind 数
+
+// Inform 需要回 Response：相同 request-id 与 varbind 名称，发回来源端口
+static void ackInform(const SNMP::Message* message, IPAddress remote, uint16_t port) {
+  SNMP::VarBindList* list = message->getVarBindList();
+  const char* oids[SNMP_TRAP_ACK_OIDS];
+  size_t count = 0;
+  for (unsigned int i = 0; i < list->count() && count < SNMP_TRAP_ACK_OIDS; i++) {
+    oids[count++] = (*list)[i]->getName();
+  }
+
+  uint8_t buf[SNMP_PDU_MAX];
+  const char* community = message->getCommunity();
+  size_t len = snmpEncodeRequest(buf, sizeof(buf), message->getVersion(), community ? community : "public",
+                                 SNMP_PDU_RESPONSE, message->getRequestID(), 0, 0, oids, count);
+  // varbind 过多放不下时只回 request-id，多数管理端只按 request-id 确认
+  if (len == 0) {
+    len = snmpEncodeRequest(buf, sizeof(buf), message->getVersion(), community ? community : "public",
+                            SNMP_PDU_RESPONSE, message->getRequestID(), 0, 0, oids, 0);
+  }
+  if (len) snmpSendRaw(remote, buf, len, port);
+}
+
+bool snmpTrapHandle(const SNMP::Message* message, IPAddress remote, uint16_t port) {
+  uint8_t type = message->getType();
+  if (type != SNMP::Type::Trap && type != SNMP::Type::SNMPv2Trap && type != SNMP::Type::InformRequest) return false;
+
+  if (type == SNMP::Type::InformRequest) ackInform(message, remote, port);
+
+  // 只接受已监控 (且不在扫描中) 的打印机发来的 trap
+  int slot = -1;
+  for (int i = 0; i < printerCount; i++) {
+    if (printers[i].ip == remote && printers[i].ip[0] != 0 && !(i == 0 && isScanning)) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0) {
+    char ip[16];
+    Serial.printf("SNMP trap from %s ignored (not monitored)\n", ipToStr(remote, ip));
+    return true;
+  }
+
+  PrinterState& p = printers[slot];
+  unsigned long now = millis();
+  p.trapCount++;
+  if (p.trapAt == 0) p.trapAt = now;
+
+  // 下一次轮询提前到现在 (窗口外) 或窗口结束时 (窗口内)，并按活跃状态缩短间隔
+  unsigned long pollAt = now;
+  if (p.trapPollAt != 0 && now - p.trapPollAt < SNMP_TRAP_DEBOUNCE) pollAt = p.trapPollAt + SNMP_TRAP_DEBOUNCE;
+  if ((long)(pollAt - p.nextPollAt) < 0) {
+    p.nextPollAt = pollAt;
+    p.trapPollAt = pollAt;
+  }
+  p.pollInterval = SNMP_INTERVAL_MIN;
+  p.pollIdle = 0;
+  return true;
+}
+
+void snmpTrapPublished(uint8_t slot, unsigned long trapAt, const char* serial) {
+  if (trapAt == 0 || slot >= MAX_PRINTERS) return;
+  unsigned long latency = millis() - trapAt;
+  printerPublish[slot].trapLatency = latency;
+  Serial.printf("Trap -> publish %s: %lu ms\n", serial, latency);
+}
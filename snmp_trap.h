@@ -0,0 +1,21 @@
+/*
+ * snmp_trap.h - SNMP trap/inform 接收
+ *
+ * SNMP 管理器已绑定 UDP 162，trap 与轮询响应一样交给 onSNMPMessage；
+ * 来自已监控打印机的 trap 经去抖后触发一次计划外的计数器/碳粉轮询，并记录 trap 到数据发布的耗时
+ */
+
+#ifndef SNMP_TRAP_H
+#define SNMP_TRAP_H
+
+#include <Arduino.h>
+#include <SNMP.h>
+
+// 处理 Trap / SNMPv2-Trap / InformRequest；不是 trap 类消息时返回 false
+bool snmpTrapHandle(const SNMP::Message* message, IPAddress remote, uint16_t port);
+
+// 数据发布时调用 (loop 任务)：trapAt 为所发布快照的 PrinterSnapshot::trapAt，非 0 时记录 trap→发布耗时
+// trap 到达时间只由 SNMP 任务写入并随快照交出，两个任务不共享可写字段
+void snmpTrapPublished(uint8_t slot, unsigned long trapAt, const char* serial);
+
+#endif  // SNMP_TRAP_H
@@ -0,0 +1,103 @@
+/*
+ * snmp_varbind.cpp - 响应 varbind 的分发与格式化实现
+ *
+ * 只依赖 OID 表与 SNMP 库的值类型，不涉及任务、队列与网络；主机构建 (host/) 与固件编译同一份
+ */
+
+#include "snmp_varbind.h"
+#include <cstdlib>
+#include <cstring>
+#include "oid_table.h"
+
+size_t snmpValueFormat(SNMP::BER* value, char* buf, size_t size) {
+  if (size == 0) return 0;
+  buf[0] = '\0';
+  if (!value) return 0;
+  int n = 0;
+  switch (value->getType()) {
+    case SNMP::Type::OctetString:
+      n = snprintf(buf, size, "%s", static_cast<SNMP::OctetStringBER*>(value)->getValue());
+      break;
+    case SNMP::Type::Integer:
+      n = snprintf(buf, size, "%ld", (long)static_cast<SNMP::IntegerBER*>(value)->getValue());
+      break;
+    case SNMP::Type::Counter32:
+      n = snprintf(buf, size, "%lu", (unsigned long)static_cast<SNMP::Counter32BER*>(value)->getValue());
+      break;
+    case SNMP::Type::Gauge32:
+      n = snprintf(buf, size, "%lu", (unsigned long)static_cast<SNMP::Gauge32BER*>(value)->getValue());
+      break;
+    case SNMP::Type::TimeTicks:
+      n = snprintf(buf, size, "%lu", (unsigned long)static_cast<SNMP::TimeTicksBER*>(value)->getValue());
+      break;
+    case SNMP::Type::Counter64:
+      n = snprintf(buf, size, "%llu", (unsigned long long)static_cast<SNMP::Counter64BER*>(value)->getValue());
+      break;
+    case SNMP::Type::ObjectIdentifier:
+      n = snprintf(buf, size, "%s", static_cast<SNMP::ObjectIdentifierBER*>(value)->getValue());
+      break;
+    case SNMP::Type::IPAddress: {
+      if (size < 16) return 0;
+      ipToStr(static_cast<SNMP::IPAddressBER*>(value)->getValue(), buf);
+      return strlen(buf);
+    }
+    case SNMP::Type::NoSuchObject:
+      n = snprintf(buf, size, "noSuchObject");
+      break;
+    case SNMP::Type::NoSuchInstance:
+      n = snprintf(buf, size, "noSuchInstance");
+      break;
+    case SNMP::Type::EndOfMIBView:
+      n = snprintf(buf, size, "endOfMibView");
+      break;
+    default:
+      return 0;
+  }
+  if (n < 0) return 0;
+  return (size_t)n < size ? n : size - 1;
+}
+
+// 将 SNMP BER 值转为整数（碳粉可能以 OctetString 如 "100" 返回），类型不支持返回 false
+static bool snmpValueToInt(SNMP::BER* value, int* out) {
+  switch (value->getType()) {
+    case SNMP::Type::OctetString:
+      *out = atoi(static_cast<SNMP::OctetStringBER*>(value)->getValue());
+      return true;
+    case SNMP::Type::Integer:
+      *out = static_cast<SNMP::IntegerBER*>(value)->getValue();
+      return true;
+    case SNMP::Type::Counter32:
+      *out = static_cast<SNMP::Counter32BER*>(value)->getValue();
+      return true;
+    case SNMP::Type::Gauge32:
+      *out = static_cast<SNMP::Gauge32BER*>(value)->getValue();
+      return true;
+    default:
+      return false;
+  }
+}
+
+int snmpApplyVarbinds(PrinterState& p, SNMP::VarBindList* varbindlist) {
+  int applied = 0;
+  // 遍历所有变量绑定，按 OID 表分发每个值
+  for (unsigned int index = 0; index < varbindlist->count(); ++index) {
+    SNMP::VarBind* varbind = (*varbindlist)[index];
+    SNMP::BER* value = varbind->getValue();  // OID 的值
+    if (!value) continue;
+
+    const OidEntry* entry = oidLookup(varbind->getName());
+    if (!entry) continue;
+
+    if (entry->kind == OID_KIND_SERIAL) {
+      if (value->getType() != SNMP::Type::OctetString) continue;
+      strlcpy(p.serial, static_cast<SNMP::OctetStringBER*>(value)->getValue(), sizeof(p.serial));
+      applied++;
+    } else {
+      int val;
+      if (!snmpValueToInt(value, &val)) continue;
+      p.*(entry->dest) = val;
+      applied++;
+    }
+  }
+  return applied;
+}
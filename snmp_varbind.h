@@ -0,0 +1,22 @@
+/*
+ * snmp_varbind.h - 响应 varbind 的分发与格式化
+ *
+ * 轮询响应按 OID 表写入 PrinterState，OID 查询/遍历结果格式化为字符串；
+ * onSNMPMessage、SNMP 响应基准 (snmp_bench.h) 与主机构建共用
+ */
+
+#ifndef SNMP_VARBIND_H
+#define SNMP_VARBIND_H
+
+#include <Arduino.h>
+#include <SNMP.h>
+#include "globals.h"
+
+// 按 OID 表把轮询响应的各个值写入 p (序列号、计数器、碳粉)，返回写入的值个数
+// 只读写 p，不依赖打印机槽位
+int snmpApplyVarbinds(PrinterState& p, SNMP::VarBindList* varbindlist);
+
+// 将 SNMP BER 值格式化到 buf（OID 查询/遍历结果使用），截断到 size-1，返回写入的长度
+size_t snmpValueFormat(SNMP::BER* value, char* buf, size_t size);
+
+#endif  // SNMP_VARBIND_H
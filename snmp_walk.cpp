@@ -0,0 +1,264 @@
+/*
+ * snmp_walk.cpp - SNMP 子树遍历实现
+ *
+ * 流水线：收到一批结果后先算出本批的实际分块数、归还多余的预留空位，发出下一个 GetBulk/GetNext，
+ * 再序列化并入队本批结果，让 agent 处理下一批与本地分块/MQTT 发送重叠。
+ * 每个请求发出前按一批的最坏分块数 (每个 varbind 一块，再加结束块) 预留结果队列空位，
+ * MQTT 断线、队列不再消费时不会丢块或丢失结束块；空位不足时暂停，由 snmpWalkLoop 继续。
+ *
+ * 分块格式 (printer/oid/{MAC})：
+ *   {"requestId","seq":n,"results":{"oid":"val",...}}
+ *   {"requestId","seq":n,"done":true,"count":N}              // 最后一块，可能带 "error" / "truncated"
+ */
+
+#include "snmp_walk.h"
+#include "config.h"
+#include "snmp_handler.h"
+#include "snmp_inflight.h"
+#include "snmp_pdu.h"
+#include "metrics.h"
+
+static_assert(OID_RESULT_QUEUE >= SNMP_WALK_BULK + 1, "OID_RESULT_QUEUE 需容纳一批 GetBulk 的最坏分块数与结束块");
+
+struct WalkState {
+  bool active;
+  bool paused;         // 等待结果队列或在途表空位
+  bool useV1;          // agent 不应答 v2c，改用 v1 GetNext
+  uint8_t retries;     // 当前请求已重试次数
+  uint8_t reserved;    // 为在途请求预留、尚未使用的结果队列空位
+  IPAddress target;
+  char requestId[40];  // MQTT 侧 requestId
+  char root[64];       // 遍历的子树根
+  char lastOid[128];   // 最后返回的 OID，下一个请求从此继续
+  uint16_t seq;        // 下一个分块序号
+  uint16_t count;      // 已返回的 varbind 数
+};
+
+static WalkState walks[SNMP_WALK_MAX];
+
+// OID 是否位于 root 子树内
+static bool inSubtree(const WalkState& w, const char* oid) {
+  size_t n = strlen(w.root);
+  return strncmp(oid, w.root, n) == 0 && oid[n] == '.';
+}
+
+// 按弧逐段数值比较两个点分 OID：a<b 返回负数，相等返回 0，a>b 返回正数 (前缀较短者更小)
+static int oidCompare(const char* a, const char* b) {
+  while (*a && *b) {
+    char* endA;
+    char* endB;
+    unsigned long arcA = strtoul(a, &endA, 10);
+    unsigned long arcB = strtoul(b, &endB, 10);
+    if (arcA != arcB) return arcA < arcB ? -1 : 1;
+    if (endA == a || endB == b) break;  // 非数字弧，无法继续解析
+    a = *endA == '.' ? endA + 1 : endA;
+    b = *endB == '.' ? endB + 1 : endB;
+  }
+  return (*a != 0) - (*b != 0);
+}
+
+// 一个请求的结果最多占用的队列空位：每个 varbind 至少一块，另加结束块
+static uint8_t batchSlots(const WalkState& w) {
+  return (w.useV1 ? 1 : SNMP_WALK_BULK) + 1;
+}
+
+// 使用预留的空位入队
+static void pushReserved(uint8_t& reserved, JsonDocument& doc) {
+  bool hasSlot = reserved > 0;
+  if (hasSlot) reserved--;
+  pushOidResult(doc, hasSlot);
+}
+
+// 发出最后一块并结束遍历，归还剩余的预留空位
+static void finishWalk(WalkState& w, const char* error = nullptr, bool truncated = false) {
+  StaticJsonDocument<160> doc;
+  doc["requestId"] = w.requestId;
+  doc["seq"] = w.seq++;
+  doc["done"] = true;
+  doc["count"] = w.count;
+  if (error) doc["error"] = error;
+  if (truncated) doc["truncated"] = true;
+  pushReserved(w.reserved, doc);
+  oidResultRelease(w.reserved);
+  w.reserved = 0;
+  Serial.printf("SNMP walk %s done: %u varbinds, %u chunks%s\n", w.root, w.count, w.seq, error ? " (error)" : "");
+  w.active = false;
+}
+
+// 从 lastOid 继续请求下一批；在途表满或结果队列空位不足时暂停 (调用时不持有预留空位)
+static void sendNext(uint8_t slot) {
+  WalkState& w = walks[slot];
+  w.paused = true;
+  uint8_t slots = batchSlots(w);
+  if (!oidResultReserve(slots)) return;
+
+  int32_t requestId = inflightAdd(INFLIGHT_WALK, w.target, SNMP_REQUEST_TIMEOUT, w.requestId, slot);
+  if (requestId == 0) {
+    oidResultRelease(slots);
+    return;
+  }
+  w.reserved = slots;
+
+  uint8_t buf[SNMP_PDU_MAX];
+  const char* oid = w.lastOid;
+  size_t len = w.useV1
+                 ? snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_1, "public", SNMP_PDU_GETNEXT, requestId, 0, 0, &oid, 1)
+                 : snmpEncodeRequest(buf, sizeof(buf), SNMP_VERSION_2C, "public", SNMP_PDU_GETBULK, requestId, 0, SNMP_WALK_BULK, &oid, 1);
+  if (len == 0) {
+    inflightRelease(inflightFind(requestId, w.target));
+    finishWalk(w, "bad oid");
+    return;
+  }
+  if (!snmpSendRaw(w.target, buf, len)) {
+    inflightRelease(inflightFind(requestId, w.target));
+    oidResultRelease(w.reserved);
+    w.reserved = 0;
+    return;  // 发送失败，保持暂停，下一轮再试
+  }
+  w.paused = false;
+}
+
+const char* startSNMPWalk(IPAddress target, const char* requestId, const char* root) {
+  // 截断后会遍历另一个 (上级) 子树并当作所请求的子树上报，过长的根直接拒绝
+  if (strlen(root) >= sizeof(WalkState::root)) return "root too long";
+  for (uint8_t slot = 0; slot < SNMP_WALK_MAX; slot++) {
+    WalkState& w = walks[slot];
+    if (w.active) continue;
+    w = {};
+    w.active = true;
+    w.target = target;
+    strlcpy(w.requestId, requestId, sizeof(w.requestId));
+    strlcpy(w.root, root, sizeof(w.root));
+    strlcpy(w.lastOid, root, sizeof(w.lastOid));
+    sendNext(slot);
+    return nullptr;
+  }
+  return "busy";
+}
+
+// 把本批前 usable 个 varbind 按 OID_RESULT_MAX 分块，返回块数；
+// held 为 nullptr 时只计算块数 (不入队、不推进 seq/count)，否则使用 *held 中预留的空位入队
+static unsigned int chunkBatch(WalkState& w, SNMP::VarBindList* list, unsigned int usable, uint8_t* held) {
+  StaticJsonDocument<768> doc;
+  JsonObject results;
+  char value[SNMP_VALUE_MAX];
+  unsigned int chunks = 0;
+  uint16_t seq = w.seq;
+  for (unsigned int i = 0; i < usable; i++) {
+    SNMP::VarBind* vb = (*list)[i];
+    size_t valueLen = snmpValueFormat(vb->getValue(), value, sizeof(value));
+    // 接近 OID_RESULT_MAX 时先发出当前块
+    if (!results.isNull() && results.size() > 0
+        && measureJson(doc) + strlen(vb->getName()) + valueLen + 8 >= OID_RESULT_MAX) {
+      if (held) pushReserved(*held, doc);
+      chunks++;
+      results = JsonObject();
+    }
+    if (results.isNull()) {
+      doc.clear();
+      doc["requestId"] = w.requestId;
+      doc["seq"] = seq++;
+      results = doc.createNestedObject("results");
+    }
+    results[vb->getName()] = value;
+  }
+  if (!results.isNull() && results.size() > 0) {
+    if (held) pushReserved(*held, doc);
+    chunks++;
+  }
+  if (held) {
+    w.seq = seq;
+    w.count += usable;
+  }
+  return chunks;
+}
+
+void snmpWalkOnResponse(uint8_t slot, const SNMP::Message* message) {
+  if (slot >= SNMP_WALK_MAX || !walks[slot].active) return;
+  WalkState& w = walks[slot];
+  w.retries = 0;
+  // 本批使用该请求预留的空位；流水线发出的下一个请求另行预留
+  uint8_t held = w.reserved;
+  w.reserved = 0;
+
+  if (message->getErrorStatus() != 0) {
+    w.reserved = held;
+    // v1 GetNext 越过 MIB 末尾时返回 noSuchName(2)，视为正常结束
+    if (w.useV1 && message->getErrorStatus() == 2) finishWalk(w);
+    else finishWalk(w, "snmp error");
+    return;
+  }
+
+  // 统计本批中位于子树内、且严格递增的 varbind (超出预留块数的部分由下一批重新请求)
+  // OID 不递增说明 agent 有环或乱序，继续请求可能永不结束，以错误结束遍历
+  SNMP::VarBindList* list = message->getVarBindList();
+  unsigned int usable = 0;
+  bool ended = list->count() == 0;
+  bool disorder = false;
+  const char* prev = w.lastOid;
+  for (unsigned int i = 0; i < list->count() && usable + 1u < held; i++) {
+    SNMP::VarBind* vb = (*list)[i];
+    SNMP::BER* value = vb->getValue();
+    const char* name = vb->getName();
+    if (!value || value->getType() == SNMP::Type::EndOfMIBView || !inSubtree(w, name)) {
+      ended = true;
+      break;
+    }
+    if (oidCompare(name, prev) <= 0) {
+      ended = disorder = true;
+      break;
+    }
+    prev = name;
+    usable++;
+  }
+  bool truncated = w.count + usable >= SNMP_WALK_MAX_VARBINDS;
+  if (truncated) usable = SNMP_WALK_MAX_VARBINDS - w.count;
+
+  // 先发出下一批请求，再序列化本批：本批只保留实际分块数的空位，其余先归还给下一个请求
+  // (典型的 GetBulk 批只有 1～2 块，队列容得下两批的预留)
+  bool more = !ended && !truncated && usable > 0;
+  const char* next = more ? (*list)[usable - 1]->getName() : nullptr;
+  bool oidTooLong = next && strlen(next) >= sizeof(w.lastOid);
+  if (oidTooLong) more = false;  // 截断的 OID 无法从原位置继续，发完本批后以错误结束
+  if (more) {
+    unsigned int chunks = chunkBatch(w, list, usable, nullptr);
+    oidResultRelease(held - chunks);
+    held = chunks;
+    strlcpy(w.lastOid, next, sizeof(w.lastOid));
+    sendNext(slot);
+  }
+
+  chunkBatch(w, list, usable, &held);
+
+  if (more) {
+    oidResultRelease(held);
+  } else {
+    w.reserved = held;
+    finishWalk(w, disorder ? "oid not increasing" : oidTooLong ? "oid too long" : nullptr, truncated);
+  }
+}
+
+void snmpWalkOnTimeout(uint8_t slot) {
+  if (slot >= SNMP_WALK_MAX || !walks[slot].active) return;
+  WalkState& w = walks[slot];
+  if (w.retries < SNMP_WALK_RETRIES) {
+    w.retries++;
+    metricsCount(CNT_SNMP_RETRY);
+  } else if (!w.useV1 && w.count == 0) {
+    // 首个 GetBulk 无应答：agent 可能只支持 v1，改用 GetNext
+    w.useV1 = true;
+    w.retries = 0;
+  } else {
+    finishWalk(w, "timeout");
+    return;
+  }
+  oidResultRelease(w.reserved);
+  w.reserved = 0;
+  sendNext(slot);
+}
+
+void snmpWalkLoop() {
+  for (uint8_t slot = 0; slot < SNMP_WALK_MAX; slot++) {
+    if (walks[slot].active && walks[slot].paused) sendNext(slot);
+  }
+}
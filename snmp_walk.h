@@ -0,0 +1,27 @@
+/*
+ * snmp_walk.h - SNMP 子树遍历 (walk)
+ *
+ * server/oid/{MAC} 收到 {"requestId","walk":"1.3.6.1.2.1.43.11"} 时遍历该子树：
+ * 优先 v2c GetBulk，agent 不应答时回退 v1 GetNext；结果按序号分块发到 printer/oid/{MAC}，
+ * 最后一块带 "done":true
+ */
+
+#ifndef SNMP_WALK_H
+#define SNMP_WALK_H
+
+#include <Arduino.h>
+#include <SNMP.h>
+
+// 开始遍历 root 子树，成功返回 nullptr；并发遍历数已满返回 "busy"，root 过长返回 "root too long"
+const char* startSNMPWalk(IPAddress target, const char* requestId, const char* root);
+
+// 收到遍历请求的响应（slot 为在途表登记时的 owner）
+void snmpWalkOnResponse(uint8_t slot, const SNMP::Message* message);
+
+// 遍历请求超时：重试、回退 v1 或结束
+void snmpWalkOnTimeout(uint8_t slot);
+
+// 结果队列有空位时继续被暂停的遍历（每次 loop 调用）
+void snmpWalkLoop();
+
+#endif  // SNMP_WALK_H
@@ -0,0 +1,67 @@
+/*
+ * spsc_queue.h - 单生产者/单消费者无锁队列
+ *
+ * 用于任务之间传递消息：一端只有一个任务写入，另一端只有一个任务读取。
+ * head 只由消费者修改，tail 只由生产者修改，两端各自用 acquire/release 读取对方的下标，无需加锁。
+ * 元素原地写入/读取：生产者 back() 取空槽填好后 push()，消费者 front() 处理完后 pop()
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+ public:
+  // --- 生产者 ---
+  // 下一个可写入的槽位，队列满时返回 nullptr
+  T* back() {
+    uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == N) return nullptr;
+    return &items_[tail & (N - 1)];
+  }
+
+  // 提交 back() 返回的槽位
+  void push() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // 复制一个元素入队，队列满时返回 false
+  bool push(const T& item) {
+    T* slot = back();
+    if (!slot) return false;
+    *slot = item;
+    push();
+    return true;
+  }
+
+  // 剩余空位 (生产者调用时为下限，消费者可能随时腾出更多)
+  size_t free() const {
+    return N - (tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire));
+  }
+
+  // --- 消费者 ---
+  // 最早入队的元素，队列空时返回 nullptr
+  T* front() {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (tail_.load(std::memory_order_acquire) == head) return nullptr;
+    return &items_[head & (N - 1)];
+  }
+
+  // 释放 front() 返回的元素
+  void pop() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+ private:
+  T items_[N];
+  std::atomic<uint32_t> head_{0};  // 下一个待读取，只由消费者写
+  std::atomic<uint32_t> tail_{0};  // 下一个待写入，只由生产者写
+};
+
+#endif  // SPSC_QUEUE_H
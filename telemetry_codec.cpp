@@ -0,0 +1,123 @@
+/*
+ * telemetry_codec.cpp - 打印机计数数据编码实现
+ *
+ * CBOR 只用到无符号/负整数、数组与 map 头，手写编码器即可，不分配堆内存
+ */
+
+#include "telemetry_codec.h"
+#include <ArduinoJson.h>
+
+// --- CBOR 写出 (RFC 8949) ---
+struct CborWriter {
+  uint8_t* buf;
+  size_t cap;
+  size_t pos;
+
+  void byte(uint8_t b) {
+    if (pos < cap) buf[pos] = b;
+    pos++;
+  }
+  // 类型头：major 为主类型 (0 无符号, 1 负数, 4 数组, 5 map)，v 为值或长度
+  void head(uint8_t major, uint32_t v) {
+    major <<= 5;
+    if (v < 24) {
+      byte(major | v);
+    } else if (v < 0x100) {
+      byte(major | 24);
+      byte(v);
+    } else if (v < 0x10000) {
+      byte(major | 25);
+      byte(v >> 8);
+      byte(v);
+    } else {
+      byte(major | 26);
+      byte(v >> 24);
+      byte(v >> 16);
+      byte(v >> 8);
+      byte(v);
+    }
+  }
+  void integer(int32_t v) {
+    if (v >= 0) head(0, v);
+    else head(1, (uint32_t)(-(v + 1)));
+  }
+};
+
+uint32_t telemetryTimestamp() {
+  time_t now = time(nullptr);
+  return now > 1600000000 ? (uint32_t)now : 0;  // 未校时的时钟从 1970 年开始
+}
+
+void telemetryFromPrinter(const PrinterSnapshot& p, TelemetrySample& s) {
+  s.ts = telemetryTimestamp();
+  s.st = p.val_SysTotal;
+  s.colCopies = p.val_ColCopies;
+  s.bwCopies = p.val_BWCopies;
+  s.colPrints = p.val_ColPrints;
+  s.bwPrints = p.val_BWPrints;
+  s.toner[0] = p.val_TonerBlack;
+  s.toner[1] = p.val_TonerCyan;
+  s.toner[2] = p.val_TonerRed;
+  s.toner[3] = p.val_TonerYellow;
+}
+
+size_t telemetryEncodeJson(const TelemetrySample& s, const char* mac, const char* serial, char* buf, size_t cap) {
+  StaticJsonDocument<256> doc;
+  doc["mac"] = mac;
+  doc["st"] = s.st;
+  doc["serial"] = serial;
+  doc["col_copies"] = s.colCopies;
+  doc["bw_copies"] = s.bwCopies;
+  doc["col_prints"] = s.colPrints;
+  doc["bw_prints"] = s.bwPrints;
+  doc["toner_black"] = s.toner[0];
+  doc["toner_cyan"] = s.toner[1];
+  doc["toner_red"] = s.toner[2];
+  doc["toner_yellow"] = s.toner[3];
+  if (measureJson(doc) >= cap) return 0;
+  return serializeJson(doc, buf, cap);
+}
+
+size_t telemetryEncodeCbor(const TelemetrySample& s, uint8_t* buf, size_t cap) {
+  CborWriter w = { buf, cap, 0 };
+  w.head(5, s.ts ? 8 : 7);
+  w.head(0, TELEMETRY_KEY_SCHEMA);
+  w.head(0, TELEMETRY_SCHEMA);
+  w.head(0, TELEMETRY_KEY_ST);
+  w.integer(s.st);
+  w.head(0, TELEMETRY_KEY_COL_COPIES);
+  w.integer(s.colCopies);
+  w.head(0, TELEMETRY_KEY_BW_COPIES);
+  w.integer(s.bwCopies);
+  w.head(0, TELEMETRY_KEY_COL_PRINTS);
+  w.integer(s.colPrints);
+  w.head(0, TELEMETRY_KEY_BW_PRINTS);
+  w.integer(s.bwPrints);
+  w.head(0, TELEMETRY_KEY_TONER);
+  w.head(4, 4);
+  for (int8_t t : s.toner) w.integer(t);
+  if (s.ts) {
+    w.head(0, TELEMETRY_KEY_TS);
+    w.head(0, s.ts);  // 无符号 (主类型 0)，经 int32 转换会在 2038 年后变为负数
+  }
+  return w.pos <= cap ? w.pos : 0;
+}
+
+void telemetryBenchmark() {
+  const int rounds = 1000;
+  TelemetrySample s = { 0, 1234567, 23456, 345678, 45678, 567890, { 85, 60, 42, 100 } };
+  char json[256];
+  uint8_t cbor[64];
+  size_t jsonLen = 0, cborLen = 0;
+
+  uint32_t start = micros();
+  for (int i = 0; i < rounds; i++) jsonLen = telemetryEncodeJson(s, "AA:BB:CC:DD:EE:FF", "E123M456789", json, sizeof(json));
+  uint32_t jsonUs = micros() - start;
+
+  start = micros();
+  for (int i = 0; i < rounds; i++) cborLen = telemetryEncodeCbor(s, cbor, sizeof(cbor));
+  uint32_t cborUs = micros() - start;
+
+  Serial.printf("Telemetry bench: JSON %u bytes %.2f us, CBOR %u bytes %.2f us (x%d)\n",
+                (unsigned)jsonLen, jsonUs / (float)rounds, (unsigned)cborLen, cborUs / (float)rounds, rounds);
+}
@@ -0,0 +1,51 @@
+/*
+ * telemetry_codec.h - 打印机计数数据编码
+ *
+ * 同一份采样可编码为现有 JSON (printer/{MAC}/data) 或紧凑 CBOR (printer/{MAC}/cdata)。
+ * CBOR 格式见 README「紧凑数据格式」：整数键的 map，不含 MAC (已在主题中) 与序列号
+ */
+
+#ifndef TELEMETRY_CODEC_H
+#define TELEMETRY_CODEC_H
+
+#include <Arduino.h>
+#include "printer_snapshot.h"
+
+#define TELEMETRY_SCHEMA 1  // CBOR 格式版本 (键 0)
+
+// --- CBOR map 键 ---
+#define TELEMETRY_KEY_SCHEMA 0
+#define TELEMETRY_KEY_ST 1
+#define TELEMETRY_KEY_COL_COPIES 2
+#define TELEMETRY_KEY_BW_COPIES 3
+#define TELEMETRY_KEY_COL_PRINTS 4
+#define TELEMETRY_KEY_BW_PRINTS 5
+#define TELEMETRY_KEY_TONER 6  // [黑, 青, 红, 黄]，-1 表示未读取
+#define TELEMETRY_KEY_TS 7     // Unix 时间 (秒)，未校时不带
+
+struct TelemetrySample {
+  uint32_t ts;        // Unix 时间 (秒)，0 表示未校时
+  int32_t st;         // 系统总打印数
+  int32_t colCopies;  // 彩色复印数
+  int32_t bwCopies;   // 黑白复印数
+  int32_t colPrints;  // 彩色打印数
+  int32_t bwPrints;   // 黑白打印数
+  int8_t toner[4];    // 碳粉余量 (%)：黑、青、红、黄
+};
+
+// 当前 Unix 时间 (秒)，NTP 未校时返回 0
+uint32_t telemetryTimestamp();
+
+// 从打印机快照取值 (带时间戳)
+void telemetryFromPrinter(const PrinterSnapshot& p, TelemetrySample& s);
+
+// 编码为现有 JSON 格式，返回长度；缓冲不足返回 0
+size_t telemetryEncodeJson(const TelemetrySample& s, const char* mac, const char* serial, char* buf, size_t cap);
+
+// 编码为 CBOR，返回长度；缓冲不足返回 0
+size_t telemetryEncodeCbor(const TelemetrySample& s, uint8_t* buf, size_t cap);
+
+// 对比两种编码的字节数与耗时，结果打印到串口
+void telemetryBenchmark();
+
+#endif  // TELEMETRY_CODEC_H
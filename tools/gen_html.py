@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+gen_html.py - 把 web/ 下的页面资源压缩生成 html_content.h
+
+用法 (在仓库根目录)：python3 tools/gen_html.py
+修改 web/ 下任何文件后运行一次并提交生成的 html_content.h (Arduino IDE 没有预编译步骤)。
+
+每个文件：去掉行首缩进与空行，gzip -9 压缩 (mtime 固定为 0，同样的输入生成同样的字节)，
+以 PROGMEM 字节数组写入头文件；ETag 由固件中的 FIRMWARE_VERSION 与压缩内容的 CRC32 组成。
+"""
+
+import gzip
+import os
+import sys
+import zlib
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+WEB_DIR = os.path.join(ROOT, "web")
+OUT = os.path.join(ROOT, "html_content.h")
+
+# 扩展名 -> Content-Type
+MIME = {
+    ".html": "text/html; charset=utf-8",
+    ".css": "text/css",
+    ".js": "application/javascript",
+}
+
+
+def minify(text):
+    # 页面中没有 <pre> 与跨行字符串，行首缩进与空行可以安全去掉
+    lines = (line.strip() for line in text.splitlines())
+    return "\n".join(line for line in lines if line) + "\n"
+
+
+def symbol(name):
+    return "web_" + "".join(c if c.isalnum() else "_" for c in name)
+
+
+def byte_lines(data, per_line=16):
+    for i in range(0, len(data), per_line):
+        yield "  " + ", ".join("0x%02x" % b for b in data[i:i + per_line]) + ","
+
+
+def main():
+    names = sorted(n for n in os.listdir(WEB_DIR) if os.path.splitext(n)[1] in MIME)
+    if "index.html" not in names:
+        sys.exit("web/index.html not found")
+
+    out = [
+        "/*",
+        " * html_content.h - Web 配置页面资源 (由 tools/gen_html.py 从 web/ 生成，请勿手工修改)",
+        " *",
+        " * 各文件 gzip 压缩后存储在程序存储器 (PROGMEM) 中，以 Content-Encoding: gzip 原样发送",
+        " */",
+        "",
+        "#ifndef HTML_CONTENT_H",
+        "#define HTML_CONTENT_H",
+        "",
+        "#include <Arduino.h>",
+        '#include "config.h"',
+        "",
+        "struct WebAsset {",
+        "  const char* path;      // URL 路径",
+        "  const char* mime;      // Content-Type",
+        "  const uint8_t* data;   // gzip 内容 (PROGMEM)",
+        "  size_t len;            // gzip 字节数",
+        "  const char* etag;      // 强 ETag (含引号)",
+        "};",
+        "",
+    ]
+    table = []
+    total_raw = total_gz = 0
+    for name in names:
+        with open(os.path.join(WEB_DIR, name), encoding="utf-8") as f:
+            raw = minify(f.read()).encode("utf-8")
+        gz = gzip.compress(raw, compresslevel=9, mtime=0)
+        crc = zlib.crc32(gz) & 0xFFFFFFFF
+        sym = symbol(name)
+        out.append("// %s: %d 字节，压缩后 %d 字节" % (name, len(raw), len(gz)))
+        out.append("const uint8_t %s[] PROGMEM = {" % sym)
+        out.extend(byte_lines(gz))
+        out.append("};")
+        out.append("")
+        path = "/" if name == "index.html" else "/" + name
+        etag = '"\\"" FIRMWARE_VERSION "-%08x\\""' % crc
+        table.append('  { "%s", "%s", %s, sizeof(%s), %s },' % (path, MIME[os.path.splitext(name)[1]], sym, sym, etag))
+        total_raw += len(raw)
+        total_gz += len(gz)
+
+    out.append("const WebAsset webAssets[] = {")
+    out.extend(table)
+    out.append("};")
+    out.append("const size_t webAssetCount = sizeof(webAssets) / sizeof(webAssets[0]);")
+    out.append("")
+    out.append("#endif  // HTML_CONTENT_H")
+    out.append("")
+
+    with open(OUT, "w", encoding="utf-8", newline="\n") as f:
+        f.write("\n".join(out))
+    print("html_content.h: %d files, %d -> %d bytes" % (len(names), total_raw, total_gz))
+
+
+if __name__ == "__main__":
+    main()
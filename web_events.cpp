@@ -0,0 +1,153 @@
+/*
+ * web_events.cpp - Web 页面的状态推送实现
+ *
+ * 连接由 HTTP 服务器接收并解析请求，/events 处理函数接管其非阻塞套接字 (HttpResponse::detach)。
+ * 帧只生成一次、依次写给各订阅者；写不完整 (对端不再读取) 或对端已关闭的订阅者直接断开，
+ * 页面的 EventSource 会在 retry 时间后自动重连
+ */
+
+#include <lwip/sockets.h>
+#include "web_events.h"
+#include "config.h"
+#include "globals.h"
+#include "printer_snapshot.h"
+
+struct Subscriber {
+  int fd = -1;
+  bool active = false;
+  bool fresh = false;  // 刚订阅，下次检查时无论有无变化都推送一帧
+};
+
+static Subscriber subscribers[WEB_EVENTS_MAX];
+static uint8_t subscriberCount = 0;
+static WebEventsRender renderStatus = nullptr;
+static uint32_t lastKey = 0;
+static unsigned long lastCheck = 0;
+static unsigned long lastFrame = 0;
+static uint32_t frames = 0;
+
+static const char EVENTS_HEADER[] =
+  "HTTP/1.1 200 OK\r\n"
+  "Content-Type: text/event-stream\r\n"
+  "Cache-Control: no-cache\r\n"
+  "Connection: keep-alive\r\n"
+  "\r\n"
+  "retry: 5000\n\n";  // 断开后浏览器 5 秒重连
+
+static const char KEEPALIVE[] = ":\n\n";  // SSE 注释行：EventSource 忽略，只用于保持连接
+
+// FNV-1a，只用于判断变化
+static uint32_t hashBytes(uint32_t h, const void* data, size_t len) {
+  const uint8_t* p = (const uint8_t*)data;
+  while (len--) {
+    h ^= *p++;
+    h *= 16777619u;
+  }
+  return h;
+}
+
+// 页面显示内容的变化标记：只读快照版本号与轮询状态，不复制快照内容，也不生成 JSON
+static uint32_t changeKey() {
+  uint32_t h = 2166136261u;
+  for (int slot = 0; slot < printerCount; slot++) {
+    PrinterStatus st;
+    printerStatusRead(slot, st);
+    uint32_t version = printerSnapshotVersion(slot);
+    h = hashBytes(h, &version, sizeof(version));
+    h = hashBytes(h, &st.ip, sizeof(st.ip));
+    h = hashBytes(h, &st.online, sizeof(st.online));
+  }
+  char msg[64];
+  getStatusMessage(msg, sizeof(msg));
+  h = hashBytes(h, msg, strlen(msg));
+  bool mqtt = mqttClient.connected();
+  h = hashBytes(h, &mqtt, sizeof(mqtt));
+  return h;
+}
+
+static void drop(Subscriber& s) {
+  close(s.fd);
+  s.fd = -1;
+  s.active = false;
+  subscriberCount--;
+}
+
+// 整帧写入发送缓冲才算成功；写出一部分的流已无法继续，由调用者断开
+static bool writeAll(int fd, const char* data, size_t len) {
+  return send(fd, data, len, MSG_DONTWAIT) == (int)len;
+}
+
+// 对端已关闭或连接出错 (页面不会在推送流上发送数据)
+static bool peerClosed(int fd) {
+  char ch;
+  int n = recv(fd, &ch, 1, MSG_DONTWAIT | MSG_PEEK);
+  return n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
+void webEventsBegin(WebEventsRender render) {
+  renderStatus = render;
+}
+
+bool webEventsSubscribe(HttpResponse& res) {
+  for (Subscriber& s : subscribers) {
+    if (s.active) continue;
+    int fd = res.detach();
+    if (!writeAll(fd, EVENTS_HEADER, sizeof(EVENTS_HEADER) - 1)) {
+      close(fd);
+      return true;  // 连接已失效，不再回复
+    }
+    s.fd = fd;
+    s.active = true;
+    s.fresh = true;
+    subscriberCount++;
+    lastCheck = 0;  // 下次 loop 立即推送首帧
+    return true;
+  }
+  return false;
+}
+
+void webEventsLoop() {
+  if (subscriberCount == 0 || !renderStatus) return;
+  unsigned long now = millis();
+  if (lastCheck != 0 && now - lastCheck < WEB_EVENTS_CHECK_MS) return;
+  lastCheck = now;
+
+  uint32_t key = changeKey();
+  bool changed = key != lastKey;
+  bool keepalive = now - lastFrame >= WEB_EVENTS_KEEPALIVE;
+  bool anyFresh = false;
+  for (Subscriber& s : subscribers) anyFresh |= s.active && s.fresh;
+  if (!changed && !keepalive && !anyFresh) return;
+
+  // 只有内容变化或有新订阅者时才生成 JSON；无变化时新订阅者收到状态帧，其余订阅者在保活到期时只收到注释行
+  static char frame[STATUS_JSON_MAX + 8];  // 只在 loop 任务中使用
+  size_t len = 0;
+  if (changed || anyFresh) {
+    memcpy(frame, "data: ", 6);
+    len = 6 + renderStatus(frame + 6, sizeof(frame) - 8);
+    frame[len++] = '\n';
+    frame[len++] = '\n';
+  }
+
+  for (Subscriber& s : subscribers) {
+    if (!s.active) continue;
+    bool data = changed || s.fresh;
+    if (!data && !keepalive) continue;
+    if (peerClosed(s.fd) || (data ? !writeAll(s.fd, frame, len) : !writeAll(s.fd, KEEPALIVE, sizeof(KEEPALIVE) - 1))) {
+      drop(s);
+      continue;
+    }
+    s.fresh = false;
+    if (data) frames++;
+  }
+  lastKey = key;
+  if (changed || keepalive) lastFrame = now;
+}
+
+uint8_t webEventsSubscribers() {
+  return subscriberCount;
+}
+
+uint32_t webEventsFrames() {
+  return frames;
+}
@@ -0,0 +1,34 @@
+/*
+ * web_events.h - Web 页面的状态推送 (Server-Sent Events)
+ *
+ * 页面打开 /events 后连接保持不断开，loop 任务每 WEB_EVENTS_CHECK_MS 比较一次变化标记
+ * (各槽位快照版本、状态文字、MQTT 连接、打印机 IP 与在线状态)，有变化才生成一次状态 JSON，
+ * 以 "data: {...}\n\n" 写给所有订阅者；无变化时每 WEB_EVENTS_KEEPALIVE 只发一行 SSE 注释 ":" 保活，不生成 JSON。
+ * 没有订阅者时 webEventsLoop 立即返回，不生成 JSON。
+ * 订阅者上限 WEB_EVENTS_MAX，每个订阅者占用一个 lwIP 套接字，超过时 /events 返回 503，页面退回 /status 轮询。
+ * 写入不阻塞：发送缓冲放不下整帧的订阅者 (对端不再读取) 直接断开
+ */
+
+#ifndef WEB_EVENTS_H
+#define WEB_EVENTS_H
+
+#include <Arduino.h>
+#include "http_server.h"
+
+// 生成状态 JSON，返回长度 (与 /status 的响应体相同)
+typedef size_t (*WebEventsRender)(char* buf, size_t size);
+
+// 初始化 (initWebServer 中调用)
+void webEventsBegin(WebEventsRender render);
+
+// /events 处理函数中调用：接管连接并写出响应头，订阅者已满时返回 false (连接仍归 HTTP 服务器)
+bool webEventsSubscribe(HttpResponse& res);
+
+// loop 任务：检查变化并推送 (紧跟 httpServerLoop)
+void webEventsLoop();
+
+// 当前订阅者数与启动以来推送的帧数 (/metrics)
+uint8_t webEventsSubscribers();
+uint32_t webEventsFrames();
+
+#endif  // WEB_EVENTS_H